@@ -13,11 +13,22 @@ void ofApp::setup()
     ofSetFrameRate(30);
     ofEnableAlphaBlending();
 
-//    ofx::SensorEventArgs::List events = ofx::SensorEventUtils::load(ofx::SensorEventArgs::TYPE_ROTATION_VECTOR, "Rotation.txt");
-//
-//    ofx::PlayableBufferHandle<std::vector<ofx::SensorEventArgs> > handle(events);
+    // Rotation.txt holds one sample per line with a millisecond timestamp
+    // followed by the rotation vector components.
+    ofx::Player::TextSampleLoader::Settings settings;
+    settings.timestampScale = 1000;
 
+    if (ofx::Player::TextSampleLoader::load(ofToDataPath("Rotation.txt"), samples, settings, &stats))
+    {
+        ofLogNotice("ofApp::setup") << "Loaded " << stats.samples << " samples from " << stats.bytes << " bytes in " << stats.seconds << " s (" << stats.megabytesPerSecond() << " MB/s) using " << stats.threads << " threads.";
 
+        for (std::size_t i = 0; i < samples.channelCount(); ++i)
+        {
+            overviews.push_back(std::make_unique<ofx::Player::OverviewPyramid>(handle, [this, i](std::size_t index) {
+                return samples.value(index, i);
+            }));
+        }
+    }
 }
 
 
@@ -25,4 +36,66 @@ void ofApp::draw()
 {
     ofBackgroundGradient(ofColor::white, ofColor::black);
 
+    std::stringstream ss;
+
+    ss << "Samples: " << stats.samples << " (" << stats.skippedLines << " lines skipped)" << std::endl;
+    ss << "Channels: " << samples.channelCount() << std::endl;
+    ss << "Load: " << stats.seconds << " s, " << stats.megabytesPerSecond() << " MB/s, " << stats.threads << " threads" << std::endl;
+
+    if (!samples.empty())
+    {
+        // Loop through the samples in real time.
+        double first = handle.timeForIndex(0);
+        double duration = std::max(handle.timeForIndex(handle.size() - 1) - first, 1.0);
+        double time = first + std::fmod(ofGetElapsedTimeMicros(), duration);
+
+        lastIndex = handle.indexForTime(time, time >= lastTime, lastIndex);
+        lastTime = time;
+
+        auto sample = samples[lastIndex];
+
+        ss << "Index: " << lastIndex << std::endl;
+        ss << "Time: " << sample.timestamp() << std::endl;
+
+        for (std::size_t i = 0; i < sample.channelCount(); ++i)
+        {
+            ss << "  [" << i << "]: " << sample[i] << std::endl;
+
+            float width = ofMap(sample[i], -1, 1, -200, 200, true);
+            ofSetColor(ofColor::fromHsb(i * 60, 200, 255));
+            ofDrawRectangle(ofGetWidth() / 2, 200 + i * 30, width, 20);
+        }
+
+        // Draw the min / max overview of each channel with one bucket per
+        // pixel, regardless of the number of samples.
+        std::size_t bucketCount = ofGetWidth();
+        float trackHeight = 40;
+        float y = ofGetHeight() - overviews.size() * trackHeight;
+
+        for (std::size_t i = 0; i < overviews.size(); ++i)
+        {
+            auto buckets = overviews[i]->summaries(first, first + duration, bucketCount);
+
+            ofSetColor(ofColor::fromHsb(i * 60, 200, 255));
+
+            for (std::size_t x = 0; x < buckets.size(); ++x)
+            {
+                if (!buckets[x].empty())
+                {
+                    float top = ofMap(buckets[x].max, -1, 1, y + trackHeight, y, true);
+                    float bottom = ofMap(buckets[x].min, -1, 1, y + trackHeight, y, true);
+                    ofDrawLine(x, top, x, bottom);
+                }
+            }
+
+            y += trackHeight;
+        }
+
+        float playhead = ofMap(time, first, first + duration, 0, ofGetWidth());
+        ofSetColor(255);
+        ofDrawLine(playhead, ofGetHeight() - overviews.size() * trackHeight, playhead, ofGetHeight());
+    }
+
+    ofSetColor(255);
+    ofDrawBitmapStringHighlight(ss.str(), 14, 20);
 }
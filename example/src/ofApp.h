@@ -10,7 +10,6 @@
 
 #include "ofMain.h"
 #include "ofxPlayer.h"
-//#include "SensorEvents.h"
 
 
 class ofApp: public ofBaseApp
@@ -19,6 +18,23 @@ public:
     void setup() override;
     void draw() override;
 
-//    std::vector<ofx::SensorEventArgs> events;
+    /// \brief The loaded sensor samples.
+    ofx::Player::TimestampedSamples samples;
+
+    /// \brief A time-indexed handle to the samples.
+    ofx::Player::PlayableBufferHandle<ofx::Player::TimestampedSamples,
+                                      ofx::Player::TimestampedSamples::Adapter> handle{samples};
+
+    /// \brief The load statistics.
+    ofx::Player::TextSampleLoader::LoadStats stats;
+
+    /// \brief Overviews of each channel for drawing the timeline.
+    std::vector<std::unique_ptr<ofx::Player::OverviewPyramid>> overviews;
+
+    /// \brief The last sample index, used as a search hint.
+    std::size_t lastIndex = 0;
+
+    /// \brief The last sample time.
+    double lastTime = 0;
 
 };
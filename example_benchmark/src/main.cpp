@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofApp.h"
+#include "ofAppNoWindow.h"
+
+
+int main(int argc, char* argv[])
+{
+    // The benchmarks do not use OpenGL, so they can run without a display.
+    auto window = std::make_shared<ofAppNoWindow>();
+    ofSetupOpenGL(window, 0, 0, OF_WINDOW);
+
+    // An optional argument sets the results file.
+    std::string outputPath = argc > 1 ? argv[1] : "benchmark.json";
+
+    return ofRunApp(std::make_shared<ofApp>(outputPath));
+}
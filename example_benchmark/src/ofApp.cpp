@@ -0,0 +1,359 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofApp.h"
+
+
+namespace {
+
+
+typedef ofx::Player::PlayableBufferHandle<ofx::Player::TimestampedSamples,
+                                          ofx::Player::TimestampedSamples::Adapter> SampleHandle;
+
+
+typedef ofx::Player::StaticPlayableBuffer<ofx::Player::TimestampedSamples,
+                                          ofx::Player::TimestampedSamples::Adapter> StaticSampleHandle;
+
+
+/// \brief The fixed random seed for synthetic data.
+const uint32_t SEED = 1234;
+
+
+/// \brief Create jittered timestamps.
+/// \param count The number of timestamps.
+/// \param samples The samples to fill.
+void makeTimestamps(std::size_t count, ofx::Player::TimestampedSamples& samples)
+{
+    ofx::Player::SequenceGenerator::Settings settings;
+    settings.count = count;
+    settings.spacing = ofx::Player::SequenceGenerator::Spacing::JITTERED;
+    settings.seed = SEED;
+
+    samples.setChannelCount(0);
+    samples.reserve(count);
+
+    for (double timestamp: ofx::Player::SequenceGenerator::makeTimestamps(settings))
+    {
+        samples.push_back(timestamp, nullptr);
+    }
+}
+
+
+} // namespace
+
+
+ofApp::ofApp(const std::string& path): outputPath(path)
+{
+}
+
+
+void ofApp::setup()
+{
+    dataPath = ofToDataPath("synthetic", true);
+    ofDirectory::createDirectory(dataPath, false, true);
+
+    benchmarkIndexForTime();
+    benchmarkUpdate();
+    benchmarkTimestamper();
+    benchmarkJson();
+
+#if defined(OFX_PLAYER_ENABLE_TRACING)
+    // Open the trace with chrome://tracing or https://ui.perfetto.dev.
+    ofx::Player::Trace::setThreadName("main");
+    ofx::Player::Trace::setEnabled(true);
+
+    benchmarkPixels();
+
+    ofx::Player::Trace::setEnabled(false);
+    ofx::Player::Trace::save(ofFilePath::removeExt(outputPath) + "_trace.json");
+#else
+    benchmarkPixels();
+#endif
+
+    ofJson json = {
+        { "version", 1 },
+        { "date", ofGetTimestampString("%Y-%m-%dT%H:%M:%S") },
+        { "results", results }
+    };
+
+    ofSaveJson(outputPath, json);
+
+    std::cout << json.dump(4) << std::endl;
+
+    ofExit(0);
+}
+
+
+void ofApp::benchmarkIndexForTime()
+{
+    const std::size_t count = 1000000;
+    const std::size_t queryCount = 1000000;
+
+    ofx::Player::TimestampedSamples samples;
+    makeTimestamps(count, samples);
+
+    SampleHandle handle(samples);
+
+    // Queries step through the data at about two queries per frame.
+    double duration = handle.duration();
+    double step = duration / queryCount;
+    double startTime = handle.startTime();
+    double endTime = handle.endTime();
+
+    std::size_t hint = 0;
+
+    measure("indexForTime/forward/good_hint", queryCount, 5, [&](std::size_t i) {
+        hint = handle.indexForTime(startTime + i * step, true, hint);
+        return hint;
+    });
+
+    StaticSampleHandle staticHandle(samples);
+
+    hint = 0;
+
+    measure("indexForTime/forward/good_hint/static", queryCount, 5, [&](std::size_t i) {
+        hint = staticHandle.indexForTime(startTime + i * step, true, hint);
+        return hint;
+    });
+
+    // Pack the timestamps into unaligned records of an int64_t timestamp
+    // followed by three float fields, as they would appear in a binary log.
+    const std::size_t stride = sizeof(int64_t) + 3 * sizeof(float);
+    std::vector<uint8_t> records(1 + count * stride);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int64_t timestamp = static_cast<int64_t>(handle.timeForIndex(i));
+        std::memcpy(records.data() + 1 + i * stride, &timestamp, sizeof(timestamp));
+    }
+
+    ofx::Player::StridedRecordIndex<int64_t, stride, 0> recordIndex(records.data() + 1, count);
+
+    hint = 0;
+
+    measure("indexForTime/forward/good_hint/strided", queryCount, 5, [&](std::size_t i) {
+        hint = recordIndex.indexForTime(startTime + i * step, true, hint);
+        return hint;
+    });
+
+    measure("indexForTime/forward/bad_hint", queryCount, 5, [&](std::size_t i) {
+        return handle.indexForTime(startTime + i * step, true, (i * 7919) % count);
+    });
+
+    measure("indexForTime/forward/no_hint", queryCount, 5, [&](std::size_t i) {
+        return handle.indexForTime(startTime + i * step, true, 0);
+    });
+
+    hint = count - 1;
+
+    measure("indexForTime/reverse/good_hint", queryCount, 5, [&](std::size_t i) {
+        hint = handle.indexForTime(endTime - i * step, false, hint);
+        return hint;
+    });
+
+    measure("indexForTime/reverse/bad_hint", queryCount, 5, [&](std::size_t i) {
+        return handle.indexForTime(endTime - i * step, false, (i * 7919) % count);
+    });
+
+    measure("indexForTime/reverse/no_hint", queryCount, 5, [&](std::size_t i) {
+        return handle.indexForTime(endTime - i * step, false, 0);
+    });
+
+    std::vector<double> times(queryCount);
+    std::vector<std::size_t> indexes(queryCount);
+
+    for (std::size_t i = 0; i < queryCount; ++i)
+    {
+        times[i] = startTime + i * step;
+    }
+
+    measure("indexesForTimes/forward/batch_" + ofToString(queryCount), 1, 5, [&](std::size_t) {
+        handle.indexesForTimes(times.data(), times.size(), true, indexes.data());
+        return indexes.back();
+    });
+}
+
+
+void ofApp::benchmarkUpdate()
+{
+    const std::size_t count = 10000;
+    const std::size_t updateCount = 1000000;
+
+    // Updates use a fixed 60 fps step so results do not depend on the clock.
+    const double updateStep = 1000000.0 / 60.0;
+
+    ofx::Player::TimestampedSamples samples;
+    makeTimestamps(count, samples);
+
+    SampleHandle handle(samples);
+
+    const std::vector<std::pair<std::string, ofLoopType>> loopTypes = {
+        { "none", OF_LOOP_NONE },
+        { "normal", OF_LOOP_NORMAL },
+        { "palindrome", OF_LOOP_PALINDROME }
+    };
+
+    // The fast speed wraps a one second loop several times per update.
+    const std::vector<std::pair<std::string, double>> speeds = {
+        { "1x", 1 },
+        { "fast", 200 }
+    };
+
+    for (auto& loopType: loopTypes)
+    {
+        for (auto& speed: speeds)
+        {
+            TimeIndexedPlayer player(handle);
+            player.setLoopType(loopType.second);
+            player.setLoopStartTime(handle.startTime());
+            player.setLoopEndTime(handle.startTime() + 1000000);
+            player.setSpeed(speed.second);
+            player.play();
+
+            measure("update/" + loopType.first + "/" + speed.first, updateCount, 5, [&](std::size_t) {
+                player.update(updateStep);
+                return player.getFrameIndex();
+            });
+
+            measure("update+crossed/" + loopType.first + "/" + speed.first, updateCount, 5, [&](std::size_t) {
+                player.update(updateStep);
+                return player.getCrossedIndexRanges().size();
+            });
+
+            StaticSampleHandle staticHandle(samples);
+
+            ofx::Player::StaticPlayer<StaticSampleHandle> staticPlayer(staticHandle);
+            staticPlayer.setLoopType(loopType.second);
+            staticPlayer.setLoopStartTime(staticHandle.startTime());
+            staticPlayer.setLoopEndTime(staticHandle.startTime() + 1000000);
+            staticPlayer.setSpeed(speed.second);
+            staticPlayer.play();
+
+            measure("update+crossed/static/" + loopType.first + "/" + speed.first, updateCount, 5, [&](std::size_t) {
+                staticPlayer.update(updateStep);
+                return staticPlayer.getCrossedIndexRanges().size();
+            });
+
+            player.setStatsEnabled(true);
+
+            measure("update+stats/" + loopType.first + "/" + speed.first, updateCount, 5, [&](std::size_t) {
+                player.update(updateStep);
+                return player.getFrameIndex();
+            });
+        }
+    }
+}
+
+
+void ofApp::benchmarkTimestamper()
+{
+    ofx::Player::SequenceGenerator::Settings settings;
+    settings.count = 100000;
+    settings.seed = SEED;
+
+    std::vector<double> timestamps = ofx::Player::SequenceGenerator::makeTimestamps(settings);
+    std::vector<std::string> filenames;
+
+    for (std::size_t i = 0; i < timestamps.size(); ++i)
+    {
+        filenames.push_back(ofx::Player::SequenceGenerator::makeFilename(settings, i, timestamps[i]));
+    }
+
+    ofx::Player::FilenameTimestamper stamper;
+
+    measure("FilenameTimestamper/createTimestamp", filenames.size(), 5, [&](std::size_t i) {
+        double timestamp = 0;
+        stamper.createTimestamp(filenames[i], timestamp);
+        return static_cast<std::size_t>(timestamp);
+    });
+}
+
+
+void ofApp::benchmarkJson()
+{
+    for (std::size_t count: { 10000, 1000000 })
+    {
+        std::string directory = ofFilePath::join(dataPath, "json_" + ofToString(count));
+        std::string outputFilename = ofFilePath::join(dataPath, "json_" + ofToString(count) + "_out.json");
+
+        // Only the manifest is needed to measure loading and saving.
+        ofx::Player::SequenceGenerator::Settings settings;
+        settings.count = count;
+        settings.seed = SEED;
+        settings.writeImages = false;
+
+        ofx::Player::SequenceGenerator::generate(directory, settings);
+
+        std::string filename = ofx::Player::ImageSequenceRecorder::getManifestPath(directory);
+
+        std::size_t repeats = count > 10000 ? 3 : 5;
+
+        measure("fromJson/" + ofToString(count), 1, repeats, [&](std::size_t) {
+            ofx::Player::ImageSequence sequence;
+            ofx::Player::ImageSequence::fromJson(filename, sequence);
+            return sequence.size();
+        });
+
+        ofx::Player::ImageSequence sequence;
+        ofx::Player::ImageSequence::fromJson(filename, sequence);
+
+        measure("toJson/" + ofToString(count), 1, repeats, [&](std::size_t) {
+            return static_cast<std::size_t>(ofx::Player::ImageSequence::toJson(sequence, outputFilename));
+        });
+    }
+}
+
+
+void ofApp::benchmarkPixels()
+{
+    ofx::Player::SequenceGenerator::Settings settings;
+    settings.count = 64;
+    settings.extension = "png";
+    settings.seed = SEED;
+
+    std::string directory = ofFilePath::join(dataPath, "pixels");
+
+    ofx::Player::SequenceGenerator::generate(directory, settings);
+
+    ofx::Player::ImageSequence sequence(directory, ".*\\.png", true, ofx::Player::FilenameTimestamper());
+    sequence.setPixelCacheSize(settings.count);
+    sequence.setReadaheadSize(0);
+
+    // Warm the cache.
+    for (std::size_t i = 0; i < sequence.size(); ++i)
+    {
+        sequence.getPixels(i);
+    }
+
+    measure("getPixels/hit", 100000, 5, [&](std::size_t i) {
+        return sequence.getPixels(i % sequence.size()).size();
+    });
+
+    measure("getPixels/miss", sequence.size(), 3, [&](std::size_t i) {
+        sequence.clearPixelCache();
+        return sequence.getPixels(i).size();
+    });
+
+    // Split the miss cost into its read and decode parts in a separate pass,
+    // so the stats overhead is not part of the measured time.
+    auto& missResult = results.back();
+
+    sequence.setStatsEnabled(true);
+
+    for (std::size_t i = 0; i < sequence.size(); ++i)
+    {
+        sequence.clearPixelCache();
+        sink += sequence.getPixels(i).size();
+    }
+
+    ofx::Player::ImageSequenceStats stats = sequence.getStats();
+    sequence.setStatsEnabled(false);
+
+    missResult["read_p50_us"] = stats.readLatency.percentile(0.5);
+    missResult["decode_p50_us"] = stats.decodeLatency.percentile(0.5);
+    missResult["bytes_read"] = stats.bytesRead;
+}
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxPlayer.h"
+
+
+/// \brief A player for any time indexed data.
+class TimeIndexedPlayer: public ofx::Player::BasePlayer
+{
+public:
+    TimeIndexedPlayer(const ofx::Player::BaseTimeIndexed& data): _data(data)
+    {
+    }
+
+protected:
+    const ofx::Player::BaseTimeIndexed* indexedData() const override
+    {
+        return &_data;
+    }
+
+    const ofx::Player::BaseTimeIndexed& _data;
+
+};
+
+
+/// \brief Runs the playback benchmarks and writes the results as JSON.
+///
+/// Each benchmark is repeated several times and the minimum and median time
+/// per operation is recorded. All data is generated synthetically with a
+/// fixed random seed, so results are comparable between runs.
+class ofApp: public ofBaseApp
+{
+public:
+    /// \brief Create the benchmark app.
+    /// \param path The results file.
+    ofApp(const std::string& path);
+
+    void setup() override;
+
+    /// \brief Benchmark time searches with different hints and directions.
+    void benchmarkIndexForTime();
+
+    /// \brief Benchmark the player update for each loop type.
+    void benchmarkUpdate();
+
+    /// \brief Benchmark parsing timestamps from filenames.
+    void benchmarkTimestamper();
+
+    /// \brief Benchmark loading and saving JSON sequences.
+    void benchmarkJson();
+
+    /// \brief Benchmark cached and uncached pixel access.
+    void benchmarkPixels();
+
+    /// \brief Measure a function and record the result.
+    /// \param name The benchmark name.
+    /// \param iterations The number of operations per repeat.
+    /// \param repeats The number of repeats.
+    /// \param function The operation, called with the iteration index.
+    template<typename Function>
+    void measure(const std::string& name,
+                 std::size_t iterations,
+                 std::size_t repeats,
+                 Function function)
+    {
+        std::vector<double> nanosPerOperation;
+
+        for (std::size_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                sink += function(i);
+            }
+
+            auto end = std::chrono::steady_clock::now();
+
+            double nanos = std::chrono::duration<double, std::nano>(end - start).count();
+            nanosPerOperation.push_back(nanos / iterations);
+        }
+
+        std::sort(nanosPerOperation.begin(), nanosPerOperation.end());
+
+        double min = nanosPerOperation.front();
+        double median = nanosPerOperation[nanosPerOperation.size() / 2];
+
+        ofJson result = {
+            { "name", name },
+            { "iterations", iterations },
+            { "repeats", repeats },
+            { "min_ns_per_op", min },
+            { "median_ns_per_op", median },
+            { "ops_per_second", median > 0 ? 1e9 / median : 0 }
+        };
+
+        ofLogNotice("ofApp::measure") << name << ": " << median << " ns/op";
+
+        results.push_back(result);
+    }
+
+    /// \brief The synthetic data directory.
+    std::string dataPath;
+
+    /// \brief The results file.
+    std::string outputPath;
+
+    /// \brief The benchmark results.
+    ofJson results = ofJson::array();
+
+    /// \brief Accumulates results so the measured work is not optimized away.
+    std::size_t sink = 0;
+
+};
@@ -10,15 +10,53 @@
 
 void ofApp::setup()
 {
-    grabber.setup(1280, 720);
-
-
-
+    grabber.setup(640, 480);
 }
 
 void ofApp::update()
 {
+    grabber.update();
+
+    if (grabber.isFrameNew())
+    {
+        // Once the buffer is full, this copies into a previously allocated
+        // slot of the same size, so recording does not allocate.
+        Frame& frame = frames.beginWrite();
+        frame.pixels = grabber.getPixels();
+        frame.timestamp = ofGetElapsedTimeMicros();
+        frames.commitWrite();
+
+        // Drops frames rather than stalling capture if the disk falls behind.
+        recorder.add(frame.pixels);
+    }
+
+    handle.sync();
+
+    if (!player.isPlaying() && handle.size() > 0 && handle.duration() >= delay)
+    {
+        player.setTime(handle.endTime() - delay);
+        player.play();
+    }
+
+    player.update();
+
+    // Indexes shift as the buffer wraps, so compare sequence numbers.
+    if (player.isPlaying())
+    {
+        uint64_t sequence = handle.sequenceForIndex(player.getFrameIndex());
+
+        if (sequence != lastSequence)
+        {
+            texture.loadData(handle[player.getFrameIndex()].pixels);
 
+            // A producer on another thread may overwrite the frame while it is
+            // uploaded, so retry on the next update if it was.
+            if (handle.isValid(player.getFrameIndex()))
+            {
+                lastSequence = sequence;
+            }
+        }
+    }
 }
 
 
@@ -26,4 +64,48 @@ void ofApp::draw()
 {
     ofBackgroundGradient(ofColor::white, ofColor::black);
 
+    if (texture.isAllocated())
+    {
+        texture.draw(0, 0, ofGetWidth(), ofGetHeight());
+    }
+
+    grabber.draw(ofGetWidth() - 170, 10, 160, 120);
+
+    std::stringstream ss;
+    ss << "Delay: " << (delay / 1000000.0) << " s (UP/DOWN)" << std::endl;
+    ss << "Buffered: " << (handle.duration() / 1000000.0) << " s" << std::endl;
+    ss << "Recording: " << (recorder.isRecording() ? "on" : "off") << " (R)";
+
+    if (recorder.isRecording())
+    {
+        ss << " written: " << recorder.getWrittenCount();
+        ss << " dropped: " << recorder.getDroppedCount();
+    }
+
+    ofDrawBitmapStringHighlight(ss.str(), 14, 20);
+}
+
+
+void ofApp::keyPressed(int key)
+{
+    if (key == OF_KEY_UP || key == OF_KEY_DOWN)
+    {
+        delay = std::max(0.0, delay + (key == OF_KEY_UP ? 500000 : -500000));
+
+        if (player.isPlaying())
+        {
+            player.setTime(handle.endTime() - delay);
+        }
+    }
+    else if (key == 'r')
+    {
+        if (recorder.isRecording())
+        {
+            recorder.stop();
+        }
+        else
+        {
+            recorder.start(ofToDataPath("recording"));
+        }
+    }
 }
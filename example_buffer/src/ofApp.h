@@ -12,6 +12,48 @@
 #include "ofxPlayer.h"
 
 
+/// \brief A captured video frame.
+struct Frame
+{
+    /// \brief The frame pixels.
+    ofPixels pixels;
+
+    /// \brief The capture time in microseconds.
+    uint64_t timestamp = 0;
+};
+
+
+/// \brief Adapts a Frame for time indexing.
+class FrameAdapter
+{
+public:
+    static double timestamp(const Frame& frame)
+    {
+        return frame.timestamp;
+    }
+
+};
+
+
+/// \brief Plays any time indexed data.
+class FramePlayer: public ofx::Player::BasePlayer
+{
+public:
+    FramePlayer(const ofx::Player::BaseTimeIndexed& data): _data(data)
+    {
+    }
+
+protected:
+    const ofx::Player::BaseTimeIndexed* indexedData() const override
+    {
+        return &_data;
+    }
+
+    const ofx::Player::BaseTimeIndexed& _data;
+
+};
+
+
 class ofApp: public ofBaseApp
 {
 public:
@@ -19,6 +61,29 @@ public:
     void update() override;
     void draw() override;
 
+    void keyPressed(int key) override;
+
     ofVideoGrabber grabber;
 
+    /// \brief The recorded frames, about 10 seconds at 30 fps.
+    ofx::Player::RingBuffer<Frame> frames { 300 };
+
+    /// \brief A time indexed view of the recorded frames.
+    ofx::Player::RingBufferHandle<Frame, FrameAdapter> handle { frames };
+
+    /// \brief Plays the recorded frames.
+    FramePlayer player { handle };
+
+    /// \brief The time shift in microseconds.
+    double delay = 3000000;
+
+    /// \brief Records the live frames to disk.
+    ofx::Player::ImageSequenceRecorder recorder;
+
+    /// \brief The time shifted frame.
+    ofTexture texture;
+
+    /// \brief The sequence number of the time shifted frame.
+    uint64_t lastSequence = std::numeric_limits<uint64_t>::max();
+
 };
@@ -0,0 +1,22 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofApp.h"
+#include "ofAppNoWindow.h"
+
+
+int main(int argc, char* argv[])
+{
+    // The generator does not use OpenGL, so it can run without a display.
+    auto window = std::make_shared<ofAppNoWindow>();
+    ofSetupOpenGL(window, 0, 0, OF_WINDOW);
+
+    // Arguments are key=value pairs, e.g. count=1000 spacing=gappy.
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+
+    return ofRunApp(std::make_shared<ofApp>(arguments));
+}
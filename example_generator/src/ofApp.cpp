@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofApp.h"
+
+
+ofApp::ofApp(const std::vector<std::string>& args): arguments(args)
+{
+}
+
+
+void ofApp::setup()
+{
+    ofx::Player::SequenceGenerator::Settings settings;
+
+    std::string directory = ofToDataPath("sequence", true);
+
+    for (const auto& argument: arguments)
+    {
+        auto separator = argument.find('=');
+
+        if (separator == std::string::npos)
+        {
+            ofLogError("ofApp::setup") << "Expected key=value, got: " << argument;
+            continue;
+        }
+
+        std::string key = argument.substr(0, separator);
+        std::string value = argument.substr(separator + 1);
+
+        if (key == "directory")
+        {
+            directory = value;
+        }
+        else if (key == "count")
+        {
+            settings.count = ofFromString<std::size_t>(value);
+        }
+        else if (key == "width")
+        {
+            settings.width = ofFromString<std::size_t>(value);
+        }
+        else if (key == "height")
+        {
+            settings.height = ofFromString<std::size_t>(value);
+        }
+        else if (key == "extension")
+        {
+            settings.extension = value;
+        }
+        else if (key == "format")
+        {
+            settings.timestampFormat = (value == "numbered") ? "" : value;
+        }
+        else if (key == "spacing")
+        {
+            if (value == "uniform")
+            {
+                settings.spacing = ofx::Player::SequenceGenerator::Spacing::UNIFORM;
+            }
+            else if (value == "jittered")
+            {
+                settings.spacing = ofx::Player::SequenceGenerator::Spacing::JITTERED;
+            }
+            else if (value == "gappy")
+            {
+                settings.spacing = ofx::Player::SequenceGenerator::Spacing::GAPPY;
+            }
+            else
+            {
+                ofLogError("ofApp::setup") << "Unknown spacing: " << value;
+            }
+        }
+        else if (key == "fps")
+        {
+            settings.frameDuration = 1000000.0 / ofFromString<double>(value);
+        }
+        else if (key == "jitter")
+        {
+            settings.jitter = ofFromString<double>(value);
+        }
+        else if (key == "gap_probability")
+        {
+            settings.gapProbability = ofFromString<double>(value);
+        }
+        else if (key == "max_gap")
+        {
+            settings.maxGapFrames = ofFromString<std::size_t>(value);
+        }
+        else if (key == "seed")
+        {
+            settings.seed = ofFromString<uint32_t>(value);
+        }
+        else if (key == "images")
+        {
+            settings.writeImages = ofFromString<int>(value) != 0;
+        }
+        else if (key == "threads")
+        {
+            settings.threadCount = ofFromString<std::size_t>(value);
+        }
+        else
+        {
+            ofLogError("ofApp::setup") << "Unknown argument: " << key;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    bool success = ofx::Player::SequenceGenerator::generate(directory, settings);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ofLogNotice("ofApp::setup") << (success ? "Generated " : "Failed to generate ") << settings.count << " images in " << directory << " in " << seconds << " s.";
+    ofLogNotice("ofApp::setup") << "Manifest: " << ofx::Player::ImageSequenceRecorder::getManifestPath(directory);
+
+    ofExit(success ? 0 : 1);
+}
@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2014 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxPlayer.h"
+
+
+/// \brief Generates a synthetic image sequence from command line arguments.
+///
+/// Arguments are given as key=value pairs:
+///
+///     directory        The output directory (default: data/sequence).
+///     count            The number of images.
+///     width, height    The image size in pixels.
+///     extension        The image format, e.g. jpg or png.
+///     format           The Poco timestamp format for filenames, or
+///                      "numbered" for zero padded frame numbers.
+///     spacing          uniform, jittered or gappy.
+///     fps              The nominal frame rate.
+///     jitter           The jitter as a fraction of a frame.
+///     gap_probability  The probability of a gap after each frame.
+///     max_gap          The maximum number of frames in a gap.
+///     seed             The random seed.
+///     images           0 to write only the manifest.
+///     threads          The number of encoding threads, or 0 for all cores.
+class ofApp: public ofBaseApp
+{
+public:
+    /// \brief Create the generator app.
+    /// \param arguments The command line arguments.
+    ofApp(const std::vector<std::string>& arguments);
+
+    void setup() override;
+
+    /// \brief The command line arguments.
+    std::vector<std::string> arguments;
+
+};
@@ -8,6 +8,8 @@
 #pragma once
 
 
+#include <cmath>
+#include <cstdint>
 #include "ofBaseTypes.h"
 
 
@@ -27,6 +29,19 @@ public:
     /// \brief Get the timestamp in microseconds of the data.
     virtual double timestamp() const = 0;
 
+    /// \brief Get the timestamp in integer microseconds of the data.
+    ///
+    /// Epoch timestamps exceed the range in which a double can represent
+    /// every microsecond exactly after arithmetic, so types that store
+    /// integer timestamps should override this to return them exactly. By
+    /// default the double timestamp is rounded.
+    ///
+    /// \returns the timestamp in integer microseconds.
+    virtual int64_t timestampMicros() const
+    {
+        return static_cast<int64_t>(std::llround(timestamp()));
+    }
+
 };
 
 
@@ -104,6 +119,24 @@ public:
                                      bool increasing,
                                      std::size_t indexHint) const = 0;
 
+    /// \brief Get data for many times in microseconds.
+    ///
+    /// This is equivalent to calling indexForTime() for each time, but the
+    /// times are resolved in a single sweep, with each search starting at the
+    /// previous result. For times sorted in increasing order, this costs
+    /// O(count + size()) in total rather than O(count * log(size())).
+    ///
+    /// Unsorted times return the same results, but more slowly.
+    ///
+    /// \param times The times to query in microseconds.
+    /// \param count The number of times to query.
+    /// \param increasing True if the time is increasing.
+    /// \param indexes The output indexes, with space for at least count values.
+    virtual void indexesForTimes(const double* times,
+                                 std::size_t count,
+                                 bool increasing,
+                                 std::size_t* indexes) const = 0;
+
     /// \brief Get the timestamp at the given index in microseconds.
     /// \param index The frame index to query.
     /// \returns the timestamp at the index in microseconds.
@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include "ofFileUtils.h"
+
+
+#if defined(OFX_PLAYER_USE_IO_URING)
+#include <liburing.h>
+#endif
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Fetch raw file bytes on a background thread ahead of decoding.
+///
+/// The reader separates the raw byte fetch from the decode step. Callers
+/// request files by key (usually a frame index) before they are needed. A
+/// worker thread reads the requested files into memory so that the caller can
+/// later decode the bytes without blocking on disk or network latency.
+///
+/// When the worker takes a batch, it advises the operating system that the
+/// batch and the requests queued after it will be needed soon (e.g.
+/// `posix_fadvise(POSIX_FADV_WILLNEED)`), which lets the kernel begin
+/// readahead before the worker reaches them. Opening a file may block (e.g.
+/// on a network file system), so the calling thread never opens files.
+///
+/// If compiled with `OFX_PLAYER_USE_IO_URING` on Linux (and linked with
+/// liburing), queued requests are read in batches with a single io_uring
+/// submission instead of one blocking read per file.
+class AsyncFileReader
+{
+public:
+    /// \brief Create an AsyncFileReader.
+    /// \param capacity The maximum number of fetched, but not yet taken,
+    ///        buffers to hold in memory.
+    /// \param batchSize The maximum number of files to read per batch.
+    AsyncFileReader(std::size_t capacity = DEFAULT_CAPACITY,
+                    std::size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator = (const AsyncFileReader&) = delete;
+
+    /// \brief Destroy the AsyncFileReader.
+    ///
+    /// Pending requests are discarded and the worker thread is joined.
+    ~AsyncFileReader();
+
+    /// \brief Request that a file be fetched in the background.
+    ///
+    /// Requests for keys that are already queued or fetched are ignored. If
+    /// the queue is full, the oldest queued request is discarded, since it is
+    /// the least likely to be needed by a moving playhead.
+    ///
+    /// \param key The key used to retrieve the bytes with take().
+    /// \param path The path of the file to fetch.
+    void request(std::size_t key, const std::string& path);
+
+    /// \brief Take the fetched bytes for the given key.
+    ///
+    /// This call never blocks on I/O. Once taken, the bytes are no longer
+    /// held by the reader.
+    ///
+    /// \param key The key used when the file was requested.
+    /// \returns the fetched bytes or nullptr if they are not available yet.
+    std::shared_ptr<ofBuffer> take(std::size_t key);
+
+    /// \brief Discard all queued requests that have not been started.
+    void cancel();
+
+    /// \brief Discard all queued requests and all fetched buffers.
+    ///
+    /// Files that are being read when this is called are discarded when the
+    /// read completes.
+    void clear();
+
+    /// \brief Move the keys at or after \p first by \p offset.
+    ///
+    /// This keeps queued requests and fetched buffers valid when the keys are
+    /// frame indices and frames are inserted before them. Files that are
+    /// being read when this is called are discarded when the read completes.
+    ///
+    /// \param first The first key to move.
+    /// \param offset The number of keys to move by.
+    void shift(std::size_t first, std::size_t offset);
+
+    /// \returns the maximum number of fetched buffers held in memory.
+    std::size_t capacity() const;
+
+    /// \brief Advise the operating system that a file will be read soon.
+    ///
+    /// This is a no-op on platforms without an advisory read API.
+    ///
+    /// \param path The path of the file that will be read.
+    /// \returns true if the advice was issued.
+    static bool advise(const std::string& path);
+
+    /// \brief Read the entire contents of a file.
+    /// \param path The path of the file to read.
+    /// \param buffer The buffer to fill.
+    /// \returns true if the file was read successfully.
+    static bool read(const std::string& path, ofBuffer& buffer);
+
+    enum
+    {
+        /// \brief The default number of fetched buffers to hold.
+        DEFAULT_CAPACITY = 32,
+        /// \brief The default number of files to read per batch.
+        DEFAULT_BATCH_SIZE = 8
+    };
+
+private:
+    /// \brief A queued read request.
+    struct Request
+    {
+        /// \brief The key for the fetched bytes.
+        std::size_t key;
+
+        /// \brief The path of the file to read.
+        std::string path;
+
+        /// \brief True if the operating system was advised of the read.
+        bool isAdvised = false;
+
+        /// \brief The key generation when the request was made.
+        uint64_t generation = 0;
+    };
+
+    /// \brief The worker thread loop.
+    void run();
+
+    /// \brief Read a batch of requests.
+    /// \param batch The requests to read.
+    /// \param buffers The buffers to fill, one for each request. Failed reads
+    ///        are left as nullptr.
+    void readBatch(const std::vector<Request>& batch,
+                   std::vector<std::shared_ptr<ofBuffer>>& buffers);
+
+    /// \brief The maximum number of fetched buffers to hold.
+    std::size_t _capacity = DEFAULT_CAPACITY;
+
+    /// \brief The maximum number of files to read per batch.
+    std::size_t _batchSize = DEFAULT_BATCH_SIZE;
+
+    /// \brief The queued requests.
+    std::deque<Request> _requests;
+
+    /// \brief The keys that are queued or currently being read.
+    std::unordered_set<std::size_t> _pending;
+
+    /// \brief The fetched buffers, by key.
+    std::unordered_map<std::size_t, std::shared_ptr<ofBuffer>> _buffers;
+
+    /// \brief The fetched keys in insertion order, used for eviction.
+    std::deque<std::size_t> _bufferOrder;
+
+    /// \brief The key generation, incremented when keys are cleared or moved.
+    ///
+    /// Reads that complete with an older generation have stale keys and are
+    /// discarded.
+    uint64_t _generation = 0;
+
+    /// \brief True while the worker thread should keep running.
+    bool _running = true;
+
+    /// \brief The mutex protecting the queue and buffers.
+    mutable std::mutex _mutex;
+
+    /// \brief Signals the worker thread when requests are available.
+    std::condition_variable _condition;
+
+#if defined(OFX_PLAYER_USE_IO_URING)
+    /// \brief The io_uring instance used for batched reads.
+    io_uring _ring;
+
+    /// \brief True if the io_uring instance was initialized.
+    bool _ringInitialized = false;
+
+    /// \brief True if the ring failed and blocking reads are used instead.
+    bool _isRingFailed = false;
+#endif
+
+    /// \brief The worker thread.
+    std::thread _thread;
+
+};
+
+
+} } // namespace ofx::Player
@@ -8,7 +8,12 @@
 #pragma once
 
 
+#include <array>
+#include "ofEvents.h"
 #include "ofx/Player/AbstractPlayerTypes.h"
+#include "ofx/Player/PlayerStats.h"
+#include "ofx/Player/PlayerUtils.h"
+#include "ofx/Player/TimeRemapCurve.h"
 
 
 namespace ofx {
@@ -38,8 +43,103 @@ public:
                              bool increasing,
                              std::size_t indexHint) const override;
 
+    void indexesForTimes(const double* times,
+                         std::size_t count,
+                         bool increasing,
+                         std::size_t* indexes) const override;
+
     double positionForTime(double time, bool clamp) const override;
 
+    /// \brief Get the contiguous timestamp column, if available.
+    ///
+    /// Subclasses that store their timestamps in a contiguous array should
+    /// return a pointer to it. Batch searches then scan the column directly,
+    /// which avoids a virtual call per timestamp and allows vectorization.
+    ///
+    /// \returns a pointer to size() timestamps, or nullptr if not contiguous.
+    virtual const double* timestampData() const;
+
+    /// \brief Find the first index with a timestamp > time.
+    ///
+    /// The search gallops outward from the hint, so it is fastest when the
+    /// hint is close to the result.
+    ///
+    /// \param time The time to search for in microseconds.
+    /// \param indexHint The index to start the search from.
+    /// \returns the first index with a timestamp > time, or size().
+    std::size_t upperBound(double time, std::size_t indexHint = 0) const;
+
+    /// \brief Find the first index with a timestamp >= time.
+    ///
+    /// The search gallops outward from the hint, so it is fastest when the
+    /// hint is close to the result.
+    ///
+    /// \param time The time to search for in microseconds.
+    /// \param indexHint The index to start the search from.
+    /// \returns the first index with a timestamp >= time, or size().
+    std::size_t lowerBound(double time, std::size_t indexHint = 0) const;
+
+    /// \brief Get the timestamp at the given index in integer microseconds.
+    ///
+    /// Subclasses that store integer timestamps should override this to
+    /// return them exactly. By default the double timestamp is rounded.
+    ///
+    /// \param index The frame index to query.
+    /// \returns the timestamp at the index in integer microseconds.
+    virtual int64_t timeForIndexMicros(std::size_t index) const;
+
+    /// \brief Get the contiguous integer timestamp column, if available.
+    ///
+    /// Subclasses that store their integer timestamps in a contiguous array
+    /// should return a pointer to it. Searches then compare integers in the
+    /// column directly. The double searches also use the column when no
+    /// double column is available.
+    ///
+    /// \returns a pointer to size() timestamps, or nullptr if not contiguous.
+    virtual const int64_t* timestampMicrosData() const;
+
+    /// \returns the first timestamp in integer microseconds or -1 if empty.
+    int64_t startTimeMicros() const;
+
+    /// \returns the last timestamp in integer microseconds or -1 if empty.
+    int64_t endTimeMicros() const;
+
+    /// \brief Get data for the given time in integer microseconds.
+    ///
+    /// This follows the rules of indexForTime(), but compares integer
+    /// timestamps exactly.
+    ///
+    /// \param time The time to query in integer microseconds.
+    /// \param increasing True if the time is increasing.
+    /// \param indexHint An hint that may make it easier to find the index.
+    /// \returns The index corresponding to to the given time.
+    virtual std::size_t indexForTimeMicros(int64_t time,
+                                           bool increasing,
+                                           std::size_t indexHint) const;
+
+    /// \brief Get data for many times in integer microseconds.
+    /// \param times The times to query in integer microseconds.
+    /// \param count The number of times to query.
+    /// \param increasing True if the time is increasing.
+    /// \param indexes The output indexes, with space for at least count values.
+    /// \sa indexesForTimes()
+    void indexesForTimesMicros(const int64_t* times,
+                               std::size_t count,
+                               bool increasing,
+                               std::size_t* indexes) const;
+
+    /// \brief Find the first index with a timestamp > time.
+    /// \param time The time to search for in integer microseconds.
+    /// \param indexHint The index to start the search from.
+    /// \returns the first index with a timestamp > time, or size().
+    std::size_t upperBoundMicros(int64_t time, std::size_t indexHint = 0) const;
+
+    /// \brief Find the first index with a timestamp >= time.
+    /// \param time The time to search for in integer microseconds.
+    /// \param indexHint The index to start the search from.
+    /// \returns the first index with a timestamp >= time, or size().
+    std::size_t lowerBoundMicros(int64_t time, std::size_t indexHint = 0) const;
+
 };
 
 //
@@ -116,6 +216,13 @@ public:
     }
 
 
+    /// \returns a reference to the buffer.
+    const BufferType& buffer() const
+    {
+        return _buffer;
+    }
+
+
 private:
     /// \brief A reference to the buffer.
     BufferType& _buffer;
@@ -124,13 +231,558 @@ private:
 
 
 
+/// \brief A contiguous range of indices.
+class IndexRange
+{
+public:
+    /// \brief Create an empty IndexRange.
+    IndexRange()
+    {
+    }
+
+    /// \brief Create an IndexRange.
+    /// \param begin The first index in the range.
+    /// \param end One past the last index in the range.
+    /// \param increasing True if the range was traversed in increasing order.
+    /// \param repeat The number of times the range was traversed.
+    IndexRange(std::size_t begin,
+               std::size_t end,
+               bool increasing,
+               std::size_t repeat = 1):
+        _begin(begin),
+        _end(end),
+        _increasing(increasing),
+        _repeat(repeat)
+    {
+    }
+
+    /// \returns the first index in the range.
+    std::size_t begin() const
+    {
+        return _begin;
+    }
+
+    /// \returns one past the last index in the range.
+    std::size_t end() const
+    {
+        return _end;
+    }
+
+    /// \returns true if the range was traversed in increasing index order.
+    bool isIncreasing() const
+    {
+        return _increasing;
+    }
+
+    /// \returns the number of times the range was traversed.
+    std::size_t repeat() const
+    {
+        return _repeat;
+    }
+
+    /// \returns the number of indices in the range.
+    std::size_t size() const
+    {
+        return _end - _begin;
+    }
+
+    /// \returns true if the range contains no indices.
+    bool empty() const
+    {
+        return _end == _begin;
+    }
+
+private:
+    /// \brief The first index in the range.
+    std::size_t _begin = 0;
+
+    /// \brief One past the last index in the range.
+    std::size_t _end = 0;
+
+    /// \brief True if the range was traversed in increasing order.
+    bool _increasing = true;
+
+    /// \brief The number of times the range was traversed.
+    std::size_t _repeat = 1;
+
+};
+
+
+/// \brief A fixed capacity, ordered list of index ranges.
+///
+/// A single player update crosses at most three ranges: the range up to a loop
+/// boundary, any number of complete passes through the loop (collapsed into a
+/// single range with a repeat count) and the range after the last boundary.
+class IndexRanges
+{
+public:
+    /// \returns the number of ranges.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /// \returns true if there are no ranges.
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /// \param index The range index.
+    /// \returns the range at the given index.
+    const IndexRange& operator [] (std::size_t index) const
+    {
+        return _ranges[index];
+    }
+
+    /// \returns a pointer to the first range.
+    const IndexRange* begin() const
+    {
+        return _ranges.data();
+    }
+
+    /// \returns a pointer past the last range.
+    const IndexRange* end() const
+    {
+        return _ranges.data() + _size;
+    }
+
+    /// \returns the total number of indices, including repeats.
+    std::size_t count() const
+    {
+        std::size_t result = 0;
+
+        for (auto& range: *this)
+        {
+            result += range.size() * range.repeat();
+        }
+
+        return result;
+    }
+
+    /// \brief Add a range if there is capacity.
+    /// \param range The range to add.
+    void add(const IndexRange& range)
+    {
+        if (_size < MAX_RANGES)
+        {
+            _ranges[_size++] = range;
+        }
+    }
+
+    /// \brief Remove all ranges.
+    void clear()
+    {
+        _size = 0;
+    }
+
+    enum
+    {
+        /// \brief The maximum number of ranges.
+        MAX_RANGES = 3
+    };
+
+private:
+    /// \brief The ranges.
+    std::array<IndexRange, MAX_RANGES> _ranges;
+
+    /// \brief The number of ranges.
+    std::size_t _size = 0;
+
+};
+
+
+/// \brief A span of media time traversed during an update.
+///
+/// Span times are relative to the TimeSpans origin, so they remain precise
+/// for epoch timestamps.
+struct TimeSpan
+{
+    /// \brief The start time of the span in microseconds from the origin.
+    double from = 0;
+
+    /// \brief The end time of the span in microseconds from the origin.
+    double to = 0;
+
+    /// \brief True if a timestamp equal to the start time was crossed.
+    bool includesFrom = false;
+
+    /// \brief The number of times the span was traversed.
+    std::size_t repeat = 1;
+};
+
+
+/// \brief The media time spans traversed by a playhead during an update.
+///
+/// advance() applies a loop type to a playback time and records each span of
+/// media time it traverses. The spans can then be mapped onto any sorted time
+/// index. This is shared by BasePlayer and StaticPlayer, so both follow the
+/// same loop rules.
+///
+/// Times are doubles relative to an integer microsecond origin. Players use
+/// the loop start as the origin, so the double times stay small and the
+/// accumulated playhead keeps sub-microsecond precision for epoch
+/// timestamps. Crossed spans are mapped to integer timestamps exactly.
+class TimeSpans
+{
+public:
+    /// \brief Advance a playback time, applying the loop type.
+    ///
+    /// Any previously recorded spans are kept, so clear() should be called
+    /// before each update.
+    ///
+    /// \param time The playback time in microseconds from the origin.
+    /// \param playingForward The playing direction, which palindrome loops
+    ///        reverse at each reflection.
+    /// \param loopType The loop type.
+    /// \param elapsedTime The elapsed media time in microseconds.
+    /// \param loopStartTime The loop start time in microseconds from the origin.
+    /// \param loopEndTime The loop end time in microseconds from the origin.
+    /// \param includeStart True if the current time has not been crossed yet.
+    /// \returns true if the playback time is increasing after advancing.
+    bool advance(double& time,
+                 bool& playingForward,
+                 ofLoopType loopType,
+                 double elapsedTime,
+                 double loopStartTime,
+                 double loopEndTime,
+                 bool includeStart);
+
+    /// \brief Get the index ranges of a time index crossed by the spans.
+    ///
+    /// The IndexedType must have size(), lowerBoundMicros(time, indexHint) and
+    /// upperBoundMicros(time, indexHint) functions, e.g. BaseTimeIndexed or
+    /// StaticTimeIndexed. The ranges follow the rules described by
+    /// BasePlayer::getCrossedIndexRanges().
+    ///
+    /// \param indexed The time index.
+    /// \param ranges The crossed index ranges.
+    /// \param indexHint The index to start the searches from.
+    template<typename IndexedType>
+    void crossedIndexRanges(const IndexedType& indexed,
+                            IndexRanges& ranges,
+                            std::size_t indexHint) const
+    {
+        ranges.clear();
+
+        if (indexHint >= indexed.size())
+        {
+            indexHint = 0;
+        }
+
+        for (std::size_t i = 0; i < _size; ++i)
+        {
+            const TimeSpan& span = _spans[i];
+
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            bool increasing = span.to >= span.from;
+
+            // Integer timestamps t satisfy t > x iff t > floor(x) and
+            // t >= x iff t >= ceil(x), so the searches are exact.
+            int64_t fromFloor = _origin + TimeUtils::floorMicros(span.from);
+            int64_t fromCeil = _origin + TimeUtils::ceilMicros(span.from);
+
+            if (increasing)
+            {
+                begin = span.includesFrom ? indexed.lowerBoundMicros(fromCeil, indexHint)
+                                          : indexed.upperBoundMicros(fromFloor, indexHint);
+                end = indexed.upperBoundMicros(_origin + TimeUtils::floorMicros(span.to), begin);
+            }
+            else
+            {
+                begin = indexed.lowerBoundMicros(_origin + TimeUtils::ceilMicros(span.to), indexHint);
+                end = span.includesFrom ? indexed.upperBoundMicros(fromFloor, begin)
+                                        : indexed.lowerBoundMicros(fromCeil, begin);
+            }
+
+            // Repeated ranges are kept even if empty, since a reflected pass
+            // may include an edge index that the range excludes.
+            if (end > begin || span.repeat > 1)
+            {
+                ranges.add(IndexRange(begin, end, increasing, span.repeat));
+            }
+
+            indexHint = increasing ? end : begin;
+        }
+    }
+
+    /// \returns the number of spans.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /// \param index The span index.
+    /// \returns the span at the given index.
+    const TimeSpan& operator [] (std::size_t index) const
+    {
+        return _spans[index];
+    }
+
+    /// \brief Remove all spans.
+    void clear()
+    {
+        _size = 0;
+    }
+
+    /// \brief Set the origin of the span times.
+    /// \param origin The origin in integer microseconds.
+    void setOrigin(int64_t origin)
+    {
+        _origin = origin;
+    }
+
+    /// \returns the origin of the span times in integer microseconds.
+    int64_t origin() const
+    {
+        return _origin;
+    }
+
+private:
+    /// \brief Record a traversed media time span.
+    /// \param from The start time of the span in microseconds from the origin.
+    /// \param to The end time of the span in microseconds from the origin.
+    /// \param includesFrom True if a timestamp equal to the start was crossed.
+    /// \param repeat The number of times the span was traversed.
+    void add(double from, double to, bool includesFrom, std::size_t repeat);
+
+    /// \brief The spans.
+    std::array<TimeSpan, IndexRanges::MAX_RANGES> _spans;
+
+    /// \brief The number of spans.
+    std::size_t _size = 0;
+
+    /// \brief The origin of the span times in integer microseconds.
+    int64_t _origin = 0;
+
+};
+
+
+/// \brief The playhead state and rules shared by BasePlayer and StaticPlayer.
+///
+/// This holds the playback time, direction, loop points and frame index, and
+/// implements clamping, advancing within the loop points and the frame search,
+/// so both players follow the same rules. The data is passed to each call
+/// rather than stored.
+///
+/// \tparam IndexedType The time index type. It must have size(),
+///         startTime(), endTime(), startTimeMicros(), endTimeMicros() and
+///         indexForTimeMicros() functions, e.g. BaseTimeIndexed or
+///         StaticTimeIndexed.
+template<typename IndexedType>
+struct Playhead
+{
+    /// \brief The integer part of the playback time in microseconds.
+    ///
+    /// This is -1 until the time is set or playback starts.
+    int64_t timeMicros = -1;
+
+    /// \brief The fractional part of the playback time in microseconds.
+    ///
+    /// This is always in [0, 1).
+    double timeFraction = 0;
+
+    /// \brief The playing direction, reversed by palindrome reflections.
+    bool playingForward = true;
+
+    /// \brief The playback loop type.
+    ofLoopType loopType = OF_LOOP_NONE;
+
+    /// \brief The loop start time in integer microseconds or -1 if not set.
+    int64_t loopStartTimeMicros = -1;
+
+    /// \brief The loop end time in integer microseconds or -1 if not set.
+    int64_t loopEndTimeMicros = -1;
+
+    /// \brief The current frame index.
+    std::size_t frameIndex = 0;
+
+    /// \brief The frame index of the previous update.
+    std::size_t lastFrameIndex = 0;
+
+    /// \brief True if the frame index changed during the last update.
+    bool isFrameIndexNew = true;
+
+    /// \returns the playback time in microseconds.
+    double time() const
+    {
+        return static_cast<double>(timeMicros) + timeFraction;
+    }
+
+    /// \brief Prepare the first update.
+    ///
+    /// An unset time starts at the beginning of the data, and the first
+    /// frame found is always new.
+    ///
+    /// \param data The time index.
+    void start(const IndexedType& data)
+    {
+        if (timeMicros < 0)
+        {
+            timeMicros = data.startTimeMicros();
+            timeFraction = 0;
+        }
+
+        lastFrameIndex = std::numeric_limits<std::size_t>::max();
+    }
+
+    /// \brief Advance the time within the loop points.
+    /// \param data The time index.
+    /// \param spans The spans to record the traversed media time in.
+    /// \param elapsedTime The signed media time to advance in microseconds.
+    /// \param includeStart True if the current time has not been crossed yet.
+    /// \returns true if the playback time is increasing after advancing.
+    bool advance(const IndexedType& data,
+                 TimeSpans& spans,
+                 double elapsedTime,
+                 bool includeStart)
+    {
+        int64_t loopStartTime = loopStartTimeMicros < 0 ? data.startTimeMicros() : loopStartTimeMicros;
+        int64_t loopEndTime = loopEndTimeMicros < 0 ? data.endTimeMicros() : loopEndTimeMicros;
+
+        // Advance relative to the loop start, so the double playhead stays
+        // small enough to keep sub-microsecond precision for epoch timestamps.
+        double relativeTime = static_cast<double>(timeMicros - loopStartTime) + timeFraction;
+
+        spans.setOrigin(loopStartTime);
+
+        bool increasing = spans.advance(relativeTime,
+                                        playingForward,
+                                        loopType,
+                                        elapsedTime,
+                                        0,
+                                        static_cast<double>(loopEndTime - loopStartTime),
+                                        includeStart);
+
+        double whole = std::floor(relativeTime);
+        timeMicros = loopStartTime + static_cast<int64_t>(whole);
+        timeFraction = relativeTime - whole;
+
+        return increasing;
+    }
+
+    /// \brief Find the frame at the playback time.
+    ///
+    /// Integer timestamps <= time are <= the integer part, and integer
+    /// timestamps >= time are >= the integer part rounded up.
+    ///
+    /// \param data The time index.
+    /// \param increasing True if the playback time is increasing.
+    /// \param indexHint The index to start the search from.
+    /// \returns the frame index at the playback time.
+    std::size_t search(const IndexedType& data,
+                       bool increasing,
+                       std::size_t indexHint) const
+    {
+        int64_t searchTime = (increasing || timeFraction == 0) ? timeMicros : timeMicros + 1;
+        return data.indexForTimeMicros(searchTime, increasing, indexHint);
+    }
+
+    /// \brief Update the frame index after advancing.
+    /// \param data The time index.
+    /// \param increasing True if the playback time is increasing.
+    void updateFrameIndex(const IndexedType& data, bool increasing)
+    {
+        std::size_t indexHint = lastFrameIndex < data.size() ? lastFrameIndex : 0;
+
+        frameIndex = search(data, increasing, indexHint);
+        isFrameIndexNew = (lastFrameIndex != frameIndex);
+        lastFrameIndex = frameIndex;
+    }
+
+    /// \param data The time index.
+    /// \param time The playback time in microseconds, clamped to the data.
+    void setTime(const IndexedType& data, double time)
+    {
+        time = std::max(data.startTime(), std::min(time, data.endTime()));
+
+        double whole = std::floor(time);
+        timeMicros = static_cast<int64_t>(whole);
+        timeFraction = time - whole;
+    }
+
+    /// \param data The time index.
+    /// \param time The playback time in integer microseconds, clamped to the data.
+    void setTimeMicros(const IndexedType& data, int64_t time)
+    {
+        timeMicros = std::max(data.startTimeMicros(), std::min(time, data.endTimeMicros()));
+        timeFraction = 0;
+    }
+
+    /// \param data The time index.
+    /// \param time The loop start time in integer microseconds.
+    void setLoopStartTimeMicros(const IndexedType& data, int64_t time)
+    {
+        loopStartTimeMicros = std::max(data.startTimeMicros(), std::min(time, data.endTimeMicros()));
+        orderLoopPoints();
+    }
+
+    /// \param data The time index.
+    /// \param time The loop end time in integer microseconds.
+    void setLoopEndTimeMicros(const IndexedType& data, int64_t time)
+    {
+        loopEndTimeMicros = std::max(data.startTimeMicros(), std::min(time, data.endTimeMicros()));
+        orderLoopPoints();
+    }
+
+    /// \brief Clear the loop points.
+    void clearLoopPoints()
+    {
+        loopStartTimeMicros = -1;
+        loopEndTimeMicros = -1;
+    }
+
+    /// \brief Set the loop type.
+    ///
+    /// Only palindrome loops reverse the direction, so it is reset when
+    /// entering or leaving palindrome mode.
+    ///
+    /// \param type The loop type.
+    void setLoopType(ofLoopType type)
+    {
+        if (type == OF_LOOP_PALINDROME || loopType == OF_LOOP_PALINDROME)
+        {
+            playingForward = true;
+        }
+
+        loopType = type;
+    }
+
+    /// \brief Swap the loop points if they are out of order.
+    void orderLoopPoints()
+    {
+        // An unset loop point is -1, so only order the points once both are set.
+        if (loopStartTimeMicros >= 0
+        &&  loopEndTimeMicros >= 0
+        &&  loopStartTimeMicros > loopEndTimeMicros)
+        {
+            std::swap(loopStartTimeMicros, loopEndTimeMicros);
+        }
+    }
+};
+
+
+class CueIndex;
+
+
 /// \brief A base class for playing arbitrary timestamped data.
 class BasePlayer: public AbstractPlayer
 {
 public:
     /// \brief Destroy the AbstractPlayer.
     virtual ~BasePlayer();
+
+    /// \brief Advance the playhead by the real time since the last update.
     void update() override;
+
+    /// \brief Advance the playhead by the given real time.
+    ///
+    /// This is useful for fixed time steps and offline processing.
+    ///
+    /// \param elapsedRealTime The elapsed real time in microseconds.
+    virtual void update(double elapsedRealTime);
+
     bool isFrameIndexNew() const override;
     double getSpeed() const override;
     void setSpeed(double speed) override;
@@ -154,7 +806,17 @@ public:
     std::size_t getLoopEndFrameIndex() const override;
     void clearLoopPoints() override;
     ofLoopType getLoopType() const override;
+
+    /// \brief Set the loop type.
+    ///
+    /// Palindrome loops reverse the playing direction at each reflection.
+    /// The playing direction is reset to forward when entering or leaving
+    /// palindrome mode, so a player does not keep playing backwards after a
+    /// palindrome loop is switched off.
+    ///
+    /// \param loopType The ofLoopType type.
     void setLoopType(ofLoopType loopType) override;
+
     void setPaused(bool paused) override;
     void play() override;
     void stop() override;
@@ -173,10 +835,218 @@ public:
     std::size_t indexForTime(double time,
                              bool increasing,
                              std::size_t indexHint) const override;
+    void indexesForTimes(const double* times,
+                         std::size_t count,
+                         bool increasing,
+                         std::size_t* indexes) const override;
     double timeForIndex(std::size_t index) const override;
     double positionForTime(double time, bool clamp) const override;
     std::size_t size() const override;
 
+    /// \brief Get the current time of the player in integer microseconds.
+    ///
+    /// The playhead is kept as integer microseconds and a fractional
+    /// accumulator, so it does not drift from the media timestamps during
+    /// long playback of epoch timestamped media. This returns the integer
+    /// part, which selects the same frame as getTime() during forward
+    /// playback.
+    ///
+    /// \returns the current time of the player in integer microseconds.
+    int64_t getTimeMicros() const;
+
+    /// \brief Set the current time of the player in integer microseconds.
+    /// \param time The current time of the player in integer microseconds.
+    void setTimeMicros(int64_t time);
+
+    /// \brief Set the loop start point time in integer microseconds.
+    /// \param time Set the absolute start time.
+    void setLoopStartTimeMicros(int64_t time);
+
+    /// \brief Set the loop end point time in integer microseconds.
+    /// \param time Set the absolute end time.
+    void setLoopEndTimeMicros(int64_t time);
+
+    /// \returns the loop start time in integer microseconds.
+    int64_t getLoopStartTimeMicros() const;
+
+    /// \returns the loop end time in integer microseconds.
+    int64_t getLoopEndTimeMicros() const;
+
+    /// \brief Get the index ranges crossed during the last update.
+    ///
+    /// Every index with a timestamp passed by the playhead during the last
+    /// update is included exactly once per pass, in playback order. The index
+    /// at the playhead's previous position is excluded, since it was reported
+    /// by the previous update. On the first update, the starting index is
+    /// included.
+    ///
+    /// With OF_LOOP_NORMAL, a wrap produces a range up to the loop end and a
+    /// range from the loop start. With OF_LOOP_PALINDROME, each reflection
+    /// reverses the direction of the following range. Complete passes through
+    /// the loop are collapsed into a single range with a repeat count. For
+    /// palindrome loops, the repeated passes alternate direction starting with
+    /// the direction of the range. Repeated ranges may be empty.
+    ///
+    /// The ranges are computed with a few binary searches the first time they
+    /// are requested after an update and do not allocate.
+    ///
+    /// \returns the index ranges crossed during the last update.
+    const IndexRanges& getCrossedIndexRanges() const;
+
+    /// \brief Get the index ranges of another timeline crossed during the last update.
+    ///
+    /// This applies the media time traversed during the last update to any
+    /// sorted time indexed data sharing the player's time base, such as a
+    /// CueIndex. The ranges follow the same rules as getCrossedIndexRanges().
+    ///
+    /// \param indexed The time indexed data.
+    /// \param ranges The crossed index ranges.
+    /// \param indexHint The index to start the searches from.
+    void getCrossedIndexRanges(const BaseTimeIndexed& indexed,
+                               IndexRanges& ranges,
+                               std::size_t indexHint = 0) const;
+
+    /// \brief Get the number of frames the playhead intended to show during the last update.
+    ///
+    /// This is the number of frames crossed during the last update, including
+    /// repeated passes through a loop.
+    ///
+    /// \returns the number of intended frames.
+    std::size_t getFramesIntended() const;
+
+    /// \returns 1 if a new frame was shown during the last update, otherwise 0.
+    std::size_t getFramesShown() const;
+
+    /// \brief Get the number of frames dropped during the last update.
+    ///
+    /// Only one frame can be shown per update, so all other intended frames
+    /// are dropped.
+    ///
+    /// \returns the number of intended frames that were not shown.
+    std::size_t getFramesDropped() const;
+
+    /// \brief Get the presentation error of the shown frame.
+    ///
+    /// The error is the shown frame's timestamp minus the playhead time. The
+    /// shown frame is the last frame at or before the playhead, so the error
+    /// is usually negative during forward playback.
+    ///
+    /// \returns the presentation error in microseconds.
+    double getPresentationError() const;
+
+    /// \brief Set a time remap curve.
+    ///
+    /// While a curve is set, it replaces the scalar speed. The curve is
+    /// evaluated over the real time elapsed since it was set, starting at the
+    /// last update, and each update advances the playhead by the exact media
+    /// time integrated over the update interval. Pausing stops the curve.
+    /// Calling setSpeed() removes the curve.
+    ///
+    /// \param curve The curve to set, or nullptr to use the scalar speed.
+    void setTimeRemap(std::shared_ptr<const TimeRemapCurve> curve);
+
+    /// \returns the time remap curve or nullptr if none is set.
+    std::shared_ptr<const TimeRemapCurve> getTimeRemap() const;
+
+    /// \returns the real time elapsed on the time remap curve in microseconds.
+    double getTimeRemapTime() const;
+
+    /// \returns the real time between the last two updates in microseconds.
+    double getLastUpdateInterval() const;
+
+    /// \brief Get the media time the playhead will advance.
+    ///
+    /// This is the signed media time elapsed over the given real time from the
+    /// last update, taking the speed, time remap curve, direction and pause
+    /// state into account, but not the loop points.
+    ///
+    /// \param elapsedRealTime The real time after the last update in microseconds.
+    /// \returns the elapsed media time in microseconds.
+    double getElapsedMediaTime(double elapsedRealTime) const;
+
+    /// \brief Predict the time of the playhead.
+    ///
+    /// The playhead is advanced exactly as an update after the given real
+    /// time would, including loop wraps and palindrome reflections, without
+    /// changing the player.
+    ///
+    /// \param elapsedRealTime The real time after the last update in microseconds.
+    /// \returns the predicted time in microseconds.
+    double predictTime(double elapsedRealTime) const;
+
+    /// \brief Predict the time of the playhead in integer microseconds.
+    /// \param elapsedRealTime The real time after the last update in microseconds.
+    /// \returns the integer part of the predicted time in microseconds.
+    int64_t predictTimeMicros(double elapsedRealTime) const;
+
+    /// \brief Predict the frame index shown after the given real time.
+    /// \param elapsedRealTime The real time after the last update in microseconds.
+    /// \returns the predicted frame index.
+    std::size_t predictFrameIndex(double elapsedRealTime) const;
+
+    /// \brief Predict the index ranges the playhead will cross.
+    ///
+    /// This is the counterpart of getCrossedIndexRanges() for an update after
+    /// the given real time. It lets time indexed data sharing the player's
+    /// time base, such as a CueIndex, schedule upcoming entries ahead of time.
+    ///
+    /// \param indexed The time indexed data.
+    /// \param elapsedRealTime The real time after the last update in microseconds.
+    /// \param ranges The predicted index ranges.
+    /// \param indexHint The index to start the searches from.
+    void getPredictedIndexRanges(const BaseTimeIndexed& indexed,
+                                 double elapsedRealTime,
+                                 IndexRanges& ranges,
+                                 std::size_t indexHint = 0) const;
+
+    /// \brief Attach a cue index to the player.
+    ///
+    /// During each update, every cue crossed by the playhead notifies the cue
+    /// index's event in playback order, including cues crossed by loop wraps
+    /// and palindrome reflections.
+    ///
+    /// \param cues The cue index to attach, or nullptr to detach.
+    void setCueIndex(std::shared_ptr<CueIndex> cues);
+
+    /// \returns the attached cue index or nullptr if none is attached.
+    std::shared_ptr<CueIndex> getCueIndex() const;
+
+    /// \brief Enable or disable statistics.
+    ///
+    /// When disabled, updates are not timed or counted and the statistics
+    /// event is not notified. Statistics are disabled by default.
+    ///
+    /// \param enabled True if statistics should be recorded.
+    void setStatsEnabled(bool enabled);
+
+    /// \returns true if statistics are recorded.
+    bool isStatsEnabled() const;
+
+    /// \returns a snapshot of the statistics.
+    PlayerStats getStats() const;
+
+    /// \brief Reset the statistics.
+    void resetStats();
+
+    /// \brief Set the interval between statistics events.
+    /// \param interval The interval in microseconds.
+    void setStatsInterval(double interval);
+
+    /// \returns the interval between statistics events in microseconds.
+    double getStatsInterval() const;
+
+    /// \brief The event notified with a statistics snapshot.
+    ///
+    /// When statistics are enabled, this is notified from update() at most
+    /// once per statistics interval.
+    ofEvent<const PlayerStats> onStats;
+
+    enum
+    {
+        /// \brief The default interval between statistics events in microseconds.
+        DEFAULT_STATS_INTERVAL = 1000000
+    };
+
 protected:
     /// \brief A type definition for double microseconds.
     typedef std::chrono::duration<double, std::micro> micros_duration;
@@ -190,31 +1060,42 @@ protected:
     /// \returns a const pointer to the indexed data or nullptr if not loaded.
     virtual const BaseTimeIndexed* indexedData() const = 0;
 
-    /// \brief True if the frame is new.
-    bool _isFrameIndexNew = true;
+    /// \brief Notify the statistics event.
+    ///
+    /// Subclasses may override this to notify additional statistics.
+    virtual void notifyStats();
+
+    /// \brief Move the playhead before it is advanced by an update.
+    ///
+    /// This is called by update() before the playhead is advanced, so the
+    /// spans, cues and statistics of the update start from the moved
+    /// playhead. Subclasses may override this to constrain the playhead,
+    /// e.g. to trail the end of growing data. The default does nothing.
+    ///
+    /// \param elapsedTime The media time the update will advance by in
+    ///        microseconds. This is negative when playing backwards.
+    virtual void constrainPlayhead(double elapsedTime);
 
-    /// \brief The playback speed.
-    double _speed = 1;
+    /// \brief Get the frame index to read ahead from.
+    ///
+    /// Readahead fetches the frames following a frame index. This returns
+    /// the frame before the frame predicted for the next update, in the
+    /// playing direction, so readahead includes the frame that will be shown
+    /// even when the speed skips frames.
+    ///
+    /// \param increasing True if the frame index is increasing.
+    /// \returns the frame index to read ahead from.
+    std::size_t readaheadIndex(bool increasing) const;
 
-    /// \brief The playing direction.
-    bool _playingForward = true;
+    /// \brief The playhead time, direction, loop points and frame index.
+    Playhead<BaseTimeIndexed> _playhead;
 
-    /// \brief The playback time.
-    double _time = -1;
+    /// \brief The playback speed.
+    double _speed = 1;
 
     /// \brief The last playback time.
     double _lastTime = -1;
 
-    /// \brief The current frame index.
-    ///
-    /// This is used to check if the frame is new.
-    std::size_t _frameIndex = 0;
-
-    /// \brief The last frame index.
-    ///
-    /// This is used to check if the frame is new.
-    std::size_t _lastFrameIndex = 0;
-
     /// \brief The last update time in microseconds.
     std::chrono::high_resolution_clock::time_point _lastUpdateTime;
 
@@ -224,15 +1105,6 @@ protected:
     /// \brief A flag to determine if this is the first update.
     bool _isFirstUpdate = true;
 
-    /// \brief The playback loop type.
-    ofLoopType _loopType = OF_LOOP_NONE;
-
-    /// \brief The loop start time in microseconds.
-    double _loopStartTime = -1;
-
-    /// \brief The loop end time in microseconds.
-    double _loopEndTime = -1;
-
     /// \brief True if there are frames betwen the loop points.
     ///
     /// This is used to short circuit the search if it is known that there are
@@ -246,6 +1118,64 @@ protected:
     /// \brief True if data is loaded.
     bool _playing = false;
 
+    /// \brief The media time spans traversed during the last update.
+    TimeSpans _spans;
+
+    /// \brief The time remap curve or nullptr if none is set.
+    std::shared_ptr<const TimeRemapCurve> _timeRemap = nullptr;
+
+    /// \brief The real time elapsed on the time remap curve in microseconds.
+    double _timeRemapTime = 0;
+
+    /// \brief The real time between the last two updates in microseconds.
+    double _lastUpdateInterval = 0;
+
+private:
+    /// \brief Get the signed media time elapsed over a real time.
+    /// \param elapsedRealTime The unpaused real time in microseconds.
+    /// \returns the elapsed media time in microseconds.
+    double mediaTimeForRealTime(double elapsedRealTime) const;
+
+    /// \brief Advance a copy of the playhead as an update would.
+    /// \param elapsedRealTime The real time after the last update in microseconds.
+    /// \param spans The spans to record the traversed media time in.
+    /// \param playhead The predicted playhead.
+    /// \returns true if the playback time is increasing after advancing.
+    bool predict(double elapsedRealTime,
+                 TimeSpans& spans,
+                 Playhead<BaseTimeIndexed>& playhead) const;
+
+    /// \brief Record the statistics for an update.
+    /// \param updateStartTime The time the update started.
+    void recordStats(std::chrono::high_resolution_clock::time_point updateStartTime);
+
+    /// \brief The attached cue index.
+    std::shared_ptr<CueIndex> _cues = nullptr;
+
+    /// \brief True if statistics are recorded.
+    bool _isStatsEnabled = false;
+
+    /// \brief The interval between statistics events in microseconds.
+    double _statsInterval = DEFAULT_STATS_INTERVAL;
+
+    /// \brief The time of the last statistics event.
+    std::chrono::high_resolution_clock::time_point _lastStatsTime;
+
+    /// \brief The accumulated statistics, excluding the histograms.
+    PlayerStats _stats;
+
+    /// \brief The update durations.
+    LatencyHistogram _updateDuration;
+
+    /// \brief The absolute presentation errors.
+    LatencyHistogram _presentationError;
+
+    /// \brief The cached index ranges crossed during the last update.
+    mutable IndexRanges _crossedIndexRanges;
+
+    /// \brief True if the cached crossed index ranges are up to date.
+    mutable bool _isCrossedIndexRangesValid = false;
+
 };
 
 
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofJson.h"
+#include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/MappedFile.h"
+#include "ofx/Player/TimestampedURIIndex.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A memory mapped, chunked manifest of timestamped URIs.
+///
+/// The manifest splits the timestamped URIs into fixed size chunks. Each chunk
+/// has a summary with its minimum and maximum timestamp. Opening a manifest
+/// only reads the header and the chunk summaries. The chunks themselves are
+/// paged in by the operating system when they are first accessed, so opening
+/// a manifest takes the same time regardless of its length.
+///
+/// Searches first locate the chunk using the summaries and then search within
+/// that chunk, so only the pages of the matching chunk are touched.
+///
+/// Timestamps are stored as integer microseconds.
+///
+/// The file stores values in native byte order and is not intended to be
+/// portable between architectures with different endianness.
+class ChunkedURIManifest: public BaseTimeIndexed
+{
+public:
+    /// \brief A summary of a single chunk.
+    struct ChunkSummary
+    {
+        /// \brief The minimum timestamp in the chunk in integer microseconds.
+        int64_t minTime;
+
+        /// \brief The maximum timestamp in the chunk in integer microseconds.
+        int64_t maxTime;
+
+        /// \brief The offset of the chunk data in bytes.
+        uint64_t offset;
+
+        /// \brief The number of entries in the chunk.
+        uint64_t count;
+    };
+
+    /// \brief Create an unopened ChunkedURIManifest.
+    ChunkedURIManifest();
+
+    /// \brief Destroy the ChunkedURIManifest.
+    virtual ~ChunkedURIManifest();
+
+    /// \brief Open a manifest file.
+    ///
+    /// The header and every chunk summary are checked against the file size,
+    /// so a truncated or corrupt manifest fails to open rather than being
+    /// read out of bounds. The URI data of each chunk is checked when the
+    /// chunk is first read, and URIs of an invalid chunk are empty.
+    ///
+    /// \param filename The manifest file to open.
+    /// \returns true if the manifest was opened successfully.
+    bool open(const std::string& filename);
+
+    /// \brief Close the manifest file.
+    void close();
+
+    /// \returns true if a manifest is open.
+    bool isOpen() const;
+
+    double timeForIndex(std::size_t index) const override;
+
+    std::size_t size() const override;
+
+    std::size_t indexForTime(double time,
+                             bool increasing,
+                             std::size_t indexHint) const override;
+
+    int64_t timeForIndexMicros(std::size_t index) const override;
+
+    std::size_t indexForTimeMicros(int64_t time,
+                                   bool increasing,
+                                   std::size_t indexHint) const override;
+
+    /// \param index The index of the entry.
+    /// \returns the URI at the given index.
+    std::string uri(std::size_t index) const;
+
+    /// \param index The index of the entry.
+    /// \returns the timestamped URI at the given index.
+    TimestampedURI operator [] (std::size_t index) const;
+
+    /// \brief Visit every entry in order.
+    /// \param visitor A function taking a URI and a timestamp in integer
+    ///        microseconds.
+    void forEach(const std::function<void(const std::string&, int64_t)>& visitor) const;
+
+    /// \returns the number of entries per chunk.
+    std::size_t chunkSize() const;
+
+    /// \returns the number of chunks.
+    std::size_t chunkCount() const;
+
+    /// \param chunk The chunk index.
+    /// \returns the summary for the given chunk.
+    const ChunkSummary& chunk(std::size_t chunk) const;
+
+    /// \returns the metadata stored with the manifest.
+    const ofJson& metadata() const;
+
+    /// \brief Write a manifest file.
+    ///
+    /// The manifest is written to a temporary file that then replaces the
+    /// target, so manifests that are currently open are not modified.
+    ///
+    /// \param filename The manifest file to write.
+    /// \param images The sorted timestamped URIs to write.
+    /// \param metadata Metadata to store with the manifest.
+    /// \param chunkSize The number of entries per chunk.
+    /// \returns true if the manifest was written successfully.
+    static bool write(const std::string& filename,
+                      const TimestampedURIIndex& images,
+                      const ofJson& metadata = ofJson(),
+                      std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    enum
+    {
+        /// \brief The default number of entries per chunk.
+        DEFAULT_CHUNK_SIZE = 4096
+    };
+
+    /// \brief The manifest file format version.
+    static const uint32_t VERSION;
+
+private:
+    /// \brief The manifest file header.
+    struct Header
+    {
+        /// \brief The file magic.
+        char magic[8];
+
+        /// \brief The file format version.
+        uint32_t version;
+
+        /// \brief The number of entries per chunk.
+        uint32_t chunkSize;
+
+        /// \brief The total number of entries.
+        uint64_t count;
+
+        /// \brief The number of chunks.
+        uint64_t chunkCount;
+
+        /// \brief The offset of the chunk summaries in bytes.
+        uint64_t summaryOffset;
+
+        /// \brief The offset of the json metadata in bytes.
+        uint64_t metadataOffset;
+
+        /// \brief The length of the json metadata in bytes.
+        uint64_t metadataLength;
+    };
+
+    /// \brief The validation state of a chunk's URI data.
+    enum ChunkState: uint8_t
+    {
+        /// \brief The chunk has not been read yet.
+        CHUNK_UNCHECKED,
+        /// \brief The chunk's URI data lies within the file.
+        CHUNK_VALID,
+        /// \brief The chunk's URI data is corrupt or truncated.
+        CHUNK_INVALID
+    };
+
+    /// \brief Check the URI data of a chunk, once.
+    /// \param chunk The chunk index.
+    /// \returns true if the URI data lies within the file.
+    bool isValidChunk(std::size_t chunk) const;
+
+    /// \param chunk The chunk index.
+    /// \returns a pointer to the timestamps of the given chunk.
+    const int64_t* timestamps(std::size_t chunk) const;
+
+    /// \param chunk The chunk index.
+    /// \returns a pointer to the URI offsets of the given chunk.
+    const uint32_t* uriOffsets(std::size_t chunk) const;
+
+    /// \param chunk The chunk index.
+    /// \returns a pointer to the URI characters of the given chunk.
+    const char* uriData(std::size_t chunk) const;
+
+    /// \brief The mapped manifest file.
+    MappedFile _file;
+
+    /// \brief The header in the mapped file.
+    const Header* _header = nullptr;
+
+    /// \brief The chunk summaries in the mapped file.
+    const ChunkSummary* _summaries = nullptr;
+
+    /// \brief The ChunkState of each chunk, set on first read.
+    mutable std::unique_ptr<std::atomic<uint8_t>[]> _chunkStates;
+
+    /// \brief The parsed metadata.
+    ofJson _metadata;
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofEvents.h"
+#include "ofx/Player/BasePlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A named point in media time.
+class Cue
+{
+public:
+    /// \brief Create an empty Cue.
+    Cue();
+
+    /// \brief Create a Cue.
+    /// \param time The cue time in microseconds.
+    /// \param name The cue name.
+    Cue(double time, const std::string& name);
+
+    /// \returns the cue time in microseconds.
+    double time() const;
+
+    /// \returns the cue name.
+    const std::string& name() const;
+
+private:
+    /// \brief The cue time in microseconds.
+    double _time = 0;
+
+    /// \brief The cue name.
+    std::string _name;
+
+};
+
+
+/// \brief The arguments for a crossed cue event.
+class CueEventArgs
+{
+public:
+    /// \brief Create CueEventArgs.
+    /// \param cue The crossed cue.
+    /// \param index The index of the cue in its CueIndex.
+    /// \param increasing True if the playhead was moving forward.
+    CueEventArgs(const Cue& cue, std::size_t index, bool increasing);
+
+    /// \returns the crossed cue.
+    const Cue& cue() const;
+
+    /// \returns the index of the cue in its CueIndex.
+    std::size_t index() const;
+
+    /// \returns true if the playhead was moving forward.
+    bool isIncreasing() const;
+
+private:
+    /// \brief The crossed cue.
+    const Cue& _cue;
+
+    /// \brief The index of the cue.
+    std::size_t _index = 0;
+
+    /// \brief True if the playhead was moving forward.
+    bool _increasing = true;
+
+};
+
+
+/// \brief A sorted index of cues that notifies when the playhead crosses them.
+///
+/// Attach a CueIndex to a player with BasePlayer::setCueIndex(). After each
+/// update, every cue crossed by the playhead is notified once per pass in
+/// playback order. Jumps of any length, loop wraps and palindrome reflections
+/// are taken into account, so cues are never missed at high speeds.
+///
+/// Locating the crossed cues takes a few hinted binary searches, so the cost
+/// of each update is O(log n + crossed).
+///
+/// Cues that will be crossed after a given real time, e.g. to schedule them
+/// ahead of time, are found with BasePlayer::getPredictedIndexRanges().
+///
+/// Cues must not be added or removed from within the cue event.
+class CueIndex: public BaseTimeIndexed
+{
+public:
+    /// \brief Create an empty CueIndex.
+    CueIndex();
+
+    /// \brief Destroy the CueIndex.
+    virtual ~CueIndex();
+
+    /// \brief Add a cue.
+    ///
+    /// Cues with equal times are ordered by insertion.
+    ///
+    /// \param time The cue time in microseconds.
+    /// \param name The cue name.
+    /// \returns the index of the added cue.
+    std::size_t add(double time, const std::string& name);
+
+    /// \brief Remove a cue.
+    /// \param index The index of the cue to remove.
+    void remove(std::size_t index);
+
+    /// \brief Remove all cues.
+    void clear();
+
+    /// \param index The cue index.
+    /// \returns the cue at the given index.
+    const Cue& operator [] (std::size_t index) const;
+
+    double timeForIndex(std::size_t index) const override;
+    std::size_t size() const override;
+    const double* timestampData() const override;
+
+    /// \brief Notify the cues crossed during the player's last update.
+    ///
+    /// This is called by BasePlayer::update() when the CueIndex is attached.
+    ///
+    /// \param player The player that was updated.
+    void notify(const BasePlayer& player);
+
+    /// \brief The event notified when a cue is crossed.
+    ofEvent<const CueEventArgs> onCue;
+
+private:
+    /// \brief The cues sorted by time.
+    std::vector<Cue> _cues;
+
+    /// \brief The cue times in microseconds.
+    std::vector<double> _times;
+
+    /// \brief The crossed cue ranges.
+    IndexRanges _ranges;
+
+    /// \brief The index of the last crossed cue, used as a search hint.
+    std::size_t _lastIndex = 0;
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "ofx/IO/RegexPathFilter.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Watch a directory for newly written files.
+///
+/// The watcher reports files that have been completely written into, or moved
+/// into, a single directory (it does not recurse into subdirectories). Files
+/// are reported only once they have been closed, so partially written files
+/// are never reported.
+///
+/// Notifications are collected on a background thread and retrieved with
+/// poll(), so the caller never scans the directory.
+///
+/// Notifications can be missed for files written before the watch was
+/// installed, or when the notification queue overflows. In both cases the
+/// background thread lists the directory and reports every matching file, and
+/// poll() flags the result as a rescan so the caller can skip files it
+/// already knows.
+///
+/// This is currently implemented with inotify and is only supported on Linux.
+class DirectoryWatcher
+{
+public:
+    /// \brief Create a DirectoryWatcher and begin watching.
+    /// \param directory The directory to watch.
+    /// \param filePattern The regex file pattern to report.
+    DirectoryWatcher(const std::string& directory,
+                     const std::string& filePattern);
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator = (const DirectoryWatcher&) = delete;
+
+    /// \brief Destroy the DirectoryWatcher.
+    ~DirectoryWatcher();
+
+    /// \returns true if the directory is being watched.
+    bool isWatching() const;
+
+    /// \returns the watched directory.
+    std::string directory() const;
+
+    /// \brief Retrieve the files written since the last poll.
+    ///
+    /// Paths are reported in notification order and include the watched
+    /// directory. The first poll after the watch is installed, and the first
+    /// poll after the notification queue overflows, also report every
+    /// matching file in the directory, which may include files that were
+    /// already reported.
+    ///
+    /// \param filenames The vector to append the new file paths to.
+    /// \param isRescan If not nullptr, set to true if the file paths include
+    ///        a listing of the directory.
+    /// \returns the number of file paths appended.
+    std::size_t poll(std::vector<std::string>& filenames,
+                     bool* isRescan = nullptr);
+
+    /// \returns true if directory watching is supported on this platform.
+    static bool isSupported();
+
+private:
+    /// \brief The watcher thread loop.
+    void run();
+
+    /// \brief List the directory and collect every matching file.
+    void rescan();
+
+    /// \brief The watched directory.
+    std::string _directory;
+
+    /// \brief The filter used to select reported files.
+    IO::RegexPathFilter _filter;
+
+    /// \brief The notification file descriptor.
+    int _fd = -1;
+
+    /// \brief The watch descriptor for the directory.
+    int _wd = -1;
+
+    /// \brief True while the watcher thread should keep running.
+    std::atomic<bool> _running;
+
+    /// \brief The mutex protecting the collected file paths.
+    mutable std::mutex _mutex;
+
+    /// \brief The file paths collected since the last poll.
+    std::vector<std::string> _filenames;
+
+    /// \brief True if the collected file paths include a directory listing.
+    bool _isRescan = false;
+
+    /// \brief The watcher thread.
+    std::thread _thread;
+
+};
+
+
+} } // namespace ofx::Player
@@ -8,9 +8,15 @@
 #pragma once
 
 
+#include <chrono>
 #include "ofJson.h"
+#include "ofx/Player/AsyncFileReader.h"
 #include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/ChunkedURIManifest.h"
+#include "ofx/Player/DirectoryWatcher.h"
 #include "ofx/Player/IndexedFile.h"
+#include "ofx/Player/PlayerStats.h"
+#include "ofx/Player/TimestampedURIIndex.h"
 #include "ofx/Cache/LRUMemoryCache.h"
 
 
@@ -133,6 +139,18 @@ public:
 
     std::size_t size() const override;
 
+    std::size_t indexForTime(double time,
+                             bool increasing,
+                             std::size_t indexHint) const override;
+
+    int64_t timeForIndexMicros(std::size_t index) const override;
+
+    std::size_t indexForTimeMicros(int64_t time,
+                                   bool increasing,
+                                   std::size_t indexHint) const override;
+
+    const int64_t* timestampMicrosData() const override;
+
     /// \returns the sequence width.
     float getWidth() const;
 
@@ -181,6 +199,15 @@ public:
     /// \returns the base directory for the URIs.
     std::string baseDirectory() const;
 
+    /// \brief Get the timestamped URI for a given frame index.
+    ///
+    /// Unlike images(), this also works for sequences loaded with
+    /// fromManifest().
+    ///
+    /// \param index The frame index to get.
+    /// \returns the timestamped URI at the given index.
+    TimestampedURI image(std::size_t index) const;
+
     /// \brief Resolve a relative URI against the base directory.
     /// \returns resolved URI against the base directory from the given URI.
     std::string resolve(const TimestampedURI& uri) const;
@@ -218,8 +245,39 @@ public:
     static bool toJson(const ImageSequence& sequence,
                        const std::string& filename = "");
 
+    /// \brief Load an ImageSequence from a chunked binary manifest.
+    ///
+    /// The manifest is memory mapped and only its chunk summaries are read,
+    /// so loading takes the same time regardless of the sequence length.
+    /// Chunks are paged in when they are first searched or accessed.
+    ///
+    /// Modifying the sequence (e.g. with refresh() or follow()) first loads
+    /// the whole manifest into memory.
+    ///
+    /// \param filename The manifest file to load.
+    /// \param sequence The ImageSequence to load.
+    /// \returns true if the ImageSequence was loaded successfully.
+    static bool fromManifest(const std::string& filename,
+                             ImageSequence& sequence);
+
+    /// \brief Save an ImageSequence to a chunked binary manifest.
+    /// \param sequence The ImageSequence to save.
+    /// \param filename The manifest file to write.
+    /// \param chunkSize The number of images per chunk.
+    /// \returns true if the ImageSequence was saved successfully.
+    static bool toManifest(const ImageSequence& sequence,
+                           const std::string& filename,
+                           std::size_t chunkSize = ChunkedURIManifest::DEFAULT_CHUNK_SIZE);
+
+    /// \brief Get the timestamped image URIs.
+    ///
+    /// The URIs are stored compactly and reconstructed on access. For
+    /// sequences loaded with fromManifest() the first call loads the whole
+    /// manifest into memory, so prefer image() or forEachImage() for long
+    /// sequences.
+    ///
     /// \returns a const reference to the timestamped image URIs.
-    const std::vector<TimestampedURI>& images() const;
+    const TimestampedURIIndex& images() const;
 
     /// \brief Set the size of the pixel cache.
     ///
@@ -241,12 +299,169 @@ public:
     /// \brief Clear the texture cache.
     void clearTextureCache();
 
+    /// \brief Enable or disable statistics.
+    ///
+    /// When enabled, cache hits, misses and evictions, bytes read and read,
+    /// decode and texture upload latencies are recorded. When disabled, the
+    /// only cost is a flag check. Statistics are disabled by default.
+    ///
+    /// \param enabled True if statistics should be recorded.
+    void setStatsEnabled(bool enabled);
+
+    /// \returns true if statistics are recorded.
+    bool isStatsEnabled() const;
+
+    /// \returns a snapshot of the statistics.
+    ImageSequenceStats getStats() const;
+
+    /// \brief Reset the statistics.
+    void resetStats();
+
+    /// \brief Notify the statistics event with a snapshot.
+    ///
+    /// This is called by an ImageSequencePlayer at its statistics interval.
+    void notifyStats();
+
+    /// \brief The event notified with a statistics snapshot.
+    ofEvent<const ImageSequenceStats> onStats;
+
+    /// \brief Enable or disable decode timing.
+    ///
+    /// When enabled, each decode is timed to update the smoothed decode
+    /// duration, at the cost of two clock reads per decode. The decode
+    /// throughput checks of ImageSequencePlayer depend on it, so it is
+    /// enabled by default. Decodes are always timed while statistics are
+    /// enabled.
+    ///
+    /// \param enabled True if decodes should be timed.
+    void setDecodeTimingEnabled(bool enabled);
+
+    /// \returns true if decodes are timed.
+    bool isDecodeTimingEnabled() const;
+
+    /// \brief Get the smoothed image decode duration.
+    ///
+    /// This is measured while decode timing or statistics are enabled. It
+    /// includes the file read for frames that were not read ahead.
+    ///
+    /// \returns the decode duration in microseconds or 0 if nothing has
+    ///          been timed.
+    double getAverageDecodeDuration() const;
+
+    /// \returns the number of images decoded while decode timing or
+    ///          statistics were enabled.
+    uint64_t getDecodeCount() const;
+
+    /// \brief Set the number of frames to read ahead of the playhead.
+    ///
+    /// Frames within the readahead window are fetched from disk on a
+    /// background thread, so that only decoding remains when the frame is
+    /// requested. Setting the size to 0 disables readahead.
+    ///
+    /// \param size The number of frames to read ahead.
+    void setReadaheadSize(std::size_t size);
+
+    /// \returns the number of frames to read ahead of the playhead.
+    std::size_t getReadaheadSize() const;
+
+    /// \brief Begin fetching the frames following the given frame index.
+    ///
+    /// This call does not block. Frames that are already cached are skipped.
+    ///
+    /// \param index The current frame index.
+    /// \param increasing True if the frame index is increasing.
+    void prefetch(std::size_t index, bool increasing);
+
+    /// \brief Incrementally refresh the sequence from its base directory.
+    ///
+    /// The size and modification time of each image and the modification
+    /// times of the directories containing them are recorded by the first
+    /// refresh, unless they were loaded from a json file, so loading never
+    /// stats every image. The base directory time is taken at load, so files
+    /// added or removed after loading are found by the first refresh, but
+    /// files modified in place before it are not. A refresh returns
+    /// immediately if none of the recorded directories have been modified. Otherwise the directory is listed and
+    /// only added or removed files are timestamped and merged into the
+    /// already sorted images. New files that can not be stat'ed yet are
+    /// skipped until a later refresh.
+    ///
+    /// Files modified in place do not change their directory's modification
+    /// time. If \p checkModifiedFiles is true, each existing file is restated
+    /// and any file with a changed size or modification time is re-read.
+    ///
+    /// If any images are removed, the caches are cleared. If images are
+    /// inserted out of order, cached frames are moved to their new indices.
+    ///
+    /// \param filePattern The regex file pattern to load.
+    /// \param stamper The timestamper to use for added files.
+    /// \param checkModifiedFiles True if existing files should be restated.
+    /// \returns true if the refresh was successful.
+    bool refresh(const std::string& filePattern,
+                 const AbstractURITimestamper& stamper = FilenameTimestamper(),
+                 bool checkModifiedFiles = false);
+
+    /// \brief Follow the base directory for newly written images.
+    ///
+    /// This is used for sequences that are still being written, e.g. by a
+    /// capture process. New files matching the pattern are timestamped with the
+    /// stamper and appended to the sequence by appendNewFiles(). The directory
+    /// is only rescanned once the watch is installed and if notifications are
+    /// lost, and then only files at or after the end of the sequence are
+    /// added.
+    ///
+    /// Only files written directly into the base directory are followed.
+    ///
+    /// \param filePattern The regex file pattern to follow.
+    /// \param stamper The timestamper to use for new files.
+    /// \returns true if the base directory is being followed.
+    bool follow(const std::string& filePattern,
+                std::shared_ptr<const AbstractURITimestamper> stamper = std::make_shared<FilenameTimestamper>());
+
+    /// \brief Stop following the base directory.
+    ///
+    /// Images held for the reorder window are appended.
+    void unfollow();
+
+    /// \returns true if the base directory is being followed.
+    bool isFollowing() const;
+
+    /// \brief Append images written since the last call.
+    ///
+    /// New images are held for the reorder window before they are appended,
+    /// so images written slightly out of order are sorted before they reach
+    /// the sequence. Images whose URI is already held or indexed (e.g. a file
+    /// that was closed twice) are ignored. An image that arrives after the
+    /// reorder window and before the end of the sequence is merged into
+    /// place, which shifts the indices after it. Cached frames are moved to
+    /// their new indices rather than cleared.
+    ///
+    /// This should be called regularly (e.g. on each update) while following,
+    /// since held images are only appended by a later call.
+    ///
+    /// \returns the number of images added.
+    std::size_t appendNewFiles();
+
+    /// \brief Set the time that followed images are held before appending.
+    ///
+    /// A longer window tolerates more reordering by the writer, but delays
+    /// new images by up to the window.
+    ///
+    /// \param window The reorder window in microseconds.
+    void setReorderWindowMicros(uint64_t window);
+
+    /// \returns the reorder window in microseconds.
+    uint64_t getReorderWindowMicros() const;
+
     enum
     {
         /// \brief The default number of frame pixels to cache.
         DEFAULT_PIXEL_CACHE_SIZE = 256,
         /// \brief The default number of frame textures to cache.
-        DEFAULT_TEXTURE_CACHE_SIZE = 256
+        DEFAULT_TEXTURE_CACHE_SIZE = 256,
+        /// \brief The default number of frames to read ahead.
+        DEFAULT_READAHEAD_SIZE = 8,
+        /// \brief The default reorder window for followed images.
+        DEFAULT_REORDER_WINDOW_MICROS = 100000
     };
 
 private:
@@ -256,6 +471,94 @@ private:
     /// \brief A typedef for a texture cache.
     typedef Cache::LRUMemoryCache<std::size_t, ofTexture> TextureCache;
 
+    /// \brief A record of a file's size and modification time.
+    struct FileRecord
+    {
+        /// \brief The file size in bytes.
+        uint64_t size = 0;
+
+        /// \brief The file modification time in file clock ticks.
+        int64_t modified = 0;
+    };
+
+    /// \brief Get the size and modification time of a file.
+    /// \param path The path to query.
+    /// \param record The record to fill.
+    /// \returns true if the file exists.
+    static bool statFile(const std::string& path, FileRecord& record);
+
+    /// \brief Get the modification time of a directory.
+    /// \param path The directory path to query.
+    /// \returns the modification time in file clock ticks or -1 on failure.
+    static int64_t directoryModified(const std::string& path);
+
+    /// \brief Record the file and directory state of all unrecorded images.
+    ///
+    /// Existing records, e.g. loaded from json, are kept.
+    void recordFiles();
+
+    /// \brief Record the state of a file and its directory.
+    /// \param uri The URI of the image to record.
+    void recordFile(const std::string& uri);
+
+    /// \brief Load a mapped manifest into memory.
+    ///
+    /// Indices do not change, so the caches remain valid. This does nothing if
+    /// the sequence is not backed by a manifest.
+    void materialize();
+
+    /// \brief Copy the mapped manifest into _images.
+    ///
+    /// The manifest is kept, so this can be called from const accessors.
+    void copyManifest() const;
+
+    /// \brief Visit every image in order.
+    /// \param visitor A function taking a URI and a timestamp in integer
+    ///        microseconds.
+    void forEachImage(const std::function<void(const std::string&, int64_t)>& visitor) const;
+
+    /// \brief Load and decode the pixels for a given frame index.
+    ///
+    /// If the raw bytes were already fetched by the readahead reader, they are
+    /// decoded directly. Otherwise the file is read from disk.
+    ///
+    /// \param index The frame index to load.
+    /// \returns the loaded pixels.
+    /// \throws std::runtime_error if the image can't be loaded.
+    std::shared_ptr<ofPixels> loadPixels(std::size_t index) const;
+
+    /// \param index The frame index to query.
+    /// \returns true if the pixels for the given index are cached.
+    bool isPixelsCached(std::size_t index) const;
+
+    /// \brief A followed image waiting for the reorder window.
+    struct PendingImage
+    {
+        /// \brief The timestamped image.
+        TimestampedURI image;
+
+        /// \brief The time the image was seen.
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    /// \brief Insert timestamped images while keeping the images sorted.
+    ///
+    /// If all images are at or after the last timestamp, they are appended and
+    /// the caches remain valid. Otherwise the images are merged into place
+    /// and the cached frames after them are moved to their new indices.
+    ///
+    /// \param images The images to insert. The images will be sorted.
+    void insertImages(std::vector<TimestampedURI>& images);
+
+    /// \brief Move cached frames to their indices after an insertion.
+    /// \param positions The sorted indices, before insertion, that each
+    ///        inserted image was inserted before.
+    void shiftCaches(const std::vector<std::size_t>& positions);
+
+    /// \param image The image to find.
+    /// \returns true if an image with the same URI and timestamp is indexed.
+    bool isIndexed(const TimestampedURI& image) const;
+
     /// \brief The sequnce name, if set.
     std::string _name;
 
@@ -263,7 +566,18 @@ private:
     std::string _baseDirectory;
 
     /// \brief A collection of timestamped images.
-    std::vector<TimestampedURI> _images;
+    mutable TimestampedURIIndex _images;
+
+    /// \brief The mapped manifest, if loaded with fromManifest().
+    ///
+    /// When set, the images are read from the manifest instead of _images.
+    std::unique_ptr<ChunkedURIManifest> _manifest;
+
+    /// \brief True if _images holds a copy of the manifest for images().
+    mutable bool _isManifestCopied = false;
+
+    /// \brief The mutex protecting the copy of the manifest.
+    mutable std::mutex _imagesMutex;
 
     /// \brief The image width;
     float _width = 0;
@@ -271,12 +585,85 @@ private:
     /// \brief The image height;
     float _height = 0;
 
+    /// \brief The maximum number of pixels frames to cache.
+    std::size_t _pixelCacheSize = DEFAULT_PIXEL_CACHE_SIZE;
+
+    /// \brief The maximum number of textures to cache.
+    std::size_t _textureCacheSize = DEFAULT_TEXTURE_CACHE_SIZE;
+
     /// \brief A cache for pixels.
     mutable std::unique_ptr<PixelCache> _pixelCache;
 
     /// \brief A cache for textures.
     mutable std::unique_ptr<TextureCache> _textureCache;
 
+    /// \brief The number of frames to read ahead of the playhead.
+    std::size_t _readaheadSize = DEFAULT_READAHEAD_SIZE;
+
+    /// \brief The background reader for raw frame bytes.
+    ///
+    /// This is created on the first call to prefetch().
+    mutable std::unique_ptr<AsyncFileReader> _reader;
+
+    /// \brief True if statistics are recorded.
+    bool _isStatsEnabled = false;
+
+    /// \brief True if decodes are timed for the smoothed decode duration.
+    bool _isDecodeTimingEnabled = true;
+
+    /// \brief The pixel cache counters.
+    mutable CacheCounters _pixelCacheCounters;
+
+    /// \brief The texture cache counters.
+    mutable CacheCounters _textureCacheCounters;
+
+    /// \brief The number of frames whose bytes were fetched by readahead.
+    mutable std::atomic<uint64_t> _readaheadHits { 0 };
+
+    /// \brief The number of encoded bytes read.
+    mutable std::atomic<uint64_t> _bytesRead { 0 };
+
+    /// \brief The blocking file read latencies.
+    mutable LatencyHistogram _readLatency;
+
+    /// \brief The image decode latencies.
+    mutable LatencyHistogram _decodeLatency;
+
+    /// \brief The texture upload latencies.
+    mutable LatencyHistogram _uploadLatency;
+
+    /// \brief The smoothed decode duration in microseconds.
+    mutable std::atomic<double> _averageDecodeDuration { 0 };
+
+    /// \brief The number of images decoded.
+    mutable std::atomic<uint64_t> _decodeCount { 0 };
+
+    /// \brief The recorded file state of each image by URI.
+    ///
+    /// Unless loaded from json, this is empty until the first refresh().
+    std::unordered_map<std::string, FileRecord> _fileRecords;
+
+    /// \brief The recorded modification time of each image directory.
+    ///
+    /// The base directory is recorded at load, and the directories of the
+    /// images by the first refresh().
+    std::unordered_map<std::string, int64_t> _directoryRecords;
+
+    /// \brief True once every image has a file record.
+    bool _isRecorded = false;
+
+    /// \brief The watcher for a followed base directory.
+    std::unique_ptr<DirectoryWatcher> _watcher;
+
+    /// \brief The timestamper used for followed files.
+    std::shared_ptr<const AbstractURITimestamper> _followStamper;
+
+    /// \brief The followed images waiting for the reorder window, by time.
+    std::vector<PendingImage> _pendingImages;
+
+    /// \brief The reorder window for followed images in microseconds.
+    uint64_t _reorderWindowMicros = DEFAULT_REORDER_WINDOW_MICROS;
+
 };
 
 
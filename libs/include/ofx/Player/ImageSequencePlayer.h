@@ -30,6 +30,74 @@ public:
     /// \brief Destroy the ImageSequencePlayer.
     virtual ~ImageSequencePlayer();
 
+    /// \brief Update the player and prefetch upcoming frames.
+    ///
+    /// If the sequence is following its directory, newly written images are
+    /// appended before the playhead is updated.
+    ///
+    /// \param elapsedRealTime The elapsed real time in microseconds.
+    void update(double elapsedRealTime) override;
+
+    using BasePlayer::update;
+
+    /// \brief Set the maximum latency behind the end of the sequence.
+    ///
+    /// When set, the playhead is never allowed to fall further than the given
+    /// latency behind the last frame. This is used to trail the live edge of a
+    /// followed sequence. The playhead jumps before each update advances it,
+    /// so the update's crossed frames and cues start at the jump. A negative
+    /// value disables the limit.
+    ///
+    /// \param latency The maximum latency in microseconds.
+    void setLiveEdgeLatency(double latency);
+
+    /// \returns the maximum latency behind the end of the sequence.
+    double getLiveEdgeLatency() const;
+
+    /// \brief Enable or disable decode throughput warnings.
+    ///
+    /// When enabled, a warning is logged if image decoding can not keep up
+    /// with the current speed for longer than the warning delay. Warnings
+    /// are enabled by default. The throughput is only measured while
+    /// ImageSequence::isDecodeTimingEnabled() is true.
+    ///
+    /// \param enabled True if warnings should be logged.
+    void setDecodeThroughputWarningEnabled(bool enabled);
+
+    /// \returns true if decode throughput warnings are logged.
+    bool isDecodeThroughputWarningEnabled() const;
+
+    /// \brief Get the decode throughput needed to show every intended frame.
+    ///
+    /// This is the average frame rate of the sequence scaled by the current
+    /// speed. If the application has a target frame rate, it is limited to
+    /// that rate, since only one frame is shown per update.
+    ///
+    /// \returns the required throughput in frames per second.
+    double getRequiredDecodeThroughput() const;
+
+    /// \returns the measured decode throughput in frames per second or 0 if
+    ///          nothing has been decoded.
+    double getDecodeThroughput() const;
+
+    /// \brief Determine if decoding is keeping up with the current speed.
+    ///
+    /// This is only reevaluated during updates that decoded new frames and
+    /// becomes false after decoding has fallen behind for longer than the
+    /// warning delay.
+    ///
+    /// \returns true if the decode throughput is sufficient.
+    bool isDecodeThroughputSufficient() const;
+
+    enum
+    {
+        /// \brief The time decoding must fall behind before a warning in microseconds.
+        DEFAULT_THROUGHPUT_WARNING_DELAY = 1000000,
+
+        /// \brief The minimum time between repeated warnings in microseconds.
+        DEFAULT_THROUGHPUT_WARNING_INTERVAL = 10000000
+    };
+
     bool load(std::shared_ptr<ImageSequence> data);
 
     void close();
@@ -50,8 +118,35 @@ public:
 //protected:
     const BaseTimeIndexed* indexedData() const override;
 
+    /// \brief Notify the player and the sequence statistics events.
+    void notifyStats() override;
+
+    /// \brief Move the playhead up to the live edge, if it trails too far.
+    void constrainPlayhead(double elapsedTime) override;
+
     std::shared_ptr<ImageSequence> _data;
 
+    /// \brief The maximum latency behind the end of the sequence.
+    double _liveEdgeLatency = -1;
+
+    /// \brief Reevaluate the decode throughput and log changes.
+    void checkDecodeThroughput();
+
+    /// \brief True if decode throughput warnings are logged.
+    bool _isDecodeThroughputWarningEnabled = true;
+
+    /// \brief True if the decode throughput is sufficient.
+    bool _isDecodeThroughputSufficient = true;
+
+    /// \brief The sequence decode count at the last throughput check.
+    uint64_t _lastDecodeCount = 0;
+
+    /// \brief The last time the decode throughput was sufficient.
+    std::chrono::steady_clock::time_point _lastSufficientTime;
+
+    /// \brief The time of the last throughput warning.
+    std::chrono::steady_clock::time_point _lastThroughputWarningTime;
+
 //    bool _isUsingTexture = true;
 //
 //    ofPixels* _pixels = nullptr;
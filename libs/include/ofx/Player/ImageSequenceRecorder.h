@@ -0,0 +1,301 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "ofImage.h"
+#include "ofJson.h"
+#include "ofx/Player/IndexedFile.h"
+#include "ofx/Player/TimestampedURIIndex.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Record timestamped frames to an image sequence on disk.
+///
+/// Frames are queued by the capture thread and encoded by a pool of worker
+/// threads. Each file is named with its timestamp in the
+/// FilenameTimestamper::DEFAULT_TIMESTAMP_FORMAT, so the recording can be
+/// loaded with ImageSequence::fromDirectory() and a FilenameTimestamper.
+///
+/// The queue is bounded. When it is full, frames are either dropped or the
+/// capture thread blocks until space is available, depending on the
+/// OverflowPolicy. Queued pixel buffers are recycled, so once the queue has
+/// been filled, adding frames of a constant size does not allocate pixels.
+///
+/// Written files are appended, in timestamp order, to a journal with one json
+/// object per line, which costs the same for every frame however long the
+/// recording is. When recording stops, the journal is compacted into a json
+/// manifest readable by ImageSequence::fromJson() and removed. If recording
+/// never stops (e.g. after a crash), the journal lists the written files.
+class ImageSequenceRecorder
+{
+public:
+    /// \brief What to do when a frame is added to a full queue.
+    enum class OverflowPolicy
+    {
+        /// \brief Drop the frame so capture never stalls.
+        DROP,
+        /// \brief Block the capture thread until the queue has space.
+        BLOCK
+    };
+
+    /// \brief Create an ImageSequenceRecorder.
+    ImageSequenceRecorder();
+
+    ImageSequenceRecorder(const ImageSequenceRecorder&) = delete;
+    ImageSequenceRecorder& operator = (const ImageSequenceRecorder&) = delete;
+
+    /// \brief Destroy the ImageSequenceRecorder, stopping any recording.
+    ~ImageSequenceRecorder();
+
+    /// \brief Start recording to a directory.
+    ///
+    /// The directory is created if it does not exist.
+    ///
+    /// \param directory The directory to write files to.
+    /// \param extension The image file extension, which selects the encoder.
+    /// \param threadCount The number of encoding threads.
+    /// \param queueSize The maximum number of queued frames.
+    /// \param policy The policy when the queue is full.
+    /// \returns true if recording started.
+    bool start(const std::string& directory,
+               const std::string& extension = DEFAULT_EXTENSION,
+               std::size_t threadCount = DEFAULT_THREAD_COUNT,
+               std::size_t queueSize = DEFAULT_QUEUE_SIZE,
+               OverflowPolicy policy = OverflowPolicy::DROP);
+
+    /// \brief Stop recording.
+    ///
+    /// All queued frames are written before the manifest is saved and the
+    /// journal is removed.
+    void stop();
+
+    /// \returns true if recording.
+    bool isRecording() const;
+
+    /// \brief Add a frame timestamped with the current time.
+    /// \param pixels The pixels to record.
+    /// \returns true if the frame was queued.
+    bool add(const ofPixels& pixels);
+
+    /// \brief Add a frame with a timestamp.
+    ///
+    /// Filenames have millisecond resolution. A timestamp that would reuse
+    /// the previous filename is moved forward by one millisecond.
+    ///
+    /// \param pixels The pixels to record.
+    /// \param timestamp The epoch timestamp in integer microseconds.
+    /// \returns true if the frame was queued.
+    bool add(const ofPixels& pixels, int64_t timestamp);
+
+    /// \returns the number of frames written.
+    std::size_t getWrittenCount() const;
+
+    /// \returns the number of frames dropped because the queue was full.
+    std::size_t getDroppedCount() const;
+
+    /// \returns the number of frames that failed to encode or write.
+    std::size_t getFailedCount() const;
+
+    /// \returns the number of queued frames.
+    std::size_t getQueuedCount() const;
+
+    /// \brief Set the number of written frames between journal flushes.
+    /// \param interval The number of frames, or 0 to only flush on stop().
+    void setManifestInterval(std::size_t interval);
+
+    /// \returns the number of written frames between journal flushes.
+    std::size_t getManifestInterval() const;
+
+    /// \returns the path of the json manifest.
+    std::string getManifestPath() const;
+
+    /// \param directory The recording directory.
+    /// \returns the path of the json manifest for the directory.
+    static std::string getManifestPath(const std::string& directory);
+
+    /// \brief Write the json manifest of a recording directory.
+    ///
+    /// The manifest is named for the directory and is readable by
+    /// ImageSequence::fromJson(). It is written to a temporary file and
+    /// renamed, so readers never see a partially written manifest.
+    ///
+    /// \param directory The recording directory.
+    /// \param width The image width.
+    /// \param height The image height.
+    /// \param images The images, relative to the directory.
+    /// \returns true if the manifest was written.
+    static bool writeManifest(const std::string& directory,
+                              float width,
+                              float height,
+                              const TimestampedURIIndex& images);
+
+    /// \returns the path of the journal of written files.
+    std::string getJournalPath() const;
+
+    /// \brief The default image file extension.
+    static const std::string DEFAULT_EXTENSION;
+
+    enum
+    {
+        /// \brief The default number of encoding threads.
+        DEFAULT_THREAD_COUNT = 2,
+        /// \brief The default maximum number of queued frames.
+        DEFAULT_QUEUE_SIZE = 32,
+        /// \brief The default number of frames between journal flushes.
+        DEFAULT_MANIFEST_INTERVAL = 30
+    };
+
+private:
+    /// \brief A queued frame.
+    struct Frame
+    {
+        /// \brief The pixels to encode.
+        ofPixels pixels;
+
+        /// \brief The epoch timestamp in integer microseconds.
+        int64_t timestamp = 0;
+
+        /// \brief The filename relative to the directory.
+        std::string uri;
+
+        /// \brief The order in which the frame was queued.
+        uint64_t sequence = 0;
+    };
+
+    /// \brief A frame finished by a worker before an earlier queued frame.
+    struct FinishedFrame
+    {
+        /// \brief The order in which the frame was queued.
+        uint64_t sequence = 0;
+
+        /// \brief True if the frame was written.
+        bool success = false;
+
+        /// \brief The filename relative to the directory.
+        std::string uri;
+
+        /// \brief The epoch timestamp in integer microseconds.
+        int64_t timestamp = 0;
+    };
+
+    /// \brief The worker thread loop.
+    void run();
+
+    /// \brief Record a finished frame.
+    ///
+    /// Frames are queued in timestamp order, but workers may finish them out
+    /// of order. Finished frames are held until every earlier queued frame
+    /// has finished, then written files are appended to the images and the
+    /// journal in order.
+    ///
+    /// \param frame The finished frame.
+    /// \param success True if the frame was written.
+    void addToManifest(const Frame& frame, bool success);
+
+    /// \brief Append a written file to the images and the journal.
+    ///
+    /// Requires the manifest lock.
+    ///
+    /// \param uri The filename relative to the directory.
+    /// \param timestamp The epoch timestamp in integer microseconds.
+    void appendToManifest(const std::string& uri, int64_t timestamp);
+
+    /// \brief Save the json manifest with writeManifest().
+    ///
+    /// Requires the manifest lock.
+    ///
+    /// \returns true if the manifest was saved.
+    bool saveManifest();
+
+    /// \brief The output directory.
+    std::string _directory;
+
+    /// \brief The image file extension.
+    std::string _extension = DEFAULT_EXTENSION;
+
+    /// \brief The maximum number of queued frames.
+    std::size_t _queueSize = DEFAULT_QUEUE_SIZE;
+
+    /// \brief The policy when the queue is full.
+    OverflowPolicy _policy = OverflowPolicy::DROP;
+
+    /// \brief The number of written frames between manifest updates.
+    std::size_t _manifestInterval = DEFAULT_MANIFEST_INTERVAL;
+
+    /// \brief The last queued filename timestamp in milliseconds.
+    int64_t _lastMilliseconds = std::numeric_limits<int64_t>::min();
+
+    /// \brief The sequence number of the next queued frame.
+    uint64_t _nextQueuedSequence = 0;
+
+    /// \brief The queued frames.
+    std::deque<Frame> _queue;
+
+    /// \brief Recycled frames, reused to avoid reallocating pixels.
+    std::vector<Frame> _pool;
+
+    /// \brief The number of frames being encoded.
+    std::size_t _activeCount = 0;
+
+    /// \brief The number of frames dropped.
+    std::size_t _droppedCount = 0;
+
+    /// \brief The number of frames that failed to write.
+    std::size_t _failedCount = 0;
+
+    /// \brief True while recording.
+    bool _recording = false;
+
+    /// \brief The mutex protecting the queue, pool and counters.
+    mutable std::mutex _mutex;
+
+    /// \brief Signals the workers when frames are queued.
+    std::condition_variable _frameAvailable;
+
+    /// \brief Signals the producer when the queue has space.
+    std::condition_variable _spaceAvailable;
+
+    /// \brief The written images, in timestamp order.
+    TimestampedURIIndex _images;
+
+    /// \brief The sequence number of the next frame to add to the images.
+    uint64_t _nextFinishedSequence = 0;
+
+    /// \brief The frames finished before an earlier queued frame.
+    ///
+    /// This holds at most one frame per worker thread.
+    std::vector<FinishedFrame> _finishedFrames;
+
+    /// \brief The journal of written files.
+    std::ofstream _journal;
+
+    /// \brief The recorded frame width.
+    float _width = 0;
+
+    /// \brief The recorded frame height.
+    float _height = 0;
+
+    /// \brief The mutex protecting the written images, journal and manifest.
+    mutable std::mutex _manifestMutex;
+
+    /// \brief The encoding threads.
+    std::vector<std::thread> _threads;
+
+};
+
+
+} } // namespace ofx::Player
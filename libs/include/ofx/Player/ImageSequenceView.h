@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/ImageSequence.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief An edit list view of one or more image sequences.
+///
+/// A view is an ordered list of segments. Each segment is a range of frames
+/// from an ImageSequence that may be played forward or reversed and stretched
+/// in time. The sequences are shared, not copied, so views of the same
+/// sequence share its images and its pixel and texture caches.
+///
+/// Segments are laid end to end on the view timeline. Each segment keeps the
+/// relative timing of its frames and lasts for one mean frame interval after
+/// its last frame, so the last frame of a segment is shown before the next
+/// segment begins. The interval is taken from the whole sequence, so slices
+/// of a sequence keep its frame rate. The whole view may then be offset and
+/// scaled in time.
+///
+/// Mapping a view index to its sequence and frame is O(log segments).
+///
+/// The sequences must keep at least the frames referenced by the segments
+/// while they are part of the view. Segments are clamped to their sequences
+/// whenever the view is changed, and segments left empty are removed.
+/// Segments are also checked against their sequences when accessed, so a
+/// sequence that loses frames between changes reports errors rather than
+/// reading out of range. Frames appended to a sequence later are not part of
+/// the view.
+class ImageSequenceView: public BaseTimeIndexed
+{
+public:
+    /// \brief A range of frames from a single sequence.
+    struct Segment
+    {
+        /// \brief The sequence.
+        std::shared_ptr<ImageSequence> sequence;
+
+        /// \brief The first frame index in the sequence.
+        std::size_t begin = 0;
+
+        /// \brief One past the last frame index in the sequence.
+        std::size_t end = 0;
+
+        /// \brief True if the frames are played from end to begin.
+        bool reversed = false;
+
+        /// \brief The time scale of the segment. 2 plays at half speed.
+        double scale = 1;
+    };
+
+    /// \brief Create an empty ImageSequenceView.
+    ImageSequenceView();
+
+    /// \brief Create an ImageSequenceView of a whole sequence.
+    /// \param sequence The sequence.
+    ImageSequenceView(std::shared_ptr<ImageSequence> sequence);
+
+    /// \brief Create an ImageSequenceView of the frames [begin, end) of a sequence.
+    /// \param sequence The sequence.
+    /// \param begin The first frame index.
+    /// \param end One past the last frame index.
+    ImageSequenceView(std::shared_ptr<ImageSequence> sequence,
+                      std::size_t begin,
+                      std::size_t end);
+
+    /// \brief Destroy the ImageSequenceView.
+    virtual ~ImageSequenceView();
+
+    /// \brief Append a whole sequence.
+    /// \param sequence The sequence.
+    /// \returns true if the sequence was appended.
+    bool append(std::shared_ptr<ImageSequence> sequence);
+
+    /// \brief Append the frames [begin, end) of a sequence.
+    /// \param sequence The sequence.
+    /// \param begin The first frame index.
+    /// \param end One past the last frame index.
+    /// \param reversed True if the frames are played from end to begin.
+    /// \param scale The time scale of the frames. 2 plays at half speed.
+    /// \returns true if the frames were appended.
+    bool append(std::shared_ptr<ImageSequence> sequence,
+                std::size_t begin,
+                std::size_t end,
+                bool reversed = false,
+                double scale = 1);
+
+    /// \brief Append the segments of another view.
+    ///
+    /// The time scale of the other view is applied to its segments. Its time
+    /// offset is not, since the segments are laid end to end.
+    ///
+    /// \param view The view to append.
+    /// \returns true if any segments were appended.
+    bool append(const ImageSequenceView& view);
+
+    /// \brief Remove all segments.
+    void clear();
+
+    /// \brief Reverse the order of the frames in the view.
+    void reverse();
+
+    /// \brief Get the frames [begin, end) of this view as a new view.
+    ///
+    /// The slice keeps the time offset and scale of this view, so its first
+    /// frame is shown at the time offset.
+    ///
+    /// \param begin The first view index.
+    /// \param end One past the last view index.
+    /// \returns the sliced view.
+    ImageSequenceView slice(std::size_t begin, std::size_t end) const;
+
+    enum
+    {
+        /// \brief The frame duration of single frame sequences in microseconds.
+        DEFAULT_FRAME_DURATION = 33333
+    };
+
+    /// \brief Set the time of the first frame of the view.
+    ///
+    /// Every frame is shown at or after the first frame, so a non-negative
+    /// offset keeps all view times non-negative.
+    ///
+    /// \param offset The time offset in microseconds. Must not be negative.
+    void setTimeOffset(int64_t offset);
+
+    /// \returns the time of the first frame of the view in microseconds.
+    int64_t getTimeOffset() const;
+
+    /// \brief Set the time scale of the whole view.
+    /// \param scale The time scale. 2 plays at half speed. Must be positive.
+    void setTimeScale(double scale);
+
+    /// \returns the time scale of the whole view.
+    double getTimeScale() const;
+
+    /// \returns the number of segments.
+    std::size_t segmentCount() const;
+
+    /// \param segment The segment index.
+    /// \returns the segment at the given index.
+    const Segment& segment(std::size_t segment) const;
+
+    /// \param index The view index.
+    /// \returns the index of the segment containing the view index.
+    std::size_t segmentForIndex(std::size_t index) const;
+
+    /// \param index The view index.
+    /// \returns the sequence of the frame at the given view index.
+    const std::shared_ptr<ImageSequence>& sequence(std::size_t index) const;
+
+    /// \param index The view index.
+    /// \returns the frame index within its sequence of the given view index.
+    std::size_t sourceIndex(std::size_t index) const;
+
+    double timeForIndex(std::size_t index) const override;
+
+    int64_t timeForIndexMicros(std::size_t index) const override;
+
+    std::size_t size() const override;
+
+    /// \returns the width of the first sequence or 0 if empty.
+    float getWidth() const;
+
+    /// \returns the height of the first sequence or 0 if empty.
+    float getHeight() const;
+
+    /// \brief Get the pixels of the frame at the given view index.
+    ///
+    /// Throws an exception if the index is out of range or the frame can not
+    /// be loaded.
+    ///
+    /// \param index The view index.
+    /// \returns the pixels from the sequence pixel cache.
+    const ofPixels& getPixels(std::size_t index) const;
+
+    /// \brief Get the texture of the frame at the given view index.
+    ///
+    /// Throws an exception if the index is out of range or the frame can not
+    /// be loaded.
+    ///
+    /// \param index The view index.
+    /// \returns the texture from the sequence texture cache.
+    const ofTexture& getTexture(std::size_t index) const;
+
+    /// \brief Begin fetching the frames following the given view index.
+    ///
+    /// Frames are fetched from the sequence of the current segment in the
+    /// playing direction of the view.
+    ///
+    /// \param index The current view index.
+    /// \param increasing True if the view index is increasing.
+    void prefetch(std::size_t index, bool increasing);
+
+private:
+    /// \brief Clamp the segments to their sequences and recompute the
+    /// segment index and time offsets.
+    void rebuild();
+
+    /// \param segment The segment.
+    /// \returns true if the segment frames lie within its sequence.
+    static bool isSegmentInRange(const Segment& segment);
+
+    /// \param segment The segment.
+    /// \returns true if the segment references valid frames.
+    static bool isValidSegment(const Segment& segment);
+
+    /// \brief The segments.
+    std::vector<Segment> _segments;
+
+    /// \brief The first view index of each segment followed by the size.
+    std::vector<std::size_t> _segmentIndexes;
+
+    /// \brief The unscaled start time of each segment in microseconds.
+    std::vector<int64_t> _segmentTimes;
+
+    /// \brief The time of the first frame of the view in microseconds.
+    int64_t _timeOffset = 0;
+
+    /// \brief The time scale of the whole view.
+    double _timeScale = 1;
+
+};
+
+
+} } // namespace ofx::Player
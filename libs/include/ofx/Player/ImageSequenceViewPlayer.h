@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofTexture.h"
+#include "ofPixels.h"
+#include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/ImageSequenceView.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A player for an ImageSequenceView.
+///
+/// Frames are loaded through the caches of the viewed sequences, so several
+/// players of views over the same sequence share decoded frames.
+class ImageSequenceViewPlayer: public BasePlayer
+{
+public:
+    /// \brief Create an ImageSequenceViewPlayer.
+    ImageSequenceViewPlayer();
+
+    /// \brief Create an ImageSequenceViewPlayer with the given view.
+    /// \param data The view to play.
+    ImageSequenceViewPlayer(std::shared_ptr<ImageSequenceView> data);
+
+    /// \brief Destroy the ImageSequenceViewPlayer.
+    virtual ~ImageSequenceViewPlayer();
+
+    /// \brief Update the player and prefetch upcoming frames.
+    /// \param elapsedRealTime The elapsed real time in microseconds.
+    void update(double elapsedRealTime) override;
+
+    using BasePlayer::update;
+
+    bool load(std::shared_ptr<ImageSequenceView> data);
+
+    void close();
+
+    bool isFrameNew() const;
+
+    float getWidth() const;
+
+    float getHeight() const;
+
+    const ofPixels& getPixels() const;
+
+    const ofTexture& getTexture() const;
+
+protected:
+    const BaseTimeIndexed* indexedData() const override;
+
+    /// \brief The view to play.
+    std::shared_ptr<ImageSequenceView> _data;
+
+};
+
+
+} } // namespace ofx::Player
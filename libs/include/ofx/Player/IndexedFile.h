@@ -14,6 +14,7 @@
 #include "ofx/IO/RegexPathFilter.h"
 #include "ofx/Player/AbstractPlayerTypes.h"
 #include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/PlayerUtils.h"
 
 
 namespace ofx {
@@ -36,6 +37,28 @@ public:
     virtual bool createTimestamp(const std::string& uri,
                                  double& timestamp) const = 0;
 
+    /// \brief Determine a resource's timestamp in integer microseconds.
+    ///
+    /// Timestampers that produce integer timestamps should override this to
+    /// return them exactly. By default the double timestamp is rounded.
+    ///
+    /// \param uri The URI of the resource to analyze.
+    /// \param timestamp The timestamp in integer microseconds.
+    /// \returns true if the timestamp generation was successful.
+    virtual bool createTimestampMicros(const std::string& uri,
+                                       int64_t& timestamp) const
+    {
+        double value = 0;
+
+        if (createTimestamp(uri, value))
+        {
+            timestamp = TimeUtils::roundMicros(value);
+            return true;
+        }
+
+        return false;
+    }
+
 };
 
 
@@ -45,10 +68,10 @@ class TimestampedURI: public AbstractTimestamped
 public:
     /// \brief Create a timestamped resource.
     /// \param uri The URI to timestamp.
-    /// \param timestamp The timestamp in microseconds.
-    TimestampedURI(const std::string& uri, double timestamp):
-        _uri(uri),
-        _timestamp(timestamp)
+    /// \param timestamp The timestamp in integer microseconds.
+    TimestampedURI(const std::string& uri, int64_t timestamp):
+        _timestamp(timestamp),
+        _uri(uri)
     {
     }
 
@@ -58,6 +81,11 @@ public:
     }
 
     virtual double timestamp() const override
+    {
+        return static_cast<double>(_timestamp);
+    }
+
+    virtual int64_t timestampMicros() const override
     {
         return _timestamp;
     }
@@ -69,8 +97,8 @@ public:
     }
 
 private:
-    /// \brief The timestamp in microseconds.
-    double _timestamp = 0;
+    /// \brief The timestamp in integer microseconds.
+    int64_t _timestamp = 0;
 
     /// \brief The URI.
     std::string _uri;
@@ -128,6 +156,20 @@ public:
 
     virtual bool createTimestamp(const std::string& uri,
                                  double& timestamp) const override
+    {
+        int64_t value = 0;
+
+        if (createTimestampMicros(uri, value))
+        {
+            timestamp = static_cast<double>(value);
+            return true;
+        }
+
+        return false;
+    }
+
+    virtual bool createTimestampMicros(const std::string& uri,
+                                       int64_t& timestamp) const override
     {
         // Note, we might do this with std::get_time or similar, but this std-
         // based approach does not easily support fractional seconds, so for
@@ -146,7 +188,7 @@ public:
         }
         else
         {
-            ofLogError("FilenameTimestamper::createTimestamp") << "Unable to parse time: " << ofFilePath::getBaseName(uri) << " with " <<_timestampFormat;
+            ofLogError("FilenameTimestamper::createTimestampMicros") << "Unable to parse time: " << ofFilePath::getBaseName(uri) << " with " <<_timestampFormat;
             return false;
         }
     }
@@ -246,9 +288,9 @@ public:
 
         for (auto& file : files)
         {
-            double timestamp = 0;
+            int64_t timestamp = 0;
 
-            if (stamper.createTimestamp(file, timestamp))
+            if (stamper.createTimestampMicros(file, timestamp))
             {
                 resources.push_back(TimestampedURI(file, timestamp));
             }
@@ -264,7 +306,7 @@ public:
                   [](const TimestampedURI& lhs,
                      const TimestampedURI& rhs)
                   {
-                      return lhs.timestamp() < rhs.timestamp();
+                      return lhs.timestampMicros() < rhs.timestampMicros();
                   });
 
         return true;
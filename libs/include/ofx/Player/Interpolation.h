@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "glm/common.hpp"
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "ofx/Player/BasePlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Interpolate between two values.
+///
+/// The default Interpolator linearly interpolates any type that supports
+/// `a + (b - a) * t`, which includes all arithmetic types. Specialize this
+/// class to interpolate other types.
+///
+/// \tparam ValueType The value type to interpolate.
+template<typename ValueType>
+class Interpolator
+{
+public:
+    /// \brief Interpolate between two values.
+    /// \param a The value at t = 0.
+    /// \param b The value at t = 1.
+    /// \param t The normalized interpolation weight in the range [0, 1].
+    /// \returns the interpolated value.
+    static ValueType interpolate(const ValueType& a, const ValueType& b, double t)
+    {
+        return static_cast<ValueType>(a + (b - a) * t);
+    }
+
+};
+
+
+/// \brief Linearly interpolate a glm::vec2.
+template<>
+class Interpolator<glm::vec2>
+{
+public:
+    static glm::vec2 interpolate(const glm::vec2& a, const glm::vec2& b, double t)
+    {
+        return glm::mix(a, b, static_cast<float>(t));
+    }
+
+};
+
+
+/// \brief Linearly interpolate a glm::vec3.
+template<>
+class Interpolator<glm::vec3>
+{
+public:
+    static glm::vec3 interpolate(const glm::vec3& a, const glm::vec3& b, double t)
+    {
+        return glm::mix(a, b, static_cast<float>(t));
+    }
+
+};
+
+
+/// \brief Linearly interpolate a glm::vec4.
+template<>
+class Interpolator<glm::vec4>
+{
+public:
+    static glm::vec4 interpolate(const glm::vec4& a, const glm::vec4& b, double t)
+    {
+        return glm::mix(a, b, static_cast<float>(t));
+    }
+
+};
+
+
+/// \brief Spherically interpolate a glm::quat.
+template<>
+class Interpolator<glm::quat>
+{
+public:
+    static glm::quat interpolate(const glm::quat& a, const glm::quat& b, double t)
+    {
+        return glm::slerp(a, b, static_cast<float>(t));
+    }
+
+};
+
+
+/// \brief A playable buffer handle that samples interpolated values.
+///
+/// In addition to the static ::timestamp function required by
+/// PlayableBufferHandle, the AdapterType must have a static function called
+/// ::value that takes a piece of data in the buffer container and returns the
+/// value to interpolate.
+///
+/// Times before the first or after the last timestamp return the first or
+/// last value respectively.
+///
+/// \tparam BufferType The buffer with the playable data.
+/// \tparam AdapterType The adapter type.
+/// \tparam ValueType The interpolated value type.
+/// \tparam InterpolatorType The interpolator for the value type.
+template<typename BufferType,
+         typename AdapterType,
+         typename ValueType = typename std::decay<decltype(AdapterType::value(std::declval<const BufferType&>()[0]))>::type,
+         typename InterpolatorType = Interpolator<ValueType>>
+class InterpolatedBufferHandle: public PlayableBufferHandle<BufferType, AdapterType>
+{
+public:
+    /// \brief Create an InterpolatedBufferHandle with the given \p buffer.
+    /// \param buffer The buffer to create a handle for.
+    InterpolatedBufferHandle(BufferType& buffer):
+        PlayableBufferHandle<BufferType, AdapterType>(buffer)
+    {
+    }
+
+    /// \brief Destroy the InterpolatedBufferHandle.
+    virtual ~InterpolatedBufferHandle()
+    {
+    }
+
+    /// \brief Get the value at the given index.
+    /// \param index The index of the value.
+    /// \returns the value at the given index.
+    ValueType valueForIndex(std::size_t index) const
+    {
+        return AdapterType::value(this->buffer()[index]);
+    }
+
+    /// \brief Sample the interpolated value at the given time.
+    ///
+    /// During playback, pass the player's current frame index as the hint to
+    /// make the search nearly constant time.
+    ///
+    /// \param time The time to sample in microseconds.
+    /// \param indexHint The index to start the search from.
+    /// \returns the interpolated value, or a default value if empty.
+    ValueType sample(double time, std::size_t indexHint = 0) const
+    {
+        std::size_t count = this->size();
+
+        if (count == 0)
+        {
+            return ValueType();
+        }
+
+        std::size_t index = 0;
+        double weight = 0;
+        locate(time, count, indexHint, index, weight);
+
+        if (weight == 0)
+        {
+            return valueForIndex(index);
+        }
+
+        return InterpolatorType::interpolate(valueForIndex(index),
+                                             valueForIndex(index + 1),
+                                             weight);
+    }
+
+    /// \brief Sample interpolated values at many times.
+    ///
+    /// The times are processed in a single sweep where each search begins at
+    /// the previous result, so sorted times cost O(count + size()) in total.
+    /// Unsorted times are still sampled correctly, but more slowly.
+    ///
+    /// Each block of times is processed in two passes. The first pass locates
+    /// the neighboring values and weights. The second pass interpolates them
+    /// in a tight loop that the compiler can vectorize for arithmetic types.
+    ///
+    /// \param times The times to sample in microseconds.
+    /// \param count The number of times to sample.
+    /// \param values The output values, with space for at least count values.
+    void sample(const double* times, std::size_t count, ValueType* values) const
+    {
+        std::size_t size = this->size();
+
+        if (size == 0)
+        {
+            std::fill(values, values + count, ValueType());
+            return;
+        }
+
+        ValueType a[BLOCK_SIZE];
+        ValueType b[BLOCK_SIZE];
+        double weights[BLOCK_SIZE];
+
+        std::size_t index = 0;
+
+        for (std::size_t first = 0; first < count; first += BLOCK_SIZE)
+        {
+            std::size_t blockSize = std::min(count - first, std::size_t(BLOCK_SIZE));
+
+            for (std::size_t i = 0; i < blockSize; ++i)
+            {
+                locate(times[first + i], size, index, index, weights[i]);
+                a[i] = valueForIndex(index);
+                b[i] = weights[i] == 0 ? a[i] : valueForIndex(index + 1);
+            }
+
+            ValueType* output = values + first;
+
+            for (std::size_t i = 0; i < blockSize; ++i)
+            {
+                output[i] = InterpolatorType::interpolate(a[i], b[i], weights[i]);
+            }
+        }
+    }
+
+    /// \brief Sample interpolated values at many times.
+    /// \param times The times to sample in microseconds.
+    /// \param values The output values, resized to match the times.
+    void sample(const std::vector<double>& times, std::vector<ValueType>& values) const
+    {
+        values.resize(times.size());
+        sample(times.data(), times.size(), values.data());
+    }
+
+    enum
+    {
+        /// \brief The number of times located before each interpolation pass.
+        BLOCK_SIZE = 64
+    };
+
+private:
+    /// \brief Locate the values surrounding a time.
+    ///
+    /// When the weight is zero, only the value at the index is needed.
+    ///
+    /// \param time The time to locate in microseconds.
+    /// \param count The number of values, which must be greater than zero.
+    /// \param indexHint The index to start the search from.
+    /// \param index The index of the value at or before the time.
+    /// \param weight The normalized weight toward the following value.
+    void locate(double time,
+                std::size_t count,
+                std::size_t indexHint,
+                std::size_t& index,
+                double& weight) const
+    {
+        if (time <= this->timeForIndex(0))
+        {
+            index = 0;
+            weight = 0;
+        }
+        else if (time >= this->timeForIndex(count - 1))
+        {
+            index = count - 1;
+            weight = 0;
+        }
+        else
+        {
+            // The first timestamp > time is in [1, count - 1].
+            std::size_t next = this->upperBound(time, std::min(indexHint, count - 1));
+            double nextTime = this->timeForIndex(next);
+            double time0 = this->timeForIndex(next - 1);
+            index = next - 1;
+            weight = (time - time0) / (nextTime - time0);
+        }
+    }
+
+};
+
+
+} } // namespace ofx::Player
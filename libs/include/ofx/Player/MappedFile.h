@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofConstants.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A read-only memory mapped file.
+///
+/// Mapping a file reserves address space without reading it. Pages are read
+/// by the operating system when they are first touched, so only the parts of
+/// the file that are actually accessed are loaded into memory.
+class MappedFile
+{
+public:
+    /// \brief Create an unopened MappedFile.
+    MappedFile();
+
+    /// \brief Create a MappedFile and map the given file.
+    /// \param filename The file to map.
+    MappedFile(const std::string& filename);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    /// \brief Destroy the MappedFile, unmapping the file.
+    ~MappedFile();
+
+    /// \brief Map the given file.
+    ///
+    /// Any previously mapped file is unmapped.
+    ///
+    /// \param filename The file to map.
+    /// \returns true if the file was mapped successfully.
+    bool open(const std::string& filename);
+
+    /// \brief Unmap the file.
+    void close();
+
+    /// \returns true if a file is mapped.
+    bool isOpen() const;
+
+    /// \returns a pointer to the mapped data or nullptr if not mapped.
+    const uint8_t* data() const;
+
+    /// \returns the size of the mapped data in bytes.
+    std::size_t size() const;
+
+private:
+    /// \brief The mapped data.
+    const uint8_t* _data = nullptr;
+
+    /// \brief The size of the mapped data.
+    std::size_t _size = 0;
+
+#if defined(TARGET_WIN32)
+    /// \brief The file handle.
+    void* _file = nullptr;
+
+    /// \brief The file mapping handle.
+    void* _mapping = nullptr;
+#endif
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Player/BasePlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A merged, time ordered view of several time indexed sources.
+///
+/// The sources are not copied. Instead, a merge index is precomputed with a
+/// k-way heap merge. Each merged entry stores its source, its index in that
+/// source and its timestamp. Timestamps are kept in a contiguous column, so
+/// seeking uses the fast batch and hinted searches and forward or reverse
+/// iteration is simply stepping the merged index.
+///
+/// Entries with equal timestamps are ordered by source.
+///
+/// The sources must remain valid and sorted while they are part of the view.
+/// When sources grow, call update() to merge the new entries.
+class MergedTimeIndexed: public BaseTimeIndexed
+{
+public:
+    /// \brief A single merged entry.
+    struct Entry
+    {
+        /// \brief The index of the source.
+        std::size_t source;
+
+        /// \brief The index of the entry within its source.
+        std::size_t index;
+    };
+
+    /// \brief Create an empty MergedTimeIndexed.
+    MergedTimeIndexed();
+
+    /// \brief Create a MergedTimeIndexed with the given sources.
+    ///
+    /// Sources that are nullptr are skipped.
+    ///
+    /// \param sources The sources to merge.
+    MergedTimeIndexed(const std::vector<std::shared_ptr<const AbstractTimeIndexed>>& sources);
+
+    /// \brief Destroy the MergedTimeIndexed.
+    virtual ~MergedTimeIndexed();
+
+    /// \brief Add a source and rebuild the merge index.
+    /// \param source The source to add.
+    /// \returns the index of the added source.
+    std::size_t addSource(std::shared_ptr<const AbstractTimeIndexed> source);
+
+    /// \brief Remove all sources.
+    void clear();
+
+    /// \returns the number of sources.
+    std::size_t sourceCount() const;
+
+    /// \param source The index of the source.
+    /// \returns the source at the given index.
+    std::shared_ptr<const AbstractTimeIndexed> getSource(std::size_t source) const;
+
+    /// \brief Merge entries appended to the sources since the last merge.
+    ///
+    /// The merge index is truncated before the earliest new entry, in time
+    /// and source order, and only the truncated tail is merged again with the
+    /// new entries. New entries that follow the last merged entry are simply
+    /// appended. If a source shrank, the merge index is rebuilt.
+    ///
+    /// \returns true if any entries were merged.
+    bool update();
+
+    /// \brief Rebuild the merge index from scratch.
+    void rebuild();
+
+    double timeForIndex(std::size_t index) const override;
+
+    std::size_t size() const override;
+
+    const double* timestampData() const override;
+
+    /// \param index The merged index.
+    /// \returns the merged entry at the given index.
+    const Entry& operator [] (std::size_t index) const;
+
+    /// \param index The merged index.
+    /// \returns the source of the merged entry at the given index.
+    std::size_t source(std::size_t index) const;
+
+    /// \param index The merged index.
+    /// \returns the index within its source of the entry at the given index.
+    std::size_t sourceIndex(std::size_t index) const;
+
+private:
+    /// \brief Merge the source entries after the merged counts.
+    void merge();
+
+    /// \brief The sources.
+    std::vector<std::shared_ptr<const AbstractTimeIndexed>> _sources;
+
+    /// \brief The number of entries merged from each source.
+    std::vector<std::size_t> _mergedCounts;
+
+    /// \brief The merged entries.
+    std::vector<Entry> _entries;
+
+    /// \brief The merged timestamps.
+    std::vector<double> _timestamps;
+
+};
+
+
+} } // namespace ofx::Player
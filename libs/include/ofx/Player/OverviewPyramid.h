@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Player/BasePlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A multi-resolution min / max / mean summary of a time indexed track.
+///
+/// Samples are grouped into fixed size blocks and each block is summarized.
+/// Each higher level summarizes pairs of nodes from the level below, so the
+/// summary of any index range is built from the raw samples at its edges and
+/// O(log n) precomputed nodes. This makes it cheap to draw a scrub bar or
+/// waveform of a very long track at any zoom level.
+///
+/// The pyramid does not copy the samples. Values are read through the value
+/// accessor, which is called with a sample index.
+///
+/// The track must be sorted and must remain valid while the pyramid is used.
+/// When samples are appended, call update() to summarize the new samples. If
+/// existing samples change, call rebuild().
+class OverviewPyramid
+{
+public:
+    /// \brief A function returning the value at a sample index.
+    typedef std::function<double(std::size_t index)> ValueAccessor;
+
+    /// \brief A summary of a range of samples.
+    struct Summary
+    {
+        /// \brief The minimum value.
+        double min = std::numeric_limits<double>::max();
+
+        /// \brief The maximum value.
+        double max = std::numeric_limits<double>::lowest();
+
+        /// \brief The sum of the values.
+        double sum = 0;
+
+        /// \brief The number of values.
+        std::size_t count = 0;
+
+        /// \returns the mean value, or 0 if the summary is empty.
+        double mean() const
+        {
+            return count > 0 ? sum / count : 0;
+        }
+
+        /// \returns true if the summary has no values.
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        /// \brief Add a single value to the summary.
+        /// \param value The value to add.
+        void add(double value)
+        {
+            min = std::min(min, value);
+            max = std::max(max, value);
+            sum += value;
+            ++count;
+        }
+
+        /// \brief Add another summary to this summary.
+        /// \param summary The summary to add.
+        void add(const Summary& summary)
+        {
+            min = std::min(min, summary.min);
+            max = std::max(max, summary.max);
+            sum += summary.sum;
+            count += summary.count;
+        }
+    };
+
+    enum
+    {
+        /// \brief The default number of samples summarized by each block.
+        DEFAULT_BLOCK_SIZE = 32
+    };
+
+    /// \brief Create an OverviewPyramid and summarize all samples.
+    /// \param indexed The time indexed track.
+    /// \param value The value accessor.
+    /// \param blockSize The number of samples summarized by each block.
+    OverviewPyramid(const BaseTimeIndexed& indexed,
+                    ValueAccessor value,
+                    std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    /// \brief Destroy the OverviewPyramid.
+    virtual ~OverviewPyramid();
+
+    /// \brief Summarize samples appended since the last update.
+    ///
+    /// Only the blocks containing new samples and their parents are updated.
+    /// If the track became smaller, the pyramid is rebuilt.
+    ///
+    /// \returns true if any samples were summarized.
+    bool update();
+
+    /// \brief Rebuild the pyramid from scratch.
+    void rebuild();
+
+    /// \brief Summarize a range of samples.
+    /// \param firstIndex The first sample index.
+    /// \param lastIndex One past the last sample index.
+    /// \returns the summary of the samples in [firstIndex, lastIndex).
+    Summary summary(std::size_t firstIndex, std::size_t lastIndex) const;
+
+    /// \brief Summarize a time range in equally spaced buckets.
+    ///
+    /// Bucket i summarizes the samples with timestamps in
+    /// [startTime + i * step, startTime + (i + 1) * step), where
+    /// step = (endTime - startTime) / bucketCount. The last bucket also
+    /// includes samples at endTime. Buckets without samples are empty.
+    ///
+    /// \param startTime The start time in microseconds.
+    /// \param endTime The end time in microseconds.
+    /// \param bucketCount The number of buckets.
+    /// \param summaries The output, with room for bucketCount summaries.
+    void summaries(double startTime,
+                   double endTime,
+                   std::size_t bucketCount,
+                   Summary* summaries) const;
+
+    /// \brief Summarize a time range in equally spaced buckets.
+    /// \param startTime The start time in microseconds.
+    /// \param endTime The end time in microseconds.
+    /// \param bucketCount The number of buckets.
+    /// \returns the bucket summaries.
+    std::vector<Summary> summaries(double startTime,
+                                   double endTime,
+                                   std::size_t bucketCount) const;
+
+    /// \returns the summary of all summarized samples.
+    Summary summary() const;
+
+    /// \returns the number of summarized samples.
+    std::size_t size() const;
+
+    /// \returns the number of samples summarized by each block.
+    std::size_t blockSize() const;
+
+    /// \returns the number of levels.
+    std::size_t levelCount() const;
+
+private:
+    /// \brief Summarize raw samples.
+    /// \param summary The summary to add to.
+    /// \param firstIndex The first sample index.
+    /// \param lastIndex One past the last sample index.
+    void addSamples(Summary& summary,
+                    std::size_t firstIndex,
+                    std::size_t lastIndex) const;
+
+    /// \brief The time indexed track.
+    const BaseTimeIndexed& _indexed;
+
+    /// \brief The value accessor.
+    ValueAccessor _value;
+
+    /// \brief The number of samples summarized by each block.
+    std::size_t _blockSize = DEFAULT_BLOCK_SIZE;
+
+    /// \brief The number of summarized samples.
+    std::size_t _size = 0;
+
+    /// \brief The summary levels, starting with the block level.
+    std::vector<std::vector<Summary>> _levels;
+
+};
+
+
+} } // namespace ofx::Player
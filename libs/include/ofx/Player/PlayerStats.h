@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A lock-free latency histogram with power of two buckets.
+///
+/// Bucket 0 counts latencies below 1 microsecond and bucket i counts
+/// latencies in [2^(i-1), 2^i) microseconds. Recording a latency is a few
+/// relaxed atomic operations, so it can be used from any thread.
+class LatencyHistogram
+{
+public:
+    enum
+    {
+        /// \brief The number of buckets, covering up to about 35 minutes.
+        BUCKET_COUNT = 32
+    };
+
+    /// \brief A copy of a histogram at a point in time.
+    struct Snapshot
+    {
+        /// \brief The number of latencies in each bucket.
+        std::array<uint64_t, BUCKET_COUNT> buckets = {};
+
+        /// \brief The number of recorded latencies.
+        uint64_t count = 0;
+
+        /// \brief The sum of the recorded latencies in microseconds.
+        uint64_t sum = 0;
+
+        /// \brief The maximum recorded latency in microseconds.
+        uint64_t max = 0;
+
+        /// \returns the mean latency in microseconds.
+        double mean() const;
+
+        /// \brief Estimate a percentile.
+        /// \param percentile The percentile in [0, 1].
+        /// \returns the upper bound of the bucket containing the percentile in
+        ///          microseconds, limited to the maximum.
+        double percentile(double percentile) const;
+    };
+
+    /// \brief Create an empty LatencyHistogram.
+    LatencyHistogram();
+
+    /// \brief Record a latency.
+    /// \param micros The latency in microseconds.
+    void add(double micros);
+
+    /// \returns a snapshot of the histogram.
+    Snapshot snapshot() const;
+
+    /// \brief Remove all recorded latencies.
+    void reset();
+
+    /// \param micros The latency in microseconds.
+    /// \returns the bucket for the latency.
+    static std::size_t bucketForLatency(uint64_t micros);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets;
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _max;
+
+};
+
+
+/// \brief Cache statistics.
+struct CacheStats
+{
+    /// \brief The number of lookups that found a cached value.
+    uint64_t hits = 0;
+
+    /// \brief The number of lookups that did not find a cached value.
+    uint64_t misses = 0;
+
+    /// \brief The number of values added to the cache.
+    uint64_t inserts = 0;
+
+    /// \brief The number of values evicted to make room for new values.
+    uint64_t evictions = 0;
+
+    /// \returns the fraction of lookups that were hits.
+    double hitRate() const
+    {
+        return (hits + misses) > 0 ? double(hits) / (hits + misses) : 0;
+    }
+};
+
+
+/// \brief Lock-free counters for a fixed capacity LRU cache.
+///
+/// The cache does not report evictions, so they are derived from the number
+/// of inserts since the cache was last emptied and its capacity.
+class CacheCounters
+{
+public:
+    /// \brief Create zeroed CacheCounters.
+    CacheCounters();
+
+    /// \brief Record a cache hit.
+    void hit()
+    {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// \brief Record a cache miss.
+    void miss()
+    {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// \brief Record a cache insert.
+    void insert()
+    {
+        _inserts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// \brief Record that the cache was emptied.
+    /// \param capacity The capacity of the cache before it was emptied.
+    void emptied(std::size_t capacity);
+
+    /// \param capacity The current capacity of the cache.
+    /// \returns the cache statistics.
+    CacheStats stats(std::size_t capacity) const;
+
+    /// \brief Reset all counters.
+    void reset();
+
+private:
+    /// \param capacity The capacity of the cache.
+    /// \returns the evictions since the cache was last emptied.
+    uint64_t currentEvictions(std::size_t capacity) const;
+
+    std::atomic<uint64_t> _hits;
+    std::atomic<uint64_t> _misses;
+    std::atomic<uint64_t> _inserts;
+
+    /// \brief The number of inserts when the cache was last emptied.
+    std::atomic<uint64_t> _insertsWhenEmptied;
+
+    /// \brief The evictions before the cache was last emptied.
+    std::atomic<uint64_t> _evictionsWhenEmptied;
+
+};
+
+
+/// \brief A snapshot of player statistics.
+struct PlayerStats
+{
+    /// \brief The number of updates.
+    uint64_t updates = 0;
+
+    /// \brief The number of frames crossed by the playhead.
+    uint64_t framesIntended = 0;
+
+    /// \brief The number of new frames shown.
+    uint64_t framesShown = 0;
+
+    /// \brief The number of intended frames that were never shown.
+    ///
+    /// Only one frame can be shown per update, so the others are dropped.
+    uint64_t framesDropped = 0;
+
+    /// \brief The number of frames crossed during the last update.
+    uint64_t lastFramesIntended = 0;
+
+    /// \brief The number of new frames shown during the last update.
+    uint64_t lastFramesShown = 0;
+
+    /// \brief The number of frames dropped during the last update.
+    uint64_t lastFramesDropped = 0;
+
+    /// \brief The maximum number of frames dropped during an update.
+    uint64_t maxFramesDropped = 0;
+
+    /// \brief The presentation error of the last update in microseconds.
+    ///
+    /// This is the shown frame's timestamp minus the playhead time.
+    double lastPresentationError = 0;
+
+    /// \brief The update durations.
+    LatencyHistogram::Snapshot updateDuration;
+
+    /// \brief The absolute presentation errors.
+    LatencyHistogram::Snapshot presentationError;
+};
+
+
+/// \brief A snapshot of image sequence statistics.
+struct ImageSequenceStats
+{
+    /// \brief The pixel cache statistics.
+    CacheStats pixelCache;
+
+    /// \brief The texture cache statistics.
+    CacheStats textureCache;
+
+    /// \brief The number of frames whose bytes were fetched by readahead.
+    uint64_t readaheadHits = 0;
+
+    /// \brief The number of encoded bytes read.
+    uint64_t bytesRead = 0;
+
+    /// \brief The blocking file read latencies.
+    LatencyHistogram::Snapshot readLatency;
+
+    /// \brief The image decode latencies.
+    LatencyHistogram::Snapshot decodeLatency;
+
+    /// \brief The texture upload latencies.
+    LatencyHistogram::Snapshot uploadLatency;
+};
+
+
+} } // namespace ofx::Player
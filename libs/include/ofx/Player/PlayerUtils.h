@@ -8,6 +8,7 @@
 #pragma once
 
 
+#include <cmath>
 #include "ofBaseTypes.h"
 
 
@@ -40,4 +41,436 @@ namespace ofx {
 namespace Player {
 
 
+/// \brief A collection of utilities for integer microsecond times.
+///
+/// Timestamps are integer microseconds. A double time between two integer
+/// timestamps can be compared with them exactly by rounding it toward the
+/// side of the comparison: `timestamp <= time` is equivalent to
+/// `timestamp <= floorMicros(time)` and `timestamp >= time` is equivalent to
+/// `timestamp >= ceilMicros(time)`.
+class TimeUtils
+{
+public:
+    // These are used in the search and update paths, so they truncate and
+    // adjust rather than calling the library rounding functions.
+
+    /// \param time The time in microseconds.
+    /// \returns the largest integer microsecond time <= time.
+    static int64_t floorMicros(double time)
+    {
+        int64_t result = static_cast<int64_t>(time);
+        return result - (time < static_cast<double>(result) ? 1 : 0);
+    }
+
+    /// \param time The time in microseconds.
+    /// \returns the smallest integer microsecond time >= time.
+    static int64_t ceilMicros(double time)
+    {
+        int64_t result = static_cast<int64_t>(time);
+        return result + (time > static_cast<double>(result) ? 1 : 0);
+    }
+
+    /// \param time The time in microseconds.
+    /// \returns the nearest integer microsecond time, rounding halfway
+    ///          times away from zero.
+    static int64_t roundMicros(double time)
+    {
+        return static_cast<int64_t>(time < 0 ? time - 0.5 : time + 0.5);
+    }
+
+};
+
+
+/// \brief A collection of search utilities for sorted timestamps.
+///
+/// The TimeAccessor is any callable that takes an index and returns the
+/// timestamp at that index. Timestamps must be sorted in non-decreasing order.
+/// Searched times may be double or integer microseconds. Integer timestamps
+/// searched with integer times are compared exactly and without conversions.
+///
+/// The hinted searches gallop outward from the hint, so their cost is
+/// O(log d), where d is the distance between the hint and the result. This
+/// makes sequential access nearly constant time while remaining O(log n) for
+/// random access.
+class SearchUtils
+{
+public:
+    /// \brief Find the first index in [first, last) with a timestamp > time.
+    /// \param timeForIndex The timestamp accessor.
+    /// \param first The first index to search.
+    /// \param last One past the last index to search.
+    /// \param time The time to search for.
+    /// \returns the first index with a timestamp > time, or last.
+    template<typename TimeAccessor, typename TimeType>
+    static std::size_t upperBound(const TimeAccessor& timeForIndex,
+                                  std::size_t first,
+                                  std::size_t last,
+                                  TimeType time)
+    {
+        std::size_t count = last - first;
+
+        while (count > 0)
+        {
+            std::size_t step = count / 2;
+            std::size_t middle = first + step;
+
+            if (!(time < timeForIndex(middle)))
+            {
+                first = middle + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        return first;
+    }
+
+    /// \brief Find the first index in [first, last) with a timestamp >= time.
+    /// \param timeForIndex The timestamp accessor.
+    /// \param first The first index to search.
+    /// \param last One past the last index to search.
+    /// \param time The time to search for.
+    /// \returns the first index with a timestamp >= time, or last.
+    template<typename TimeAccessor, typename TimeType>
+    static std::size_t lowerBound(const TimeAccessor& timeForIndex,
+                                  std::size_t first,
+                                  std::size_t last,
+                                  TimeType time)
+    {
+        std::size_t count = last - first;
+
+        while (count > 0)
+        {
+            std::size_t step = count / 2;
+            std::size_t middle = first + step;
+
+            if (timeForIndex(middle) < time)
+            {
+                first = middle + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        return first;
+    }
+
+    /// \brief Find the first index with a timestamp > time, starting at a hint.
+    /// \param timeForIndex The timestamp accessor.
+    /// \param size The number of timestamps.
+    /// \param time The time to search for.
+    /// \param indexHint The index to start the search from.
+    /// \returns the first index with a timestamp > time, or size.
+    template<typename TimeAccessor, typename TimeType>
+    static std::size_t upperBound(const TimeAccessor& timeForIndex,
+                                  std::size_t size,
+                                  TimeType time,
+                                  std::size_t indexHint)
+    {
+        return gallop(timeForIndex, size, indexHint, [time](decltype(timeForIndex(0)) timestamp) {
+            return !(time < timestamp);
+        });
+    }
+
+    /// \brief Find the first index with a timestamp >= time, starting at a hint.
+    /// \param timeForIndex The timestamp accessor.
+    /// \param size The number of timestamps.
+    /// \param time The time to search for.
+    /// \param indexHint The index to start the search from.
+    /// \returns the first index with a timestamp >= time, or size.
+    template<typename TimeAccessor, typename TimeType>
+    static std::size_t lowerBound(const TimeAccessor& timeForIndex,
+                                  std::size_t size,
+                                  TimeType time,
+                                  std::size_t indexHint)
+    {
+        return gallop(timeForIndex, size, indexHint, [time](decltype(timeForIndex(0)) timestamp) {
+            return timestamp < time;
+        });
+    }
+
+    /// \brief Find the index for a time.
+    ///
+    /// If increasing, this returns the index of the last timestamp <= time.
+    /// Otherwise, this returns the index of the first timestamp >= time.
+    /// Times outside of the timestamps are clamped to the first or last index.
+    ///
+    /// \param timeForIndex The timestamp accessor.
+    /// \param size The number of timestamps.
+    /// \param time The time to search for.
+    /// \param increasing True if the time is increasing.
+    /// \param indexHint The index to start the search from.
+    /// \returns the index for the given time.
+    template<typename TimeAccessor, typename TimeType>
+    static std::size_t indexForTime(const TimeAccessor& timeForIndex,
+                                    std::size_t size,
+                                    TimeType time,
+                                    bool increasing,
+                                    std::size_t indexHint)
+    {
+        if (size == 0 || time <= timeForIndex(0))
+        {
+            return 0;
+        }
+        else if (time >= timeForIndex(size - 1))
+        {
+            return size - 1;
+        }
+        else if (increasing)
+        {
+            return upperBound(timeForIndex, size, time, indexHint) - 1;
+        }
+        else
+        {
+            return lowerBound(timeForIndex, size, time, indexHint);
+        }
+    }
+
+    /// \brief Find the indexes for many times.
+    ///
+    /// Each search starts at the previous result, so times sorted in
+    /// increasing order are resolved in a single merge-style sweep.
+    ///
+    /// \param timeForIndex The timestamp accessor.
+    /// \param size The number of timestamps.
+    /// \param times The times to search for.
+    /// \param count The number of times.
+    /// \param increasing True if the time is increasing.
+    /// \param indexes The output indexes.
+    template<typename TimeAccessor, typename TimeType>
+    static void indexesForTimes(const TimeAccessor& timeForIndex,
+                                std::size_t size,
+                                const TimeType* times,
+                                std::size_t count,
+                                bool increasing,
+                                std::size_t* indexes)
+    {
+        std::size_t indexHint = 0;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            indexes[i] = indexForTime(timeForIndex, size, times[i], increasing, indexHint);
+            indexHint = indexes[i];
+        }
+    }
+
+    /// \brief Find the indexes for many times in a contiguous timestamp column.
+    ///
+    /// Short forward distances are covered by counting the timestamps before
+    /// the searched time in fixed size blocks. The count is branchless and
+    /// vectorizes well. Longer distances and backward steps fall back to a
+    /// galloping search.
+    ///
+    /// \param timestamps The sorted timestamp column.
+    /// \param size The number of timestamps.
+    /// \param times The times to search for.
+    /// \param count The number of times.
+    /// \param increasing True if the time is increasing.
+    /// \param indexes The output indexes.
+    template<typename TimestampType, typename TimeType>
+    static void indexesForTimesInColumn(const TimestampType* timestamps,
+                                        std::size_t size,
+                                        const TimeType* times,
+                                        std::size_t count,
+                                        bool increasing,
+                                        std::size_t* indexes)
+    {
+        if (size == 0)
+        {
+            std::fill(indexes, indexes + count, 0);
+            return;
+        }
+
+        TimestampType firstTime = timestamps[0];
+        TimestampType lastTime = timestamps[size - 1];
+
+        // The bound from the previous search.
+        std::size_t bound = 0;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            TimeType time = times[i];
+
+            if (time <= firstTime)
+            {
+                indexes[i] = 0;
+            }
+            else if (time >= lastTime)
+            {
+                indexes[i] = size - 1;
+            }
+            else if (increasing)
+            {
+                bound = scan(timestamps, size, bound, [time](TimestampType timestamp) {
+                    return timestamp <= time;
+                });
+
+                indexes[i] = bound - 1;
+            }
+            else
+            {
+                bound = scan(timestamps, size, bound, [time](TimestampType timestamp) {
+                    return timestamp < time;
+                });
+
+                indexes[i] = bound;
+            }
+        }
+    }
+
+    enum
+    {
+        /// \brief The number of timestamps counted per block in a column scan.
+        SCAN_BLOCK_SIZE = 8,
+
+        /// \brief The number of blocks scanned before galloping.
+        MAX_SCAN_BLOCKS = 4
+    };
+
+private:
+    /// \brief Find the first index in a column that is not before the value.
+    ///
+    /// The scan counts forward from the bound in blocks and gallops if the
+    /// result is behind the bound or farther than a few blocks ahead.
+    ///
+    /// \param timestamps The sorted timestamp column.
+    /// \param size The number of timestamps.
+    /// \param bound The index to start the scan from.
+    /// \param isBefore A predicate that is true for timestamps before the
+    ///        searched value.
+    /// \returns the first index for which isBefore is false, or size.
+    template<typename TimestampType, typename Predicate>
+    static std::size_t scan(const TimestampType* timestamps,
+                            std::size_t size,
+                            std::size_t bound,
+                            const Predicate& isBefore)
+    {
+        auto timeForIndex = [timestamps](std::size_t index) {
+            return timestamps[index];
+        };
+
+        // The searched value moved backward.
+        if (bound > 0 && !isBefore(timestamps[bound - 1]))
+        {
+            return gallop(timeForIndex, size, bound - 1, isBefore);
+        }
+
+        for (std::size_t block = 0; block < MAX_SCAN_BLOCKS; ++block)
+        {
+            if (bound + SCAN_BLOCK_SIZE > size)
+            {
+                break;
+            }
+
+            const TimestampType* first = timestamps + bound;
+            std::size_t before = 0;
+
+            for (std::size_t i = 0; i < SCAN_BLOCK_SIZE; ++i)
+            {
+                before += isBefore(first[i]) ? 1 : 0;
+            }
+
+            // Sorted timestamps before the value form a prefix of the block.
+            bound += before;
+
+            if (before < SCAN_BLOCK_SIZE)
+            {
+                return bound;
+            }
+        }
+
+        return gallop(timeForIndex, size, bound, isBefore);
+    }
+
+    /// \brief Find the first index that is not before the searched value.
+    ///
+    /// The search begins at the hint and gallops forward or backward in
+    /// exponentially increasing steps before finishing with a binary search.
+    ///
+    /// \param timeForIndex The timestamp accessor.
+    /// \param size The number of timestamps.
+    /// \param indexHint The index to start the search from.
+    /// \param isBefore A predicate that is true for timestamps before the
+    ///        searched value.
+    /// \returns the first index for which isBefore is false, or size.
+    template<typename TimeAccessor, typename Predicate>
+    static std::size_t gallop(const TimeAccessor& timeForIndex,
+                              std::size_t size,
+                              std::size_t indexHint,
+                              const Predicate& isBefore)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        std::size_t first = 0;
+        std::size_t last = size;
+
+        indexHint = std::min(indexHint, size - 1);
+
+        if (isBefore(timeForIndex(indexHint)))
+        {
+            // The result is in (indexHint, size].
+            std::size_t low = indexHint;
+            std::size_t step = 1;
+            std::size_t high = low + step;
+
+            while (high < size && isBefore(timeForIndex(high)))
+            {
+                low = high;
+                step *= 2;
+                high = low + step;
+            }
+
+            first = low + 1;
+            last = std::min(high, size);
+        }
+        else
+        {
+            // The result is in [0, indexHint].
+            std::size_t high = indexHint;
+            std::size_t step = 1;
+
+            while (high >= step && !isBefore(timeForIndex(high - step)))
+            {
+                high -= step;
+                step *= 2;
+            }
+
+            first = (high >= step) ? (high - step + 1) : 0;
+            last = high;
+        }
+
+        // Binary search the remaining range [first, last).
+        std::size_t count = last - first;
+
+        while (count > 0)
+        {
+            std::size_t half = count / 2;
+            std::size_t middle = first + half;
+
+            if (isBefore(timeForIndex(middle)))
+            {
+                first = middle + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        return first;
+    }
+
+};
+
+
 } } // namespace ofx::Player
@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include "ofLog.h"
+#include "ofx/Player/BasePlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A fixed capacity, lock-free, single producer ring buffer.
+///
+/// All slots are allocated up front. The producer fills the next slot in
+/// place with beginWrite() and publishes it with commitWrite(). Once the
+/// buffer is full, each write reuses the oldest slot, so a producer that
+/// copies into the existing slot (e.g. ofPixels::setFromPixels() with the
+/// same dimensions) does not allocate.
+///
+/// Entries are addressed by a monotonically increasing sequence number. The
+/// slot for a sequence number is sequence % capacity().
+///
+/// Each slot is stamped with the sequence number of the entry it holds, and
+/// the stamp is cleared while the slot is rewritten. Readers on other threads
+/// can check isCurrent() after reading an entry, or copy it with read(), to
+/// detect an entry that was overwritten while it was read. See
+/// RingBufferHandle for a reader view with a guard margin.
+///
+/// \tparam Type The slot type. It must be default constructible.
+template<typename Type>
+class RingBuffer
+{
+public:
+    typedef Type value_type;
+
+    /// \brief Create a RingBuffer with the given capacity.
+    /// \param capacity The number of slots.
+    RingBuffer(std::size_t capacity):
+        _slots(std::max(capacity, std::size_t(1))),
+        _stamps(new std::atomic<uint64_t>[_slots.size()]()),
+        _written(0)
+    {
+    }
+
+    /// \brief Destroy the RingBuffer.
+    virtual ~RingBuffer()
+    {
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator = (const RingBuffer&) = delete;
+
+    /// \brief Get the next slot to write.
+    ///
+    /// This must only be called by the producer. The slot contains the entry
+    /// it last held, which may be reused to avoid allocations. The entry is
+    /// no longer current until commitWrite() is called.
+    ///
+    /// \returns a reference to the next slot.
+    Type& beginWrite()
+    {
+        std::size_t slot = _written.load(std::memory_order_relaxed) % _slots.size();
+
+        // Readers of the old entry see the cleared stamp before the new data.
+        _stamps[slot].store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        return _slots[slot];
+    }
+
+    /// \brief Publish the slot returned by beginWrite().
+    ///
+    /// This must only be called by the producer.
+    void commitWrite()
+    {
+        uint64_t sequence = _written.load(std::memory_order_relaxed);
+
+        _stamps[sequence % _slots.size()].store(sequence + 1, std::memory_order_release);
+        _written.store(sequence + 1, std::memory_order_release);
+    }
+
+    /// \brief Copy an entry into the next slot and publish it.
+    /// \param value The entry to write.
+    void push(const Type& value)
+    {
+        beginWrite() = value;
+        commitWrite();
+    }
+
+    /// \returns the total number of entries ever published.
+    uint64_t written() const
+    {
+        return _written.load(std::memory_order_acquire);
+    }
+
+    /// \returns the number of slots.
+    std::size_t capacity() const
+    {
+        return _slots.size();
+    }
+
+    /// \param sequence The sequence number of the entry.
+    /// \returns the slot for the given sequence number.
+    const Type& at(uint64_t sequence) const
+    {
+        return _slots[sequence % _slots.size()];
+    }
+
+    /// \brief Check that an entry is still held by its slot.
+    ///
+    /// Call this after reading an entry through at(). If it returns false,
+    /// the producer overwrote the entry and anything read may be torn.
+    ///
+    /// \param sequence The sequence number of the entry.
+    /// \returns true if the slot holds the published entry.
+    bool isCurrent(uint64_t sequence) const
+    {
+        // Order the preceding reads of the entry before the stamp check.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _stamps[sequence % _slots.size()].load(std::memory_order_acquire) == sequence + 1;
+    }
+
+    /// \brief Copy an entry, rejecting it if it is overwritten.
+    /// \param sequence The sequence number of the entry.
+    /// \param value The entry to fill.
+    /// \returns true if the entry was copied before it was overwritten.
+    bool read(uint64_t sequence, Type& value) const
+    {
+        if (!isCurrent(sequence))
+        {
+            return false;
+        }
+
+        value = at(sequence);
+
+        return isCurrent(sequence);
+    }
+
+private:
+    /// \brief The preallocated slots.
+    std::vector<Type> _slots;
+
+    /// \brief One past the sequence number of the entry in each slot.
+    ///
+    /// A stamp of 0 means the slot is empty or being written.
+    std::unique_ptr<std::atomic<uint64_t>[]> _stamps;
+
+    /// \brief The number of entries published.
+    std::atomic<uint64_t> _written;
+
+};
+
+
+/// \brief A time indexed view of a RingBuffer.
+///
+/// The view is a snapshot of the published entries taken by sync(). Index 0
+/// is the oldest entry in the snapshot, so indexes shift as the producer
+/// writes and sync() is called. Timestamps are stable, which is why players
+/// are driven by time rather than by index.
+///
+/// The oldest guard entries are excluded from the view. Between two calls to
+/// sync(), the producer may write up to guard entries without overwriting an
+/// entry in the view. Choose a guard larger than the number of entries
+/// written during one reader frame. The buffer capacity must be larger than
+/// the guard, otherwise the view is always empty.
+///
+/// A producer that outruns the guard overwrites the oldest entries in the
+/// view. Check isValid() after reading an entry, or copy it with read(), to
+/// reject an overwritten entry.
+///
+/// \tparam Type The slot type of the ring buffer.
+/// \tparam AdapterType An adapter with a static ::timestamp function. See
+///         PlayableBufferHandle.
+template<typename Type, typename AdapterType = DefaultBufferAdapter>
+class RingBufferHandle: public BaseTimeIndexed
+{
+public:
+    /// \brief Create a RingBufferHandle for the given \p buffer.
+    /// \param buffer The ring buffer to view.
+    /// \param guard The number of oldest entries to exclude from the view.
+    RingBufferHandle(const RingBuffer<Type>& buffer,
+                     std::size_t guard = DEFAULT_GUARD):
+        _buffer(buffer),
+        _guard(guard)
+    {
+        if (_buffer.capacity() <= _guard)
+        {
+            ofLogError("RingBufferHandle::RingBufferHandle") << "The capacity " << _buffer.capacity() << " must be larger than the guard " << _guard << ".";
+        }
+    }
+
+    /// \brief Destroy the RingBufferHandle.
+    virtual ~RingBufferHandle()
+    {
+    }
+
+    /// \brief Take a snapshot of the published entries.
+    ///
+    /// This does not block the producer or allocate.
+    void sync()
+    {
+        _end = _buffer.written();
+
+        uint64_t available = (_buffer.capacity() > _guard) ? (_buffer.capacity() - _guard) : 0;
+
+        _begin = (_end > available) ? (_end - available) : 0;
+    }
+
+    double timeForIndex(std::size_t index) const override
+    {
+        return AdapterType::timestamp(_buffer.at(_begin + index));
+    }
+
+    std::size_t size() const override
+    {
+        return static_cast<std::size_t>(_end - _begin);
+    }
+
+    /// \param index The index in the snapshot.
+    /// \returns the entry at the given index.
+    const Type& operator [] (std::size_t index) const
+    {
+        return _buffer.at(_begin + index);
+    }
+
+    /// \brief Check that an entry has not been overwritten since sync().
+    /// \param index The index in the snapshot.
+    /// \returns true if the entry at the given index is still current.
+    bool isValid(std::size_t index) const
+    {
+        return _buffer.isCurrent(_begin + index);
+    }
+
+    /// \brief Copy an entry, rejecting it if it is overwritten.
+    /// \param index The index in the snapshot.
+    /// \param value The entry to fill.
+    /// \returns true if the entry was copied before it was overwritten.
+    bool read(std::size_t index, Type& value) const
+    {
+        return _buffer.read(_begin + index, value);
+    }
+
+    /// \param index The index in the snapshot.
+    /// \returns the sequence number of the entry at the given index.
+    uint64_t sequenceForIndex(std::size_t index) const
+    {
+        return _begin + index;
+    }
+
+    /// \returns the number of oldest entries excluded from the view.
+    std::size_t guard() const
+    {
+        return _guard;
+    }
+
+    enum
+    {
+        /// \brief The default number of oldest entries excluded from the view.
+        DEFAULT_GUARD = 2
+    };
+
+private:
+    /// \brief The viewed ring buffer.
+    const RingBuffer<Type>& _buffer;
+
+    /// \brief The number of oldest entries excluded from the view.
+    std::size_t _guard = DEFAULT_GUARD;
+
+    /// \brief The sequence number of the first entry in the snapshot.
+    uint64_t _begin = 0;
+
+    /// \brief One past the sequence number of the last entry in the snapshot.
+    uint64_t _end = 0;
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,376 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <fstream>
+#include "ofx/Cache/LRUMemoryCache.h"
+#include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/MappedFile.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief The shared layout of a compressed, columnar sample log.
+///
+/// A sample log stores timestamped samples with a fixed number of double
+/// channels (e.g. the axes of an IMU). Samples are grouped into blocks of
+/// blockSize samples. Within a block each column is compressed separately:
+///
+/// - Timestamps are stored as integer microseconds using delta-of-delta
+///   encoding with zigzag varints. Regularly sampled data costs about one
+///   byte per timestamp.
+/// - Each channel uses Gorilla-style XOR compression, where each value is
+///   XORed with the previous value and only the meaningful bits are stored.
+///   Slowly changing values cost a few bits per sample.
+///
+/// A block index at the end of the file stores the time range, offset and
+/// sample count of each block, so seeking only decodes a single block. The
+/// index is followed by a fixed-size trailer that repeats its location, so a
+/// reader can tell if the index is still intact.
+///
+/// The file stores values in native byte order and is not intended to be
+/// portable between architectures with different endianness.
+class SampleLog
+{
+public:
+    /// \brief A summary of a single block.
+    struct BlockSummary
+    {
+        /// \brief The minimum timestamp in the block in microseconds.
+        int64_t minTime;
+
+        /// \brief The maximum timestamp in the block in microseconds.
+        int64_t maxTime;
+
+        /// \brief The offset of the block data in bytes.
+        uint64_t offset;
+
+        /// \brief The length of the block data in bytes.
+        uint64_t length;
+
+        /// \brief The number of samples in the block.
+        uint64_t count;
+    };
+
+    /// \brief The log file header.
+    struct Header
+    {
+        /// \brief The file magic.
+        char magic[8];
+
+        /// \brief The file format version.
+        uint32_t version;
+
+        /// \brief The number of channels per sample.
+        uint32_t channelCount;
+
+        /// \brief The number of samples per block.
+        uint64_t blockSize;
+
+        /// \brief The total number of samples.
+        uint64_t count;
+
+        /// \brief The number of blocks.
+        uint64_t blockCount;
+
+        /// \brief The offset of the block summaries in bytes.
+        uint64_t indexOffset;
+    };
+
+    /// \brief The trailer following the block summaries.
+    struct Trailer
+    {
+        /// \brief The file magic.
+        char magic[8];
+
+        /// \brief The offset of the block summaries in bytes.
+        uint64_t indexOffset;
+
+        /// \brief The number of blocks.
+        uint64_t blockCount;
+
+        /// \brief The total number of samples.
+        uint64_t count;
+    };
+
+    enum
+    {
+        /// \brief The default number of samples per block.
+        DEFAULT_BLOCK_SIZE = 1024,
+        /// \brief The default number of decoded blocks to cache.
+        DEFAULT_BLOCK_CACHE_SIZE = 16
+    };
+
+    /// \brief The log file format version.
+    static const uint32_t VERSION;
+
+    /// \brief The log file magic.
+    static const char MAGIC[8];
+
+};
+
+
+/// \brief Write timestamped samples to a compressed, columnar sample log.
+///
+/// Samples must be added in non-decreasing timestamp order. Timestamps are
+/// stored at microsecond resolution. Completed blocks are written as they
+/// fill, so memory use is bounded by the block size.
+///
+/// The header is written when the log is opened, but the sample counts and
+/// the block index are only written by flush() and close(). The index and
+/// its trailer are written after the last block, and the next block
+/// overwrites them. A log that is never flushed or closed (e.g. after a
+/// crash) opens as an empty log, and a log that is not closed opens with the
+/// complete blocks of its last flush, rebuilding their index if it was
+/// overwritten. Call flush() periodically to bound the samples that can be
+/// lost.
+class SampleLogWriter
+{
+public:
+    /// \brief Create an unopened SampleLogWriter.
+    SampleLogWriter();
+
+    SampleLogWriter(const SampleLogWriter&) = delete;
+    SampleLogWriter& operator = (const SampleLogWriter&) = delete;
+
+    /// \brief Destroy the SampleLogWriter, closing the log.
+    ~SampleLogWriter();
+
+    /// \brief Open a log file for writing.
+    /// \param filename The log file to write.
+    /// \param channelCount The number of channels per sample.
+    /// \param blockSize The number of samples per block.
+    /// \returns true if the log was opened successfully.
+    bool open(const std::string& filename,
+              std::size_t channelCount,
+              std::size_t blockSize = SampleLog::DEFAULT_BLOCK_SIZE);
+
+    /// \brief Write the remaining samples and the block index and close.
+    /// \returns true if the log was written successfully.
+    bool close();
+
+    /// \brief Write the block index and the header for the complete blocks.
+    ///
+    /// The complete blocks can then be read even if the log is never closed.
+    /// Samples in the pending block are not written, since every block but
+    /// the last must be full. The index is overwritten by the next block, so
+    /// flushing does not grow the file.
+    ///
+    /// \returns true if the log was written successfully.
+    bool flush();
+
+    /// \returns true if a log is open.
+    bool isOpen() const;
+
+    /// \brief Add a sample.
+    /// \param timestamp The sample timestamp in microseconds.
+    /// \param values The channel values, with channelCount() values.
+    /// \returns true if the sample was added.
+    bool add(double timestamp, const double* values);
+
+    /// \brief Add a sample.
+    /// \param timestamp The sample timestamp in microseconds.
+    /// \param values The channel values, with channelCount() values.
+    /// \returns true if the sample was added.
+    bool add(double timestamp, const std::vector<double>& values);
+
+    /// \returns the number of channels per sample.
+    std::size_t channelCount() const;
+
+    /// \returns the number of samples added.
+    std::size_t size() const;
+
+private:
+    /// \brief Encode and write the pending block.
+    void writeBlock();
+
+    /// \brief Write the block index and trailer at the current offset and
+    /// the header.
+    ///
+    /// The current offset is not advanced, so the next block overwrites the
+    /// index and trailer.
+    void writeIndex();
+
+    /// \brief The log file stream.
+    std::ofstream _stream;
+
+    /// \brief The log file header.
+    SampleLog::Header _header;
+
+    /// \brief The current write offset in bytes.
+    uint64_t _position = 0;
+
+    /// \brief The pending timestamps in microseconds.
+    std::vector<int64_t> _timestamps;
+
+    /// \brief The pending channel values, one column per channel.
+    std::vector<std::vector<double>> _columns;
+
+    /// \brief The summaries of the written blocks.
+    std::vector<SampleLog::BlockSummary> _summaries;
+
+    /// \brief The encoded block buffer.
+    std::vector<uint8_t> _block;
+
+};
+
+
+/// \brief Read a compressed, columnar sample log.
+///
+/// Opening a log maps the file and reads only the header and block index.
+/// Blocks are decoded on demand and kept in a small LRU cache. Timestamps and
+/// each channel are decoded independently, so searching by time never
+/// decodes values.
+///
+/// The reader is not thread safe.
+class SampleLogReader: public BaseTimeIndexed
+{
+public:
+    /// \brief Create an unopened SampleLogReader.
+    SampleLogReader();
+
+    /// \brief Destroy the SampleLogReader.
+    virtual ~SampleLogReader();
+
+    /// \brief Open a log file.
+    /// \param filename The log file to open.
+    /// \returns true if the log was opened successfully.
+    bool open(const std::string& filename);
+
+    /// \brief Close the log file.
+    void close();
+
+    /// \returns true if a log is open.
+    bool isOpen() const;
+
+    double timeForIndex(std::size_t index) const override;
+
+    std::size_t size() const override;
+
+    std::size_t indexForTime(double time,
+                             bool increasing,
+                             std::size_t indexHint) const override;
+
+    int64_t timeForIndexMicros(std::size_t index) const override;
+
+    std::size_t indexForTimeMicros(int64_t time,
+                                   bool increasing,
+                                   std::size_t indexHint) const override;
+
+    /// \param index The sample index.
+    /// \param channel The channel index.
+    /// \returns the value of the channel at the given index.
+    double value(std::size_t index, std::size_t channel) const;
+
+    /// \param index The sample index.
+    /// \param values The channel values to fill, with channelCount() values.
+    void values(std::size_t index, double* values) const;
+
+    /// \returns the number of channels per sample.
+    std::size_t channelCount() const;
+
+    /// \returns the number of samples per block.
+    std::size_t blockSize() const;
+
+    /// \returns the number of blocks.
+    std::size_t blockCount() const;
+
+    /// \param block The block index.
+    /// \returns the summary for the given block.
+    const SampleLog::BlockSummary& block(std::size_t block) const;
+
+    /// \brief Set the number of decoded blocks to cache.
+    /// \param size The number of blocks.
+    void setBlockCacheSize(std::size_t size);
+
+    /// \returns the number of decoded blocks to cache.
+    std::size_t getBlockCacheSize() const;
+
+private:
+    /// \brief A decoded block.
+    struct DecodedBlock
+    {
+        /// \brief The decoded timestamps in microseconds.
+        std::vector<int64_t> timestamps;
+
+        /// \brief The decoded channels. Empty columns are not decoded yet.
+        std::vector<std::vector<double>> columns;
+    };
+
+    typedef Cache::LRUMemoryCache<std::size_t, DecodedBlock> BlockCache;
+
+    /// \brief Get a decoded block, decoding the timestamps if needed.
+    /// \param block The block index.
+    /// \returns the decoded block.
+    DecodedBlock& decodedBlock(std::size_t block) const;
+
+    /// \brief Get a decoded channel column, decoding it if needed.
+    /// \param block The block index.
+    /// \param channel The channel index.
+    /// \returns the decoded channel column.
+    const std::vector<double>& decodedColumn(std::size_t block,
+                                             std::size_t channel) const;
+
+    /// \param header The log header.
+    /// \param summary The block summary.
+    /// \param block The block index.
+    /// \returns true if the block lies within the file and its column
+    ///     offsets lie within the block.
+    bool isValidBlock(const SampleLog::Header& header,
+                      const SampleLog::BlockSummary& summary,
+                      uint64_t block) const;
+
+    /// \param header The log header.
+    /// \returns true if the block index of the header is followed by a
+    ///     matching trailer.
+    bool isIndexIntact(const SampleLog::Header& header) const;
+
+    /// \brief Rebuild the block index of the header from the blocks.
+    ///
+    /// The blocks of the last flush are never overwritten, so they are walked
+    /// from the header using their column offset tables.
+    ///
+    /// \param header The log header.
+    /// \returns true if every block was recovered.
+    bool recoverIndex(const SampleLog::Header& header);
+
+    /// \param block The block index.
+    /// \returns a pointer to the column offsets of the given block.
+    const uint32_t* columnOffsets(std::size_t block) const;
+
+    /// \brief The mapped log file.
+    MappedFile _file;
+
+    /// \brief The header in the mapped file.
+    const SampleLog::Header* _header = nullptr;
+
+    /// \brief The block summaries in the mapped file or the recovered index.
+    const SampleLog::BlockSummary* _summaries = nullptr;
+
+    /// \brief The block summaries rebuilt when the index was overwritten.
+    std::vector<SampleLog::BlockSummary> _recoveredSummaries;
+
+    /// \brief The number of decoded blocks to cache.
+    std::size_t _blockCacheSize = SampleLog::DEFAULT_BLOCK_CACHE_SIZE;
+
+    /// \brief The decoded block cache.
+    mutable std::unique_ptr<BlockCache> _blockCache;
+
+    /// \brief The most recently used block index.
+    mutable std::size_t _lastBlockIndex = std::numeric_limits<std::size_t>::max();
+
+    /// \brief The most recently used block, to skip cache lookups.
+    mutable std::shared_ptr<DecodedBlock> _lastBlock;
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofImage.h"
+#include "ofJson.h"
+#include "ofx/Player/IndexedFile.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Generate synthetic image sequences for load testing.
+///
+/// Sequences are written to a local directory with a json manifest readable
+/// by ImageSequence::fromJson(). By default, files are named with the
+/// FilenameTimestamper::DEFAULT_TIMESTAMP_FORMAT, so the same sequence can
+/// also be loaded with ImageSequence::fromDirectory() and a
+/// FilenameTimestamper.
+///
+/// All randomness comes from the seed, so the same settings always produce
+/// the same sequence.
+class SequenceGenerator
+{
+public:
+    /// \brief The spacing between timestamps.
+    enum class Spacing
+    {
+        /// \brief Timestamps are exactly one frame duration apart.
+        UNIFORM,
+        /// \brief Timestamps are offset by a random fraction of a frame.
+        JITTERED,
+        /// \brief Uniform timestamps with randomly missing runs of frames.
+        GAPPY
+    };
+
+    /// \brief Generator settings.
+    struct Settings
+    {
+        /// \brief Create the default Settings.
+        Settings():
+            count(100),
+            width(320),
+            height(240),
+            imageType(OF_IMAGE_COLOR),
+            extension("jpg"),
+            timestampFormat(FilenameTimestamper::DEFAULT_TIMESTAMP_FORMAT),
+            startTime(1577836800000000.0),
+            frameDuration(1000000.0 / 30.0),
+            spacing(Spacing::UNIFORM),
+            jitter(0.25),
+            gapProbability(0.01),
+            maxGapFrames(30),
+            seed(0),
+            writeImages(true),
+            writeManifest(true),
+            threadCount(0)
+        {
+        }
+
+        /// \brief The number of images.
+        std::size_t count;
+
+        /// \brief The image width in pixels.
+        std::size_t width;
+
+        /// \brief The image height in pixels.
+        std::size_t height;
+
+        /// \brief The image type.
+        ofImageType imageType;
+
+        /// \brief The image file extension, which selects the encoder.
+        std::string extension;
+
+        /// \brief The Poco timestamp format used for filenames.
+        ///
+        /// Literal text may be included, e.g. "frame-%Y-%m-%d-%H-%M-%S-%i".
+        /// If empty, files are named with zero padded frame numbers, which is
+        /// compatible with a SequenceTimestamper.
+        std::string timestampFormat;
+
+        /// \brief The first timestamp in microseconds.
+        double startTime;
+
+        /// \brief The nominal frame duration in microseconds.
+        double frameDuration;
+
+        /// \brief The spacing between timestamps.
+        Spacing spacing;
+
+        /// \brief The maximum jitter as a fraction of the frame duration.
+        ///
+        /// Values are clamped below 0.5 so timestamps remain in order.
+        double jitter;
+
+        /// \brief The probability of a gap after each frame.
+        double gapProbability;
+
+        /// \brief The maximum number of frames missing in each gap.
+        std::size_t maxGapFrames;
+
+        /// \brief The random seed.
+        uint32_t seed;
+
+        /// \brief True if image files should be written.
+        ///
+        /// When false, only the manifest is written, which is useful for
+        /// testing index and manifest performance with very long sequences.
+        bool writeImages;
+
+        /// \brief True if the json manifest should be written.
+        bool writeManifest;
+
+        /// \brief The number of encoding threads, or 0 for all cores.
+        std::size_t threadCount;
+    };
+
+    /// \brief Generate a sequence.
+    ///
+    /// The directory is created if it does not exist.
+    ///
+    /// \param directory The directory to write to.
+    /// \param settings The generator settings.
+    /// \returns true if all files were written successfully.
+    static bool generate(const std::string& directory,
+                         const Settings& settings = Settings());
+
+    /// \brief Create the timestamps for a sequence.
+    ///
+    /// Timestamps are rounded to whole milliseconds and kept unique, since
+    /// timestamped filenames have millisecond resolution.
+    ///
+    /// \param settings The generator settings.
+    /// \returns the timestamps in microseconds.
+    static std::vector<double> makeTimestamps(const Settings& settings);
+
+    /// \brief Create the filename for an image.
+    /// \param settings The generator settings.
+    /// \param index The image index.
+    /// \param timestamp The image timestamp in microseconds.
+    /// \returns the filename.
+    static std::string makeFilename(const Settings& settings,
+                                    std::size_t index,
+                                    double timestamp);
+
+    /// \brief Fill pixels with a synthetic frame.
+    ///
+    /// Each frame has a distinct moving pattern, so encoders and caches can
+    /// not take advantage of identical frames.
+    ///
+    /// \param settings The generator settings.
+    /// \param index The image index.
+    /// \param pixels The pixels to fill.
+    static void makePixels(const Settings& settings,
+                           std::size_t index,
+                           ofPixels& pixels);
+
+};
+
+
+} } // namespace ofx::Player
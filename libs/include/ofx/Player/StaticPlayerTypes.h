@@ -0,0 +1,712 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <chrono>
+#include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/PlayerUtils.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A statically dispatched time index.
+///
+/// This provides the BaseTimeIndexed queries for a Derived class with
+/// non-virtual `double timeForIndex(std::size_t) const` and
+/// `std::size_t size() const` functions. The searches call the Derived
+/// functions directly, so the timestamp accessor can be inlined into the
+/// search loops.
+///
+/// A Derived class with a contiguous timestamp column may also define
+/// `const double* timestampData() const` to enable column batch searches.
+/// A Derived class with integer timestamps should also define
+/// `int64_t timeForIndexMicros(std::size_t) const` and, if contiguous,
+/// `const int64_t* timestampMicrosData() const`.
+///
+/// \tparam Derived The derived time index type.
+template<typename Derived>
+class StaticTimeIndexed
+{
+public:
+    /// \returns the first timestamp in microseconds or -1 if empty.
+    double startTime() const
+    {
+        return derived().size() > 0 ? derived().timeForIndex(0) : -1;
+    }
+
+    /// \returns the last timestamp in microseconds or -1 if empty.
+    double endTime() const
+    {
+        return derived().size() > 0 ? derived().timeForIndex(derived().size() - 1) : -1;
+    }
+
+    /// \returns the duration in microseconds.
+    double duration() const
+    {
+        return derived().size() > 0 ? (endTime() - startTime()) : 0;
+    }
+
+    /// \sa BaseTimeIndexed::indexForPosition()
+    std::size_t indexForPosition(double position,
+                                 bool increasing,
+                                 std::size_t indexHint) const
+    {
+        return indexForTime(timeForPosition(position), increasing, indexHint);
+    }
+
+    /// \sa BaseTimeIndexed::timeForPosition()
+    double timeForPosition(double position) const
+    {
+        return startTime() + position * duration();
+    }
+
+    /// \sa BaseTimeIndexed::positionForIndex()
+    double positionForIndex(std::size_t index) const
+    {
+        return (derived().timeForIndex(index) - startTime()) / duration();
+    }
+
+    /// \sa BaseTimeIndexed::positionForTime()
+    double positionForTime(double time, bool clamp) const
+    {
+        double position = (time - startTime()) / duration();
+        return clamp ? std::max(0.0, std::min(position, 1.0)) : position;
+    }
+
+    /// \sa BaseTimeIndexed::indexForTime()
+    std::size_t indexForTime(double time,
+                             bool increasing,
+                             std::size_t indexHint) const
+    {
+        return SearchUtils::indexForTime(accessor(),
+                                         derived().size(),
+                                         time,
+                                         increasing,
+                                         indexHint);
+    }
+
+    /// \sa BaseTimeIndexed::indexesForTimes()
+    void indexesForTimes(const double* times,
+                         std::size_t count,
+                         bool increasing,
+                         std::size_t* indexes) const
+    {
+        const double* timestamps = derived().timestampData();
+
+        if (timestamps != nullptr)
+        {
+            SearchUtils::indexesForTimesInColumn(timestamps,
+                                                 derived().size(),
+                                                 times,
+                                                 count,
+                                                 increasing,
+                                                 indexes);
+        }
+        else
+        {
+            SearchUtils::indexesForTimes(accessor(),
+                                         derived().size(),
+                                         times,
+                                         count,
+                                         increasing,
+                                         indexes);
+        }
+    }
+
+    /// \sa BaseTimeIndexed::upperBound()
+    std::size_t upperBound(double time, std::size_t indexHint = 0) const
+    {
+        return SearchUtils::upperBound(accessor(), derived().size(), time, indexHint);
+    }
+
+    /// \sa BaseTimeIndexed::lowerBound()
+    std::size_t lowerBound(double time, std::size_t indexHint = 0) const
+    {
+        return SearchUtils::lowerBound(accessor(), derived().size(), time, indexHint);
+    }
+
+    /// \returns nullptr, unless hidden by the Derived class.
+    const double* timestampData() const
+    {
+        return nullptr;
+    }
+
+    /// \returns the rounded timestamp, unless hidden by the Derived class.
+    /// \sa BaseTimeIndexed::timeForIndexMicros()
+    int64_t timeForIndexMicros(std::size_t index) const
+    {
+        return TimeUtils::roundMicros(derived().timeForIndex(index));
+    }
+
+    /// \returns nullptr, unless hidden by the Derived class.
+    const int64_t* timestampMicrosData() const
+    {
+        return nullptr;
+    }
+
+    /// \sa BaseTimeIndexed::startTimeMicros()
+    int64_t startTimeMicros() const
+    {
+        return derived().size() > 0 ? derived().timeForIndexMicros(0) : -1;
+    }
+
+    /// \sa BaseTimeIndexed::endTimeMicros()
+    int64_t endTimeMicros() const
+    {
+        return derived().size() > 0 ? derived().timeForIndexMicros(derived().size() - 1) : -1;
+    }
+
+    /// \sa BaseTimeIndexed::indexForTimeMicros()
+    std::size_t indexForTimeMicros(int64_t time,
+                                   bool increasing,
+                                   std::size_t indexHint) const
+    {
+        return SearchUtils::indexForTime(microsAccessor(),
+                                         derived().size(),
+                                         time,
+                                         increasing,
+                                         indexHint);
+    }
+
+    /// \sa BaseTimeIndexed::indexesForTimesMicros()
+    void indexesForTimesMicros(const int64_t* times,
+                               std::size_t count,
+                               bool increasing,
+                               std::size_t* indexes) const
+    {
+        const int64_t* timestamps = derived().timestampMicrosData();
+
+        if (timestamps != nullptr)
+        {
+            SearchUtils::indexesForTimesInColumn(timestamps,
+                                                 derived().size(),
+                                                 times,
+                                                 count,
+                                                 increasing,
+                                                 indexes);
+        }
+        else
+        {
+            SearchUtils::indexesForTimes(microsAccessor(),
+                                         derived().size(),
+                                         times,
+                                         count,
+                                         increasing,
+                                         indexes);
+        }
+    }
+
+    /// \sa BaseTimeIndexed::upperBoundMicros()
+    std::size_t upperBoundMicros(int64_t time, std::size_t indexHint = 0) const
+    {
+        return SearchUtils::upperBound(microsAccessor(), derived().size(), time, indexHint);
+    }
+
+    /// \sa BaseTimeIndexed::lowerBoundMicros()
+    std::size_t lowerBoundMicros(int64_t time, std::size_t indexHint = 0) const
+    {
+        return SearchUtils::lowerBound(microsAccessor(), derived().size(), time, indexHint);
+    }
+
+protected:
+    /// \returns this as the Derived type.
+    const Derived& derived() const
+    {
+        return static_cast<const Derived&>(*this);
+    }
+
+private:
+    /// \returns a timestamp accessor for the SearchUtils.
+    auto accessor() const
+    {
+        const Derived& indexed = derived();
+
+        return [&indexed](std::size_t index) {
+            return indexed.timeForIndex(index);
+        };
+    }
+
+    /// \returns an integer timestamp accessor for the SearchUtils.
+    auto microsAccessor() const
+    {
+        const Derived& indexed = derived();
+
+        return [&indexed](std::size_t index) {
+            return indexed.timeForIndexMicros(index);
+        };
+    }
+
+};
+
+
+/// \brief A statically dispatched playable buffer.
+///
+/// This is the static counterpart of PlayableBufferHandle. The AdapterType
+/// must have a static ::timestamp function that takes an element of the
+/// buffer and returns its timestamp in microseconds.
+///
+/// \tparam BufferType The buffer with the playable data.
+/// \tparam AdapterType The adapter type.
+template<typename BufferType, typename AdapterType>
+class StaticPlayableBuffer: public StaticTimeIndexed<StaticPlayableBuffer<BufferType, AdapterType>>
+{
+public:
+    /// \brief Create a StaticPlayableBuffer for the given \p buffer.
+    /// \param buffer The buffer to create a handle for.
+    StaticPlayableBuffer(const BufferType& buffer): _buffer(buffer)
+    {
+    }
+
+    /// \param index The index.
+    /// \returns the timestamp at the index in microseconds.
+    double timeForIndex(std::size_t index) const
+    {
+        return AdapterType::timestamp(_buffer[index]);
+    }
+
+    /// \returns the number of elements.
+    std::size_t size() const
+    {
+        return _buffer.size();
+    }
+
+    /// \returns a reference to the buffer.
+    const BufferType& buffer() const
+    {
+        return _buffer;
+    }
+
+private:
+    /// \brief A reference to the buffer.
+    const BufferType& _buffer;
+
+};
+
+
+/// \brief Expose a static time index through the BaseTimeIndexed interface.
+///
+/// This allows a static time index to be used with a BasePlayer, CueIndex,
+/// MergedTimeIndexed, etc. The searches are forwarded to the static index, so
+/// each costs a single virtual call.
+///
+/// \tparam IndexedType The static time index type.
+template<typename IndexedType>
+class StaticTimeIndexedAdapter: public BaseTimeIndexed
+{
+public:
+    /// \brief Create a StaticTimeIndexedAdapter for the given \p indexed data.
+    /// \param indexed The static time index.
+    StaticTimeIndexedAdapter(const IndexedType& indexed): _indexed(indexed)
+    {
+    }
+
+    /// \brief Destroy the StaticTimeIndexedAdapter.
+    virtual ~StaticTimeIndexedAdapter()
+    {
+    }
+
+    double timeForIndex(std::size_t index) const override
+    {
+        return _indexed.timeForIndex(index);
+    }
+
+    std::size_t size() const override
+    {
+        return _indexed.size();
+    }
+
+    std::size_t indexForTime(double time,
+                             bool increasing,
+                             std::size_t indexHint) const override
+    {
+        return _indexed.indexForTime(time, increasing, indexHint);
+    }
+
+    void indexesForTimes(const double* times,
+                         std::size_t count,
+                         bool increasing,
+                         std::size_t* indexes) const override
+    {
+        _indexed.indexesForTimes(times, count, increasing, indexes);
+    }
+
+    const double* timestampData() const override
+    {
+        return _indexed.timestampData();
+    }
+
+    int64_t timeForIndexMicros(std::size_t index) const override
+    {
+        return _indexed.timeForIndexMicros(index);
+    }
+
+    const int64_t* timestampMicrosData() const override
+    {
+        return _indexed.timestampMicrosData();
+    }
+
+    std::size_t indexForTimeMicros(int64_t time,
+                                   bool increasing,
+                                   std::size_t indexHint) const override
+    {
+        return _indexed.indexForTimeMicros(time, increasing, indexHint);
+    }
+
+    /// \returns a reference to the static time index.
+    const IndexedType& indexed() const
+    {
+        return _indexed;
+    }
+
+private:
+    /// \brief A reference to the static time index.
+    const IndexedType& _indexed;
+
+};
+
+
+/// \brief A statically dispatched player for a static time index.
+///
+/// This follows the same playback and loop rules as BasePlayer, sharing its
+/// Playhead and TimeSpans, but calls the IndexedType directly. Queries do not check if
+/// data is loaded or log errors, so they must only be called while loaded.
+/// update() does nothing while no data is loaded.
+///
+/// \tparam IndexedType The time index type, e.g. a StaticTimeIndexed.
+template<typename IndexedType>
+class StaticPlayer
+{
+public:
+    /// \brief Create an unloaded StaticPlayer.
+    StaticPlayer()
+    {
+    }
+
+    /// \brief Create a StaticPlayer for the given \p data.
+    /// \param data The data to play. It must outlive the player.
+    StaticPlayer(const IndexedType& data): _data(&data)
+    {
+    }
+
+    /// \brief Load data.
+    /// \param data The data to play. It must outlive the player.
+    void load(const IndexedType& data)
+    {
+        _data = &data;
+        _isFirstUpdate = true;
+    }
+
+    /// \brief Unload the data.
+    void close()
+    {
+        _data = nullptr;
+    }
+
+    /// \returns a pointer to the data or nullptr if not loaded.
+    const IndexedType* data() const
+    {
+        return _data;
+    }
+
+    /// \brief Advance the playhead by the real time since the last update.
+    void update()
+    {
+        auto now = std::chrono::high_resolution_clock::now();
+
+        double elapsedRealTime = 0;
+
+        if (!_isFirstUpdate)
+        {
+            elapsedRealTime = std::chrono::duration<double, std::micro>(now - _lastUpdateTime).count();
+        }
+
+        _lastUpdateTime = now;
+
+        update(elapsedRealTime);
+    }
+
+    /// \brief Advance the playhead by the given real time.
+    ///
+    /// This is useful for fixed time steps and offline processing.
+    ///
+    /// \param elapsedRealTime The elapsed real time in microseconds.
+    void update(double elapsedRealTime)
+    {
+        _spans.clear();
+        _isCrossedIndexRangesValid = false;
+
+        if (_data == nullptr || _data->size() == 0 || !_playing)
+        {
+            return;
+        }
+
+        bool isFirstUpdate = _isFirstUpdate;
+
+        if (_isFirstUpdate)
+        {
+            _playhead.start(*_data);
+            _isFirstUpdate = false;
+        }
+
+        if (_paused)
+        {
+            elapsedRealTime = 0;
+        }
+
+        double elapsedTime = _speed * elapsedRealTime;
+
+        if (!_playhead.playingForward)
+        {
+            elapsedTime *= -1.0;
+        }
+
+        bool increasing = _playhead.advance(*_data, _spans, elapsedTime, isFirstUpdate);
+
+        _playhead.updateFrameIndex(*_data, increasing);
+    }
+
+    /// \sa BasePlayer::getCrossedIndexRanges()
+    const IndexRanges& getCrossedIndexRanges() const
+    {
+        if (!_isCrossedIndexRangesValid)
+        {
+            _crossedIndexRanges.clear();
+
+            if (_data != nullptr)
+            {
+                std::size_t indexHint = _playhead.frameIndex < _data->size() ? _playhead.frameIndex : 0;
+                _spans.crossedIndexRanges(*_data, _crossedIndexRanges, indexHint);
+            }
+
+            _isCrossedIndexRangesValid = true;
+        }
+
+        return _crossedIndexRanges;
+    }
+
+    /// \returns true if the frame index changed during the last update.
+    bool isFrameIndexNew() const
+    {
+        return _playhead.isFrameIndexNew;
+    }
+
+    /// \returns the playback speed.
+    double getSpeed() const
+    {
+        return _speed;
+    }
+
+    /// \param speed The playback speed.
+    void setSpeed(double speed)
+    {
+        _speed = speed;
+    }
+
+    /// \returns the playback time in microseconds.
+    double getTime() const
+    {
+        return _playhead.time();
+    }
+
+    /// \param time The playback time in microseconds, clamped to the data.
+    void setTime(double time)
+    {
+        _playhead.setTime(*_data, time);
+    }
+
+    /// \sa BasePlayer::getTimeMicros()
+    int64_t getTimeMicros() const
+    {
+        return _playhead.timeMicros;
+    }
+
+    /// \param time The playback time in integer microseconds, clamped to the data.
+    void setTimeMicros(int64_t time)
+    {
+        _playhead.setTimeMicros(*_data, time);
+    }
+
+    /// \returns the playback position in [0, 1].
+    double getPosition() const
+    {
+        return _data->positionForTime(getTime(), false);
+    }
+
+    /// \param position The playback position in [0, 1].
+    void setPosition(double position)
+    {
+        setTime(_data->timeForPosition(position));
+    }
+
+    /// \returns the current frame index.
+    std::size_t getFrameIndex() const
+    {
+        return _playhead.frameIndex;
+    }
+
+    /// \param index The frame index to move the playhead to.
+    void setFrameIndex(std::size_t index)
+    {
+        setTimeMicros(_data->timeForIndexMicros(index));
+    }
+
+    /// \param time The loop start time in microseconds.
+    void setLoopStartTime(double time)
+    {
+        setLoopStartTimeMicros(TimeUtils::roundMicros(time));
+    }
+
+    /// \param time The loop end time in microseconds.
+    void setLoopEndTime(double time)
+    {
+        setLoopEndTimeMicros(TimeUtils::roundMicros(time));
+    }
+
+    /// \returns the loop start time in microseconds or -1 if not set.
+    double getLoopStartTime() const
+    {
+        return static_cast<double>(_playhead.loopStartTimeMicros);
+    }
+
+    /// \returns the loop end time in microseconds or -1 if not set.
+    double getLoopEndTime() const
+    {
+        return static_cast<double>(_playhead.loopEndTimeMicros);
+    }
+
+    /// \param time The loop start time in integer microseconds.
+    void setLoopStartTimeMicros(int64_t time)
+    {
+        if (_data == nullptr)
+        {
+            return;
+        }
+
+        _playhead.setLoopStartTimeMicros(*_data, time);
+    }
+
+    /// \param time The loop end time in integer microseconds.
+    void setLoopEndTimeMicros(int64_t time)
+    {
+        if (_data == nullptr)
+        {
+            return;
+        }
+
+        _playhead.setLoopEndTimeMicros(*_data, time);
+    }
+
+    /// \returns the loop start time in integer microseconds or -1 if not set.
+    int64_t getLoopStartTimeMicros() const
+    {
+        return _playhead.loopStartTimeMicros;
+    }
+
+    /// \returns the loop end time in integer microseconds or -1 if not set.
+    int64_t getLoopEndTimeMicros() const
+    {
+        return _playhead.loopEndTimeMicros;
+    }
+
+    /// \brief Clear the loop points.
+    void clearLoopPoints()
+    {
+        _playhead.clearLoopPoints();
+    }
+
+    /// \returns the loop type.
+    ofLoopType getLoopType() const
+    {
+        return _playhead.loopType;
+    }
+
+    /// \brief Set the loop type.
+    ///
+    /// The playing direction is reset to forward when entering or leaving
+    /// palindrome mode, since only palindrome loops reverse it.
+    ///
+    /// \param loopType The loop type.
+    void setLoopType(ofLoopType loopType)
+    {
+        _playhead.setLoopType(loopType);
+    }
+
+    /// \param paused True if playback should be paused.
+    void setPaused(bool paused)
+    {
+        _paused = paused;
+    }
+
+    /// \brief Start playback.
+    void play()
+    {
+        _playing = true;
+    }
+
+    /// \brief Stop playback.
+    void stop()
+    {
+        _playing = false;
+    }
+
+    /// \returns true if playback is paused.
+    bool isPaused() const
+    {
+        return _paused;
+    }
+
+    /// \returns true if data is loaded.
+    bool isLoaded() const
+    {
+        return _data != nullptr;
+    }
+
+    /// \returns true if playing.
+    bool isPlaying() const
+    {
+        return _playing;
+    }
+
+private:
+    /// \brief The data to play.
+    const IndexedType* _data = nullptr;
+
+    /// \brief The playhead time, direction, loop points and frame index.
+    Playhead<IndexedType> _playhead;
+
+    /// \brief The playback speed.
+    double _speed = 1;
+
+    /// \brief The last update time.
+    std::chrono::high_resolution_clock::time_point _lastUpdateTime;
+
+    /// \brief A flag to determine if this is the first update.
+    bool _isFirstUpdate = true;
+
+    /// \brief True if the playback is paused.
+    bool _paused = false;
+
+    /// \brief True if playing.
+    bool _playing = false;
+
+    /// \brief The media time spans traversed during the last update.
+    TimeSpans _spans;
+
+    /// \brief The cached index ranges crossed during the last update.
+    mutable IndexRanges _crossedIndexRanges;
+
+    /// \brief True if the cached crossed index ranges are up to date.
+    mutable bool _isCrossedIndexRangesValid = false;
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,326 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "ofx/Player/MappedFile.h"
+#include "ofx/Player/StaticPlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Read a field from an unaligned packed record.
+///
+/// Packed records in a mapped file are not necessarily aligned for their
+/// fields. A fixed size memcpy is compiled to a single unaligned load on the
+/// common platforms, so this costs the same as a direct read.
+///
+/// \tparam FieldType The trivially copyable field type.
+/// \param data A pointer to the first byte of the field.
+/// \returns the field value.
+template<typename FieldType>
+inline FieldType readField(const uint8_t* data)
+{
+    static_assert(std::is_trivially_copyable<FieldType>::value,
+                  "Fields must be trivially copyable.");
+
+    FieldType value;
+    std::memcpy(&value, data, sizeof(FieldType));
+    return value;
+}
+
+
+/// \brief A packed record layout known at compile time.
+///
+/// The stride and offset are constants, so record addressing is fully
+/// inlined and the layout takes no storage.
+///
+/// \tparam Stride The size of each record in bytes.
+/// \tparam Offset The byte offset of the timestamp within each record.
+template<std::size_t Stride, std::size_t Offset>
+class StaticRecordLayout
+{
+public:
+    static_assert(Stride > 0, "The stride must be positive.");
+
+    /// \returns the size of each record in bytes.
+    static constexpr std::size_t stride()
+    {
+        return Stride;
+    }
+
+    /// \returns the byte offset of the timestamp within each record.
+    static constexpr std::size_t offset()
+    {
+        return Offset;
+    }
+
+    /// \param size The size of the timestamp in bytes.
+    /// \returns true if the timestamp fits within the record.
+    static constexpr bool fits(std::size_t size)
+    {
+        return Offset + size <= Stride;
+    }
+
+    /// \returns true if a field of the given type can fit within the record.
+    template<typename FieldType>
+    static constexpr bool canFit()
+    {
+        return fits(sizeof(FieldType));
+    }
+
+};
+
+
+/// \brief A packed record layout known at runtime.
+///
+/// This is used for layouts that are described by a file header. The stride
+/// and offset are loop invariant, so the searches remain free of virtual
+/// calls.
+class DynamicRecordLayout
+{
+public:
+    /// \brief Create an empty DynamicRecordLayout.
+    DynamicRecordLayout()
+    {
+    }
+
+    /// \brief Create a DynamicRecordLayout.
+    /// \param stride The size of each record in bytes.
+    /// \param offset The byte offset of the timestamp within each record.
+    DynamicRecordLayout(std::size_t stride, std::size_t offset):
+        _stride(stride),
+        _offset(offset)
+    {
+    }
+
+    /// \returns the size of each record in bytes.
+    std::size_t stride() const
+    {
+        return _stride;
+    }
+
+    /// \returns the byte offset of the timestamp within each record.
+    std::size_t offset() const
+    {
+        return _offset;
+    }
+
+    /// \param size The size of the timestamp in bytes.
+    /// \returns true if the timestamp fits within the record.
+    bool fits(std::size_t size) const
+    {
+        return _stride > 0 && _offset + size <= _stride;
+    }
+
+    /// \returns true, since the layout is only checked at runtime.
+    template<typename FieldType>
+    static constexpr bool canFit()
+    {
+        return true;
+    }
+
+private:
+    /// \brief The size of each record in bytes.
+    std::size_t _stride = 0;
+
+    /// \brief The byte offset of the timestamp within each record.
+    std::size_t _offset = 0;
+
+};
+
+
+/// \brief A time index over packed records.
+///
+/// Records are read in place from any contiguous memory, such as a
+/// MappedFile, without per-record objects, virtual calls or copies. The
+/// timestamp is read from a fixed byte offset within each record. Integer
+/// timestamps are searched exactly as integer microseconds. Timestamps must
+/// be sorted.
+///
+/// The layout policy supplies the stride and offset, either as compile-time
+/// constants with StaticRecordLayout or at runtime with DynamicRecordLayout.
+/// If the timestamp does not fit within a runtime layout, the index is
+/// empty. Use the StridedRecordIndex and DynamicStridedRecordIndex aliases.
+///
+/// Use a StaticPlayer for fully inlined playback, or wrap the index in a
+/// StaticTimeIndexedAdapter to use it with a BasePlayer.
+///
+/// \tparam TimestampType The arithmetic type of the timestamp field.
+/// \tparam Layout The record layout policy.
+template<typename TimestampType, typename Layout>
+class BasicStridedRecordIndex:
+    public StaticTimeIndexed<BasicStridedRecordIndex<TimestampType, Layout>>,
+    private Layout
+{
+public:
+    static_assert(std::is_arithmetic<TimestampType>::value,
+                  "The timestamp must be an arithmetic type.");
+    static_assert(Layout::template canFit<TimestampType>(),
+                  "The timestamp must be within the record.");
+
+    /// \brief Create an empty BasicStridedRecordIndex.
+    BasicStridedRecordIndex()
+    {
+    }
+
+    /// \brief Create a BasicStridedRecordIndex over the given records.
+    /// \param data A pointer to the first record.
+    /// \param count The number of records.
+    /// \param layout The record layout.
+    BasicStridedRecordIndex(const void* data,
+                            std::size_t count,
+                            const Layout& layout = Layout()):
+        Layout(layout),
+        _data(static_cast<const uint8_t*>(data)),
+        _size(layout.fits(sizeof(TimestampType)) ? count : 0)
+    {
+    }
+
+    /// \brief Create a BasicStridedRecordIndex over a mapped file.
+    ///
+    /// Any partial record at the end of the file is ignored.
+    ///
+    /// \param file The mapped file. It must outlive the index.
+    /// \param headerSize The number of bytes before the first record.
+    /// \param layout The record layout.
+    BasicStridedRecordIndex(const MappedFile& file,
+                            std::size_t headerSize = 0,
+                            const Layout& layout = Layout()):
+        Layout(layout)
+    {
+        if (file.isOpen() && file.size() > headerSize && layout.fits(sizeof(TimestampType)))
+        {
+            _data = file.data() + headerSize;
+            _size = (file.size() - headerSize) / layout.stride();
+        }
+    }
+
+    /// \param index The record index.
+    /// \returns the timestamp of the record in microseconds.
+    double timeForIndex(std::size_t index) const
+    {
+        return static_cast<double>(readField<TimestampType>(record(index) + layout().offset()));
+    }
+
+    /// \param index The record index.
+    /// \returns the timestamp of the record in integer microseconds.
+    int64_t timeForIndexMicros(std::size_t index) const
+    {
+        TimestampType timestamp = readField<TimestampType>(record(index) + layout().offset());
+        return std::is_integral<TimestampType>::value ? static_cast<int64_t>(timestamp)
+                                                      : TimeUtils::roundMicros(static_cast<double>(timestamp));
+    }
+
+    /// \returns the number of records.
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    /// \brief Get the timestamp column if the records are bare timestamps.
+    ///
+    /// \returns a pointer to the timestamps if each record is a single aligned
+    ///          double, otherwise nullptr.
+    const double* timestampData() const
+    {
+        if (std::is_same<TimestampType, double>::value
+        &&  layout().stride() == sizeof(double)
+        &&  reinterpret_cast<std::uintptr_t>(_data) % alignof(double) == 0)
+        {
+            return reinterpret_cast<const double*>(_data);
+        }
+
+        return nullptr;
+    }
+
+    /// \brief Get the integer timestamp column if the records are bare timestamps.
+    ///
+    /// \returns a pointer to the timestamps if each record is a single aligned
+    ///          int64_t, otherwise nullptr.
+    const int64_t* timestampMicrosData() const
+    {
+        if (std::is_same<TimestampType, int64_t>::value
+        &&  layout().stride() == sizeof(int64_t)
+        &&  reinterpret_cast<std::uintptr_t>(_data) % alignof(int64_t) == 0)
+        {
+            return reinterpret_cast<const int64_t*>(_data);
+        }
+
+        return nullptr;
+    }
+
+    /// \param index The record index.
+    /// \returns a pointer to the first byte of the record.
+    const uint8_t* record(std::size_t index) const
+    {
+        return _data + index * layout().stride();
+    }
+
+    /// \brief Read a field from a record.
+    /// \tparam FieldType The trivially copyable field type.
+    /// \param index The record index.
+    /// \param offset The byte offset of the field within the record.
+    /// \returns the field value.
+    template<typename FieldType>
+    FieldType field(std::size_t index, std::size_t offset) const
+    {
+        return readField<FieldType>(record(index) + offset);
+    }
+
+    /// \returns the record layout.
+    const Layout& layout() const
+    {
+        // The layout is a base so that compile-time layouts take no storage.
+        return *this;
+    }
+
+    /// \returns the size of each record in bytes.
+    std::size_t stride() const
+    {
+        return layout().stride();
+    }
+
+    /// \returns the byte offset of the timestamp within each record.
+    std::size_t offset() const
+    {
+        return layout().offset();
+    }
+
+private:
+    /// \brief A pointer to the first record.
+    const uint8_t* _data = nullptr;
+
+    /// \brief The number of records.
+    std::size_t _size = 0;
+
+};
+
+
+/// \brief A time index over packed records with a compile-time layout.
+///
+/// \tparam TimestampType The arithmetic type of the timestamp field.
+/// \tparam Stride The size of each record in bytes.
+/// \tparam Offset The byte offset of the timestamp within each record.
+template<typename TimestampType, std::size_t Stride, std::size_t Offset>
+using StridedRecordIndex = BasicStridedRecordIndex<TimestampType, StaticRecordLayout<Stride, Offset>>;
+
+
+/// \brief A time index over packed records with a runtime layout.
+///
+/// \tparam TimestampType The arithmetic type of the timestamp field.
+template<typename TimestampType>
+using DynamicStridedRecordIndex = BasicStridedRecordIndex<TimestampType, DynamicRecordLayout>;
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Player/TimestampedSamples.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Load delimited text sensor logs into TimestampedSamples.
+///
+/// Each line holds a timestamp and one or more numeric channel values,
+/// separated by any of the configured delimiters. Lines that do not parse
+/// (e.g. headers and comments) or that have a different number of fields
+/// than the first valid line are skipped.
+///
+/// The file is memory mapped and split into one chunk per thread at line
+/// boundaries. The chunks are parsed in parallel without allocating per
+/// number or per line, then stitched together in file order. If the
+/// timestamps are not sorted, the samples are stable sorted by timestamp.
+class TextSampleLoader
+{
+public:
+    /// \brief Loader settings.
+    struct Settings
+    {
+        /// \brief Create the default Settings.
+        Settings():
+            delimiters(",;\t "),
+            timestampColumn(0),
+            timestampScale(1),
+            threadCount(0)
+        {
+        }
+
+        /// \brief The characters that separate fields.
+        std::string delimiters;
+
+        /// \brief The index of the timestamp field.
+        std::size_t timestampColumn;
+
+        /// \brief Multiplier converting file timestamps to microseconds.
+        ///
+        /// For example, use 1000 for millisecond timestamps.
+        double timestampScale;
+
+        /// \brief The number of threads to use, or 0 for all cores.
+        std::size_t threadCount;
+    };
+
+    /// \brief Statistics about a load.
+    struct LoadStats
+    {
+        /// \brief The number of bytes parsed.
+        std::size_t bytes = 0;
+
+        /// \brief The number of lines parsed.
+        std::size_t lines = 0;
+
+        /// \brief The number of lines skipped.
+        std::size_t skippedLines = 0;
+
+        /// \brief The number of samples loaded.
+        std::size_t samples = 0;
+
+        /// \brief The number of threads used.
+        std::size_t threads = 0;
+
+        /// \brief True if the samples had to be sorted.
+        bool sorted = false;
+
+        /// \brief The total load time in seconds.
+        double seconds = 0;
+
+        /// \returns the throughput in megabytes per second.
+        double megabytesPerSecond() const
+        {
+            return seconds > 0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0;
+        }
+    };
+
+    /// \brief Load a text log.
+    /// \param filename The text log to load.
+    /// \param samples The samples to fill.
+    /// \param settings The loader settings.
+    /// \param stats If not nullptr, filled with load statistics.
+    /// \returns true if the log was loaded successfully.
+    static bool load(const std::string& filename,
+                     TimestampedSamples& samples,
+                     const Settings& settings = Settings(),
+                     LoadStats* stats = nullptr);
+
+    /// \brief Load a text log from memory.
+    /// \param data The text to parse.
+    /// \param size The size of the text in bytes.
+    /// \param samples The samples to fill.
+    /// \param settings The loader settings.
+    /// \param stats If not nullptr, filled with load statistics.
+    /// \returns true if any samples were loaded.
+    static bool load(const char* data,
+                     std::size_t size,
+                     TimestampedSamples& samples,
+                     const Settings& settings = Settings(),
+                     LoadStats* stats = nullptr);
+
+    /// \brief Parse a floating point number without allocating.
+    ///
+    /// Accepts an optional sign, digits with an optional fraction and an
+    /// optional exponent. Numbers with up to 19 significant digits and small
+    /// exponents are parsed exactly; others fall back to std::from_chars(),
+    /// or a stream in the classic locale where it is not available. Numbers
+    /// needing the fallback that are longer than 128 characters are rejected.
+    /// Numbers out of range parse as zero or infinity.
+    ///
+    /// \param first The first character, advanced past the number on success.
+    /// \param last One past the last character.
+    /// \param value The parsed value.
+    /// \returns true if a number was parsed.
+    static bool parseDouble(const char*& first, const char* last, double& value);
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A piecewise linear playback speed curve.
+///
+/// The curve maps real time to playback speed with keys that are linearly
+/// interpolated. Before the first key and after the last key the speed is
+/// constant. An empty curve has a speed of 1.
+///
+/// The media time elapsed over any real time interval is the integral of the
+/// speed. The integral up to each key is precomputed, so media times are
+/// evaluated exactly in O(log keys) regardless of the interval length. This
+/// avoids the aliasing of changing a scalar speed once per update.
+///
+/// Keys with equal times are ordered by insertion, so a step in speed is
+/// made with two keys at the same time.
+class TimeRemapCurve
+{
+public:
+    /// \brief Create an empty TimeRemapCurve.
+    TimeRemapCurve();
+
+    /// \brief Destroy the TimeRemapCurve.
+    virtual ~TimeRemapCurve();
+
+    /// \brief Add a key.
+    /// \param time The real time of the key in microseconds.
+    /// \param speed The playback speed at the key.
+    /// \returns the index of the added key.
+    std::size_t addKey(double time, double speed);
+
+    /// \brief Remove all keys.
+    void clear();
+
+    /// \returns the number of keys.
+    std::size_t size() const;
+
+    /// \param index The key index.
+    /// \returns the real time of the key in microseconds.
+    double keyTime(std::size_t index) const;
+
+    /// \param index The key index.
+    /// \returns the playback speed at the key.
+    double keySpeed(std::size_t index) const;
+
+    /// \param time The real time in microseconds.
+    /// \returns the playback speed at the given real time.
+    double speedAt(double time) const;
+
+    /// \brief Get the media time elapsed from real time 0.
+    ///
+    /// The result is negative for negative real times.
+    ///
+    /// \param time The real time in microseconds.
+    /// \returns the elapsed media time in microseconds.
+    double mediaTimeAt(double time) const;
+
+    /// \brief Get the media time elapsed between two real times.
+    /// \param from The start real time in microseconds.
+    /// \param to The end real time in microseconds.
+    /// \returns the elapsed media time in microseconds.
+    double mediaTimeBetween(double from, double to) const;
+
+private:
+    /// \param time The real time in microseconds.
+    /// \returns the index of the last key at or before the time, or 0.
+    std::size_t keyForTime(double time) const;
+
+    /// \brief Recompute the integrals from the given key.
+    /// \param index The first key to recompute.
+    void integrate(std::size_t index);
+
+    /// \brief The key times in microseconds.
+    std::vector<double> _times;
+
+    /// \brief The key speeds.
+    std::vector<double> _speeds;
+
+    /// \brief The media time elapsed from real time 0 to each key.
+    std::vector<double> _integrals;
+
+};
+
+
+} } // namespace ofx::Player
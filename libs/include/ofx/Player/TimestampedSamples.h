@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofx/Player/BasePlayerTypes.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A contiguous buffer of timestamped samples with numeric channels.
+///
+/// Timestamps are stored in one contiguous column and the channel values in a
+/// second contiguous, row-major array. Samples are accessed as lightweight
+/// views, so the buffer can be wrapped in a PlayableBufferHandle using the
+/// TimestampedSamples::Adapter:
+///
+///     PlayableBufferHandle<TimestampedSamples, TimestampedSamples::Adapter> handle(samples);
+///
+class TimestampedSamples
+{
+public:
+    /// \brief A view of a single sample.
+    class Sample
+    {
+    public:
+        /// \brief Create a Sample view.
+        /// \param timestamp The timestamp in microseconds.
+        /// \param values A pointer to the channel values.
+        /// \param channelCount The number of channel values.
+        Sample(double timestamp, const double* values, std::size_t channelCount):
+            _timestamp(timestamp),
+            _values(values),
+            _channelCount(channelCount)
+        {
+        }
+
+        /// \returns the timestamp in microseconds.
+        double timestamp() const
+        {
+            return _timestamp;
+        }
+
+        /// \param channel The channel index.
+        /// \returns the value of the given channel.
+        double operator [] (std::size_t channel) const
+        {
+            return _values[channel];
+        }
+
+        /// \returns a pointer to the channel values.
+        const double* values() const
+        {
+            return _values;
+        }
+
+        /// \returns the number of channel values.
+        std::size_t channelCount() const
+        {
+            return _channelCount;
+        }
+
+    private:
+        double _timestamp = 0;
+        const double* _values = nullptr;
+        std::size_t _channelCount = 0;
+
+    };
+
+    /// \brief An adapter for use with PlayableBufferHandle.
+    class Adapter
+    {
+    public:
+        static double timestamp(const Sample& sample)
+        {
+            return sample.timestamp();
+        }
+
+    };
+
+    /// \brief Create an empty TimestampedSamples.
+    /// \param channelCount The number of channels per sample.
+    TimestampedSamples(std::size_t channelCount = 0);
+
+    /// \brief Destroy the TimestampedSamples.
+    virtual ~TimestampedSamples();
+
+    /// \returns the number of samples.
+    std::size_t size() const;
+
+    /// \returns true if there are no samples.
+    bool empty() const;
+
+    /// \param index The sample index.
+    /// \returns a view of the sample at the given index.
+    Sample operator [] (std::size_t index) const;
+
+    /// \param index The sample index.
+    /// \returns the timestamp at the given index in microseconds.
+    double timestamp(std::size_t index) const
+    {
+        return _timestamps[index];
+    }
+
+    /// \param index The sample index.
+    /// \param channel The channel index.
+    /// \returns the value of the channel at the given index.
+    double value(std::size_t index, std::size_t channel) const
+    {
+        return _values[index * _channelCount + channel];
+    }
+
+    /// \returns the number of channels per sample.
+    std::size_t channelCount() const;
+
+    /// \brief Set the number of channels per sample.
+    ///
+    /// This clears all samples.
+    ///
+    /// \param channelCount The number of channels per sample.
+    void setChannelCount(std::size_t channelCount);
+
+    /// \returns the timestamp column.
+    const std::vector<double>& timestamps() const;
+
+    /// \returns the row-major channel values.
+    const std::vector<double>& values() const;
+
+    /// \brief Add a sample.
+    /// \param timestamp The timestamp in microseconds.
+    /// \param values The channel values, with channelCount() values.
+    void push_back(double timestamp, const double* values);
+
+    /// \brief Append all samples from another buffer with the same channels.
+    /// \param samples The samples to append.
+    void append(const TimestampedSamples& samples);
+
+    /// \returns true if the timestamps are in non-decreasing order.
+    bool isSorted() const;
+
+    /// \brief Stable sort the samples by timestamp.
+    void sort();
+
+    /// \brief Reserve space for samples.
+    /// \param size The number of samples.
+    void reserve(std::size_t size);
+
+    /// \brief Remove all samples.
+    void clear();
+
+private:
+    /// \brief The number of channels per sample.
+    std::size_t _channelCount = 0;
+
+    /// \brief The timestamps in microseconds.
+    std::vector<double> _timestamps;
+
+    /// \brief The row-major channel values.
+    std::vector<double> _values;
+
+};
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,266 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <iterator>
+#include "ofx/Player/IndexedFile.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief A memory-compact, sorted collection of timestamped URIs.
+///
+/// Timestamps are stored in a single contiguous column of integer
+/// microseconds. URIs are front coded:
+/// they are grouped into blocks of BLOCK_SIZE entries, the first URI in each
+/// block is stored in full and each following URI stores only the length of
+/// the prefix it shares with the previous URI and the remaining suffix. Since
+/// the URIs of a sequence usually share a directory and most of a timestamped
+/// filename, this typically uses a small fraction of the memory of a
+/// std::vector<TimestampedURI>.
+///
+/// Entries are reconstructed on demand as TimestampedURI values. Accessing a
+/// URI decodes at most BLOCK_SIZE entries, while accessing a timestamp is a
+/// direct lookup.
+class TimestampedURIIndex
+{
+public:
+    /// \brief A random access iterator that reconstructs entries on demand.
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef TimestampedURI value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef TimestampedURI reference;
+
+        /// \brief Create an iterator.
+        /// \param index The index to iterate.
+        /// \param position The current position.
+        const_iterator(const TimestampedURIIndex* index, std::size_t position):
+            _index(index),
+            _position(position)
+        {
+        }
+
+        TimestampedURI operator * () const
+        {
+            return (*_index)[_position];
+        }
+
+        TimestampedURI operator [] (difference_type offset) const
+        {
+            return (*_index)[_position + offset];
+        }
+
+        const_iterator& operator ++ ()
+        {
+            ++_position;
+            return *this;
+        }
+
+        const_iterator operator ++ (int)
+        {
+            const_iterator result = *this;
+            ++_position;
+            return result;
+        }
+
+        const_iterator& operator -- ()
+        {
+            --_position;
+            return *this;
+        }
+
+        const_iterator operator -- (int)
+        {
+            const_iterator result = *this;
+            --_position;
+            return result;
+        }
+
+        const_iterator& operator += (difference_type offset)
+        {
+            _position += offset;
+            return *this;
+        }
+
+        const_iterator& operator -= (difference_type offset)
+        {
+            _position -= offset;
+            return *this;
+        }
+
+        const_iterator operator + (difference_type offset) const
+        {
+            return const_iterator(_index, _position + offset);
+        }
+
+        const_iterator operator - (difference_type offset) const
+        {
+            return const_iterator(_index, _position - offset);
+        }
+
+        difference_type operator - (const const_iterator& other) const
+        {
+            return static_cast<difference_type>(_position) - static_cast<difference_type>(other._position);
+        }
+
+        bool operator == (const const_iterator& other) const
+        {
+            return _position == other._position;
+        }
+
+        bool operator != (const const_iterator& other) const
+        {
+            return _position != other._position;
+        }
+
+        bool operator < (const const_iterator& other) const
+        {
+            return _position < other._position;
+        }
+
+    private:
+        /// \brief The index being iterated.
+        const TimestampedURIIndex* _index = nullptr;
+
+        /// \brief The current position.
+        std::size_t _position = 0;
+
+    };
+
+    /// \brief Create an empty TimestampedURIIndex.
+    TimestampedURIIndex();
+
+    /// \brief Create a TimestampedURIIndex from sorted timestamped URIs.
+    /// \param images The timestamped URIs, sorted by timestamp.
+    TimestampedURIIndex(const std::vector<TimestampedURI>& images);
+
+    /// \brief Destroy the TimestampedURIIndex.
+    ~TimestampedURIIndex();
+
+    /// \returns the number of entries.
+    std::size_t size() const;
+
+    /// \returns true if there are no entries.
+    bool empty() const;
+
+    /// \brief Reconstruct the entry at the given index.
+    /// \param index The index of the entry.
+    /// \returns the timestamped URI at the index.
+    TimestampedURI operator [] (std::size_t index) const;
+
+    /// \param index The index of the entry.
+    /// \returns the timestamp at the index in microseconds.
+    double timestamp(std::size_t index) const
+    {
+        return static_cast<double>(_timestamps[index]);
+    }
+
+    /// \param index The index of the entry.
+    /// \returns the timestamp at the index in integer microseconds.
+    int64_t timestampMicros(std::size_t index) const
+    {
+        return _timestamps[index];
+    }
+
+    /// \brief Reconstruct the URI at the given index.
+    /// \param index The index of the entry.
+    /// \returns the URI at the index.
+    std::string uri(std::size_t index) const;
+
+    /// \returns the contiguous timestamp column in integer microseconds.
+    const std::vector<int64_t>& timestamps() const;
+
+    /// \returns an iterator to the first entry.
+    const_iterator begin() const;
+
+    /// \returns an iterator past the last entry.
+    const_iterator end() const;
+
+    /// \brief Append an entry.
+    ///
+    /// The timestamp should be greater than or equal to the last timestamp.
+    ///
+    /// \param image The timestamped URI to append.
+    void push_back(const TimestampedURI& image);
+
+    /// \brief Append an entry.
+    ///
+    /// The timestamp should be greater than or equal to the last timestamp.
+    ///
+    /// \param uri The URI to append.
+    /// \param timestamp The timestamp in integer microseconds.
+    void push_back(const std::string& uri, int64_t timestamp);
+
+    /// \brief Replace all entries.
+    /// \param images The timestamped URIs, sorted by timestamp.
+    void assign(const std::vector<TimestampedURI>& images);
+
+    /// \brief Merge sorted entries into the index.
+    ///
+    /// Entries with equal timestamps keep existing entries first.
+    ///
+    /// \param images The timestamped URIs to merge, sorted by timestamp.
+    void merge(const std::vector<TimestampedURI>& images);
+
+    /// \brief Remove all entries matching a predicate.
+    /// \param predicate A function taking a URI and a timestamp that returns
+    ///        true if the entry should be removed.
+    void removeIf(const std::function<bool(const std::string&, int64_t)>& predicate);
+
+    /// \brief Visit every entry in order.
+    ///
+    /// This decodes each URI once and is much faster than indexed access when
+    /// visiting every entry.
+    ///
+    /// \param visitor A function taking a URI and a timestamp in integer
+    ///        microseconds.
+    void forEach(const std::function<void(const std::string&, int64_t)>& visitor) const;
+
+    /// \brief Reserve space for the given number of entries.
+    /// \param size The number of entries to reserve.
+    void reserve(std::size_t size);
+
+    /// \brief Release unused capacity.
+    void shrink_to_fit();
+
+    /// \brief Remove all entries.
+    void clear();
+
+    /// \returns the approximate heap memory used in bytes.
+    std::size_t memoryUsage() const;
+
+    enum
+    {
+        /// \brief The number of entries in each front coded block.
+        BLOCK_SIZE = 16
+    };
+
+private:
+    /// \brief The timestamps in integer microseconds.
+    std::vector<int64_t> _timestamps;
+
+    /// \brief The front coded URI data.
+    std::vector<char> _data;
+
+    /// \brief The offset of each block in the URI data.
+    std::vector<uint64_t> _blockOffsets;
+
+    /// \brief The last URI appended, used to front code the next URI.
+    std::string _last;
+
+};
+
+
+} } // namespace ofx::Player
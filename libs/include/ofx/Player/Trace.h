@@ -0,0 +1,200 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+
+namespace ofx {
+namespace Player {
+
+
+/// \brief Record timeline events for the Chrome trace viewer and Perfetto.
+///
+/// Each thread records complete events into its own fixed size buffer. A
+/// buffer is only written by its thread, so recording is lock-free and does
+/// not allocate. Events recorded after a buffer is full are dropped and
+/// counted.
+///
+/// A thread's buffer is allocated when it first records an event while
+/// recording is enabled, so threads that never record cost no storage. The
+/// buffers of exited threads are kept until clear() discards their events.
+///
+/// The trace can be saved as Chrome trace JSON and opened with
+/// chrome://tracing or https://ui.perfetto.dev.
+///
+/// The OFX_PLAYER_TRACE_* macros used throughout the addon compile to
+/// nothing unless OFX_PLAYER_ENABLE_TRACING is defined. When compiled in,
+/// recording must also be enabled at runtime with Trace::setEnabled().
+class Trace
+{
+public:
+    /// \brief Enable or disable recording.
+    /// \param enabled True if events should be recorded.
+    static void setEnabled(bool enabled);
+
+    /// \returns true if events are recorded.
+    static bool isEnabled()
+    {
+        return enabled().load(std::memory_order_relaxed);
+    }
+
+    /// \brief Set the event capacity of each thread buffer.
+    ///
+    /// This only applies to threads that have not yet recorded an event.
+    ///
+    /// \param size The number of events per thread.
+    static void setBufferSize(std::size_t size);
+
+    /// \returns the event capacity of each thread buffer.
+    static std::size_t getBufferSize();
+
+    /// \brief Name the calling thread in the trace.
+    ///
+    /// This does not allocate the thread's event buffer.
+    ///
+    /// \param name The thread name.
+    static void setThreadName(const std::string& name);
+
+    /// \brief Record a complete event on the calling thread.
+    ///
+    /// The event is ignored if the thread has no buffer yet and recording
+    /// is disabled.
+    ///
+    /// \param name The event name. It must be a string literal.
+    /// \param start The start time in nanoseconds from now().
+    /// \param duration The duration in nanoseconds.
+    /// \param index An index to attach to the event, or -1 for none.
+    /// \param id The object the event belongs to, or nullptr for none.
+    static void record(const char* name,
+                       int64_t start,
+                       int64_t duration,
+                       int64_t index,
+                       const void* id = nullptr);
+
+    /// \returns the trace time in nanoseconds.
+    static int64_t now();
+
+    /// \brief Discard all recorded events.
+    ///
+    /// Each thread discards its events the next time it records, so events
+    /// recorded concurrently with this call are never mixed with older
+    /// events.
+    static void clear();
+
+    /// \returns the number of events that were dropped due to full buffers.
+    static uint64_t droppedCount();
+
+    /// \brief Save all recorded events as Chrome trace JSON.
+    ///
+    /// Events may be saved while other threads are recording. Only events
+    /// that were complete when the buffer was read are saved.
+    ///
+    /// \param filename The file to write.
+    /// \returns true if the file was written.
+    static bool save(const std::string& filename);
+
+    enum
+    {
+        /// \brief The default number of events per thread.
+        DEFAULT_BUFFER_SIZE = 65536
+    };
+
+private:
+    /// \returns the runtime enabled flag.
+    static std::atomic<bool>& enabled();
+
+};
+
+
+/// \brief Record a complete event for the lifetime of the scope.
+///
+/// The enabled state is sampled when the scope is created, so a scope is
+/// never recorded with a partial duration.
+///
+/// An id, such as the player or sequence that records the scope, is saved
+/// with the event so the events of several instances can be told apart.
+class TraceScope
+{
+public:
+    /// \brief Begin a scope.
+    /// \param name The event name. It must be a string literal.
+    /// \param index An index to attach to the event, or -1 for none.
+    /// \param id The object the event belongs to, or nullptr for none.
+    TraceScope(const char* name, int64_t index = -1, const void* id = nullptr):
+        _name(Trace::isEnabled() ? name : nullptr),
+        _index(index),
+        _id(id),
+        _start(_name != nullptr ? Trace::now() : 0)
+    {
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator = (const TraceScope&) = delete;
+
+    /// \brief End the scope and record the event.
+    ~TraceScope()
+    {
+        if (_name != nullptr)
+        {
+            Trace::record(_name, _start, Trace::now() - _start, _index, _id);
+        }
+    }
+
+private:
+    /// \brief The event name, or nullptr if the scope is not recorded.
+    const char* _name = nullptr;
+
+    /// \brief The index attached to the event.
+    int64_t _index = -1;
+
+    /// \brief The object the event belongs to.
+    const void* _id = nullptr;
+
+    /// \brief The start time in nanoseconds.
+    int64_t _start = 0;
+
+};
+
+
+} } // namespace ofx::Player
+
+
+#if defined(OFX_PLAYER_ENABLE_TRACING)
+#define OFX_PLAYER_TRACE_CONCAT_IMPL(a, b) a##b
+#define OFX_PLAYER_TRACE_CONCAT(a, b) OFX_PLAYER_TRACE_CONCAT_IMPL(a, b)
+
+/// \brief Record the enclosing scope as a trace event.
+#define OFX_PLAYER_TRACE_SCOPE(name) \
+    ofx::Player::TraceScope OFX_PLAYER_TRACE_CONCAT(_traceScope, __LINE__)(name)
+
+/// \brief Record the enclosing scope as a trace event with an index.
+#define OFX_PLAYER_TRACE_SCOPE_INDEX(name, index) \
+    ofx::Player::TraceScope OFX_PLAYER_TRACE_CONCAT(_traceScope, __LINE__)(name, static_cast<int64_t>(index))
+
+/// \brief Record the enclosing scope as a trace event of an object.
+#define OFX_PLAYER_TRACE_SCOPE_ID(name, id) \
+    ofx::Player::TraceScope OFX_PLAYER_TRACE_CONCAT(_traceScope, __LINE__)(name, -1, id)
+
+/// \brief Record the enclosing scope as a trace event of an object with an index.
+#define OFX_PLAYER_TRACE_SCOPE_ID_INDEX(name, id, index) \
+    ofx::Player::TraceScope OFX_PLAYER_TRACE_CONCAT(_traceScope, __LINE__)(name, static_cast<int64_t>(index), id)
+
+/// \brief Name the calling thread in the trace.
+#define OFX_PLAYER_TRACE_THREAD_NAME(name) \
+    ofx::Player::Trace::setThreadName(name)
+#else
+#define OFX_PLAYER_TRACE_SCOPE(name)
+#define OFX_PLAYER_TRACE_SCOPE_INDEX(name, index)
+#define OFX_PLAYER_TRACE_SCOPE_ID(name, id)
+#define OFX_PLAYER_TRACE_SCOPE_ID_INDEX(name, id, index)
+#define OFX_PLAYER_TRACE_THREAD_NAME(name)
+#endif
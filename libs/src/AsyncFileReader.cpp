@@ -0,0 +1,524 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/AsyncFileReader.h"
+#include "ofx/Player/Trace.h"
+#include "ofLog.h"
+#include <limits>
+
+
+#if defined(TARGET_LINUX) || defined(TARGET_OSX)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace Player {
+
+
+AsyncFileReader::AsyncFileReader(std::size_t capacity, std::size_t batchSize):
+    _capacity(std::max(capacity, std::size_t(1))),
+    _batchSize(std::max(batchSize, std::size_t(1)))
+{
+#if defined(OFX_PLAYER_USE_IO_URING)
+    int result = io_uring_queue_init(static_cast<unsigned>(_batchSize), &_ring, 0);
+
+    if (result == 0)
+    {
+        _ringInitialized = true;
+    }
+    else
+    {
+        ofLogWarning("AsyncFileReader::AsyncFileReader") << "Unable to initialize io_uring, falling back to blocking reads: " << -result;
+    }
+#endif
+
+    _thread = std::thread(&AsyncFileReader::run, this);
+}
+
+
+AsyncFileReader::~AsyncFileReader()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _running = false;
+        _requests.clear();
+    }
+
+    _condition.notify_all();
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+#if defined(OFX_PLAYER_USE_IO_URING)
+    if (_ringInitialized)
+    {
+        io_uring_queue_exit(&_ring);
+    }
+#endif
+}
+
+
+void AsyncFileReader::request(std::size_t key, const std::string& path)
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (_pending.find(key) != _pending.end()
+        ||  _buffers.find(key) != _buffers.end())
+        {
+            return;
+        }
+
+        // Drop the stalest request rather than letting the queue grow.
+        if (_requests.size() >= _capacity)
+        {
+            _pending.erase(_requests.front().key);
+            _requests.pop_front();
+        }
+
+        Request request;
+        request.key = key;
+        request.path = path;
+        request.generation = _generation;
+
+        _requests.push_back(std::move(request));
+        _pending.insert(key);
+    }
+
+    _condition.notify_one();
+}
+
+
+std::shared_ptr<ofBuffer> AsyncFileReader::take(std::size_t key)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto iter = _buffers.find(key);
+
+    if (iter != _buffers.end())
+    {
+        auto buffer = iter->second;
+        _buffers.erase(iter);
+        _bufferOrder.erase(std::find(_bufferOrder.begin(),
+                                     _bufferOrder.end(),
+                                     key));
+        return buffer;
+    }
+
+    return nullptr;
+}
+
+
+void AsyncFileReader::cancel()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (auto& request: _requests)
+    {
+        _pending.erase(request.key);
+    }
+
+    _requests.clear();
+}
+
+
+void AsyncFileReader::clear()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Reads in progress complete with the old generation and are discarded.
+    ++_generation;
+
+    _requests.clear();
+    _pending.clear();
+    _buffers.clear();
+    _bufferOrder.clear();
+}
+
+
+void AsyncFileReader::shift(std::size_t first, std::size_t offset)
+{
+    if (offset == 0)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Reads in progress complete with the old generation and are discarded.
+    ++_generation;
+
+    auto move = [first, offset](std::size_t key)
+    {
+        return key < first ? key : key + offset;
+    };
+
+    _pending.clear();
+
+    for (auto& request: _requests)
+    {
+        request.key = move(request.key);
+        request.generation = _generation;
+        _pending.insert(request.key);
+    }
+
+    std::unordered_map<std::size_t, std::shared_ptr<ofBuffer>> buffers;
+
+    for (auto& entry: _buffers)
+    {
+        buffers[move(entry.first)] = std::move(entry.second);
+    }
+
+    _buffers = std::move(buffers);
+
+    for (auto& key: _bufferOrder)
+    {
+        key = move(key);
+    }
+}
+
+
+std::size_t AsyncFileReader::capacity() const
+{
+    return _capacity;
+}
+
+
+bool AsyncFileReader::advise(const std::string& path)
+{
+#if defined(TARGET_LINUX)
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    bool success = (::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0);
+
+    ::close(fd);
+
+    return success;
+#elif defined(TARGET_OSX)
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+
+    bool success = false;
+
+    if (::fstat(fd, &info) == 0)
+    {
+        struct radvisory advisory;
+        advisory.ra_offset = 0;
+        advisory.ra_count = static_cast<int>(std::min<off_t>(info.st_size, std::numeric_limits<int>::max()));
+        success = (::fcntl(fd, F_RDADVISE, &advisory) != -1);
+    }
+
+    ::close(fd);
+
+    return success;
+#else
+    return false;
+#endif
+}
+
+
+bool AsyncFileReader::read(const std::string& path, ofBuffer& buffer)
+{
+    buffer = ofBufferFromFile(path, true);
+    return buffer.size() > 0;
+}
+
+
+void AsyncFileReader::run()
+{
+    OFX_PLAYER_TRACE_THREAD_NAME("AsyncFileReader");
+
+    std::vector<Request> batch;
+    std::vector<std::shared_ptr<ofBuffer>> buffers;
+    std::vector<std::string> advised;
+
+    while (true)
+    {
+        batch.clear();
+        advised.clear();
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _condition.wait(lock, [this]() {
+                return !_running || !_requests.empty();
+            });
+
+            if (!_running)
+            {
+                return;
+            }
+
+            while (!_requests.empty() && batch.size() < _batchSize)
+            {
+                batch.push_back(std::move(_requests.front()));
+                _requests.pop_front();
+            }
+
+            // Start kernel readahead for the next batch while this one is read.
+            for (std::size_t i = 0; i < _requests.size() && i < _batchSize; ++i)
+            {
+                if (!_requests[i].isAdvised)
+                {
+                    _requests[i].isAdvised = true;
+                    advised.push_back(_requests[i].path);
+                }
+            }
+        }
+
+        for (auto& request: batch)
+        {
+            if (!request.isAdvised)
+            {
+                advise(request.path);
+            }
+        }
+
+        for (auto& path: advised)
+        {
+            advise(path);
+        }
+
+        buffers.assign(batch.size(), nullptr);
+
+        {
+            OFX_PLAYER_TRACE_SCOPE_INDEX("AsyncFileReader::readBatch", batch.front().key);
+            readBatch(batch, buffers);
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            // If the generation changed, the keys were cleared or moved while
+            // the request was being read.
+            if (batch[i].generation != _generation)
+            {
+                continue;
+            }
+
+            if (_pending.erase(batch[i].key) == 0 || buffers[i] == nullptr)
+            {
+                continue;
+            }
+
+            while (_bufferOrder.size() >= _capacity)
+            {
+                _buffers.erase(_bufferOrder.front());
+                _bufferOrder.pop_front();
+            }
+
+            _buffers[batch[i].key] = buffers[i];
+            _bufferOrder.push_back(batch[i].key);
+        }
+    }
+}
+
+
+void AsyncFileReader::readBatch(const std::vector<Request>& batch,
+                                std::vector<std::shared_ptr<ofBuffer>>& buffers)
+{
+#if defined(OFX_PLAYER_USE_IO_URING)
+    if (_ringInitialized && !_isRingFailed)
+    {
+        // The completion data of cancellations, which is never a batch index.
+        void* const cancelData = reinterpret_cast<void*>(std::numeric_limits<uintptr_t>::max());
+
+        std::vector<int> descriptors(batch.size(), -1);
+        std::vector<std::size_t> sizes(batch.size(), 0);
+        std::size_t submitted = 0;
+
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            int fd = ::open(batch[i].path.c_str(), O_RDONLY);
+
+            struct stat info;
+
+            if (fd < 0 || ::fstat(fd, &info) != 0 || info.st_size <= 0)
+            {
+                if (fd >= 0)
+                {
+                    ::close(fd);
+                }
+
+                continue;
+            }
+
+            io_uring_sqe* sqe = io_uring_get_sqe(&_ring);
+
+            if (sqe == nullptr)
+            {
+                ::close(fd);
+                continue;
+            }
+
+            descriptors[i] = fd;
+            sizes[i] = static_cast<std::size_t>(info.st_size);
+            buffers[i] = std::make_shared<ofBuffer>();
+            buffers[i]->allocate(sizes[i]);
+
+            io_uring_prep_read(sqe, fd, buffers[i]->getData(), sizes[i], 0);
+            io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(i));
+            ++submitted;
+        }
+
+        // Reads that were submitted but not reaped may still write into
+        // their buffers, so their buffers and descriptors are only released
+        // once their completions have been seen.
+        std::size_t outstanding = 0;
+
+        if (submitted > 0)
+        {
+            int result = io_uring_submit(&_ring);
+
+            outstanding = result > 0 ? static_cast<std::size_t>(result) : 0;
+
+            if (outstanding < submitted)
+            {
+                // The remaining reads stay queued in the ring and could be
+                // submitted later, so the ring is not used again.
+                ofLogError("AsyncFileReader::readBatch") << "Unable to submit reads, falling back to blocking reads: " << result;
+                _isRingFailed = true;
+                outstanding = submitted;
+            }
+        }
+
+        std::vector<bool> completed(batch.size(), false);
+
+        bool isCancelled = false;
+
+        while (!_isRingFailed && outstanding > 0)
+        {
+            io_uring_cqe* cqe = nullptr;
+
+            int result = 0;
+
+            do
+            {
+                result = io_uring_wait_cqe(&_ring, &cqe);
+            }
+            while (result == -EINTR);
+
+            if (result != 0)
+            {
+                ofLogError("AsyncFileReader::readBatch") << "Unable to wait for completion: " << -result;
+
+                if (isCancelled)
+                {
+                    _isRingFailed = true;
+                    break;
+                }
+
+                // Cancel the outstanding reads and keep reaping until every
+                // read has completed or been cancelled.
+                for (std::size_t i = 0; i < batch.size(); ++i)
+                {
+                    io_uring_sqe* sqe = nullptr;
+
+                    if (descriptors[i] >= 0
+                    &&  !completed[i]
+                    &&  (sqe = io_uring_get_sqe(&_ring)) != nullptr)
+                    {
+                        io_uring_prep_cancel(sqe, reinterpret_cast<void*>(i), 0);
+                        io_uring_sqe_set_data(sqe, cancelData);
+                    }
+                }
+
+                io_uring_submit(&_ring);
+                isCancelled = true;
+                continue;
+            }
+
+            void* data = io_uring_cqe_get_data(cqe);
+            int bytes = cqe->res;
+
+            io_uring_cqe_seen(&_ring, cqe);
+
+            // Cancellations may complete after the batch they cancelled.
+            if (data == cancelData)
+            {
+                continue;
+            }
+
+            std::size_t i = reinterpret_cast<std::size_t>(data);
+
+            if (i >= batch.size() || completed[i])
+            {
+                continue;
+            }
+
+            completed[i] = true;
+            --outstanding;
+
+            // Treat errors and short reads as failures. The caller will fall
+            // back to a blocking read when decoding.
+            if (bytes < 0 || static_cast<std::size_t>(bytes) != sizes[i])
+            {
+                buffers[i].reset();
+            }
+        }
+
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            if (descriptors[i] < 0 || completed[i])
+            {
+                continue;
+            }
+
+            if (outstanding > 0)
+            {
+                // The kernel may still write into the buffer, so it and its
+                // descriptor are deliberately leaked.
+                new std::shared_ptr<ofBuffer>(std::move(buffers[i]));
+                descriptors[i] = -1;
+            }
+
+            buffers[i].reset();
+        }
+
+        for (auto fd: descriptors)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+
+        return;
+    }
+#endif
+
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        auto buffer = std::make_shared<ofBuffer>();
+
+        if (read(batch[i].path, *buffer))
+        {
+            buffers[i] = buffer;
+        }
+    }
+}
+
+
+} } // namespace ofx::Player
@@ -6,7 +6,9 @@
 
 
 #include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/CueIndex.h"
 #include "ofx/Player/PlayerUtils.h"
+#include "ofx/Player/Trace.h"
 
 
 namespace ofx {
@@ -46,7 +48,7 @@ std::size_t BaseTimeIndexed::indexForPosition(double position,
 
 double BaseTimeIndexed::timeForPosition(double position) const
 {
-    return startTime() + (position / duration());
+    return startTime() + position * duration();
 }
 
 
@@ -60,117 +62,397 @@ std::size_t BaseTimeIndexed::indexForTime(double time,
                                           bool increasing,
                                           std::size_t indexHint) const
 {
-    std::size_t index = 0;
+    const int64_t* timestamps = timestampMicrosData();
 
-    if (time >= endTime())
+    if (timestamps != nullptr)
     {
-        index = size() - 1;
+        return SearchUtils::indexForTime([timestamps](std::size_t index) {
+                                             return timestamps[index];
+                                         },
+                                         size(),
+                                         time,
+                                         increasing,
+                                         indexHint);
     }
-    else if (time <= startTime())
+
+    return SearchUtils::indexForTime([this](std::size_t index) {
+                                         return timeForIndex(index);
+                                     },
+                                     size(),
+                                     time,
+                                     increasing,
+                                     indexHint);
+}
+
+
+void BaseTimeIndexed::indexesForTimes(const double* times,
+                                      std::size_t count,
+                                      bool increasing,
+                                      std::size_t* indexes) const
+{
+    const double* timestamps = timestampData();
+    const int64_t* timestampsMicros = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        SearchUtils::indexesForTimesInColumn(timestamps,
+                                             size(),
+                                             times,
+                                             count,
+                                             increasing,
+                                             indexes);
+    }
+    else if (timestampsMicros != nullptr)
+    {
+        SearchUtils::indexesForTimesInColumn(timestampsMicros,
+                                             size(),
+                                             times,
+                                             count,
+                                             increasing,
+                                             indexes);
+    }
+    else
+    {
+        SearchUtils::indexesForTimes([this](std::size_t index) {
+                                         return timeForIndex(index);
+                                     },
+                                     size(),
+                                     times,
+                                     count,
+                                     increasing,
+                                     indexes);
+    }
+}
+
+
+const double* BaseTimeIndexed::timestampData() const
+{
+    return nullptr;
+}
+
+
+double BaseTimeIndexed::positionForTime(double time, bool clamp) const
+{
+    if (clamp)
     {
-        index = 0;
+        return std::max(0.0, std::min((time - startTime()) / duration(), 1.0));
     }
     else
     {
-        std::size_t indexMin = 0;
-        std::size_t indexMax = size();
+        return (time - startTime()) / duration();
+    }
+}
+
+
+std::size_t BaseTimeIndexed::upperBound(double time, std::size_t indexHint) const
+{
+    const int64_t* timestamps = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        return SearchUtils::upperBound([timestamps](std::size_t index) {
+                                           return timestamps[index];
+                                       },
+                                       size(),
+                                       time,
+                                       indexHint);
+    }
+
+    return SearchUtils::upperBound([this](std::size_t index) {
+                                       return timeForIndex(index);
+                                   },
+                                   size(),
+                                   time,
+                                   indexHint);
+}
+
+
+std::size_t BaseTimeIndexed::lowerBound(double time, std::size_t indexHint) const
+{
+    const int64_t* timestamps = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        return SearchUtils::lowerBound([timestamps](std::size_t index) {
+                                           return timestamps[index];
+                                       },
+                                       size(),
+                                       time,
+                                       indexHint);
+    }
+
+    return SearchUtils::lowerBound([this](std::size_t index) {
+                                       return timeForIndex(index);
+                                   },
+                                   size(),
+                                   time,
+                                   indexHint);
+}
+
+
+int64_t BaseTimeIndexed::timeForIndexMicros(std::size_t index) const
+{
+    return TimeUtils::roundMicros(timeForIndex(index));
+}
+
+
+const int64_t* BaseTimeIndexed::timestampMicrosData() const
+{
+    return nullptr;
+}
+
+
+int64_t BaseTimeIndexed::startTimeMicros() const
+{
+    return size() > 0 ? timeForIndexMicros(0) : -1;
+}
 
-        // Going forward?
-        if (increasing)
+
+int64_t BaseTimeIndexed::endTimeMicros() const
+{
+    return size() > 0 ? timeForIndexMicros(size() - 1) : -1;
+}
+
+
+std::size_t BaseTimeIndexed::indexForTimeMicros(int64_t time,
+                                                bool increasing,
+                                                std::size_t indexHint) const
+{
+    const int64_t* timestamps = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        return SearchUtils::indexForTime([timestamps](std::size_t index) {
+                                             return timestamps[index];
+                                         },
+                                         size(),
+                                         time,
+                                         increasing,
+                                         indexHint);
+    }
+
+    return SearchUtils::indexForTime([this](std::size_t index) {
+                                         return timeForIndexMicros(index);
+                                     },
+                                     size(),
+                                     time,
+                                     increasing,
+                                     indexHint);
+}
+
+
+void BaseTimeIndexed::indexesForTimesMicros(const int64_t* times,
+                                            std::size_t count,
+                                            bool increasing,
+                                            std::size_t* indexes) const
+{
+    const int64_t* timestamps = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        SearchUtils::indexesForTimesInColumn(timestamps,
+                                             size(),
+                                             times,
+                                             count,
+                                             increasing,
+                                             indexes);
+    }
+    else
+    {
+        SearchUtils::indexesForTimes([this](std::size_t index) {
+                                         return timeForIndexMicros(index);
+                                     },
+                                     size(),
+                                     times,
+                                     count,
+                                     increasing,
+                                     indexes);
+    }
+}
+
+
+std::size_t BaseTimeIndexed::upperBoundMicros(int64_t time, std::size_t indexHint) const
+{
+    const int64_t* timestamps = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        return SearchUtils::upperBound([timestamps](std::size_t index) {
+                                           return timestamps[index];
+                                       },
+                                       size(),
+                                       time,
+                                       indexHint);
+    }
+
+    return SearchUtils::upperBound([this](std::size_t index) {
+                                       return timeForIndexMicros(index);
+                                   },
+                                   size(),
+                                   time,
+                                   indexHint);
+}
+
+
+std::size_t BaseTimeIndexed::lowerBoundMicros(int64_t time, std::size_t indexHint) const
+{
+    const int64_t* timestamps = timestampMicrosData();
+
+    if (timestamps != nullptr)
+    {
+        return SearchUtils::lowerBound([timestamps](std::size_t index) {
+                                           return timestamps[index];
+                                       },
+                                       size(),
+                                       time,
+                                       indexHint);
+    }
+
+    return SearchUtils::lowerBound([this](std::size_t index) {
+                                       return timeForIndexMicros(index);
+                                   },
+                                   size(),
+                                   time,
+                                   indexHint);
+}
+
+
+double DefaultBufferAdapter::timestamp(const AbstractTimestamped& input)
+{
+    return input.timestamp();
+}
+
+
+bool TimeSpans::advance(double& time,
+                        bool& playingForward,
+                        ofLoopType loopType,
+                        double elapsedTime,
+                        double loopStartTime,
+                        double loopEndTime,
+                        bool includeStart)
+{
+    double loopDuration = loopEndTime - loopStartTime;
+    double distance = std::abs(elapsedTime);
+    bool increasing = (elapsedTime > 0);
+
+    if (loopType == OF_LOOP_NORMAL && loopDuration > 0)
+    {
+        // Wrap the playhead into the loop if the loop points moved.
+        if (time < loopStartTime || time > loopEndTime)
         {
-            if (timeForIndex(indexHint) <= time)
-            {
-                indexMin = indexHint;
-                indexMax = size();
-            }
-            else
-            {
-                indexMin = 0;
-                indexMax = indexHint;
-            }
+            time -= loopDuration * std::floor((time - loopStartTime) / loopDuration);
+            includeStart = true;
+        }
 
-            for (std::size_t i = indexMin; i < indexMax; ++i)
-            {
-                if (timeForIndex(i) > time)
-                {
-                    break;
-                }
-                else
-                {
-                    index = i;
-                }
-            }
+        double edge = increasing ? loopEndTime : loopStartTime;
+        double restart = increasing ? loopStartTime : loopEndTime;
+        double toEdge = std::abs(edge - time);
+
+        if (distance <= toEdge)
+        {
+            add(time, time + elapsedTime, includeStart, 1);
+            time += elapsedTime;
         }
         else
         {
-            if (timeForIndex(indexHint) >= time)
-            {
-                indexMin = indexHint;
-                indexMax = 0;
-            }
-            else
+            add(time, edge, includeStart, 1);
+
+            double remaining = distance - toEdge;
+            double cycles = std::floor(remaining / loopDuration);
+            remaining -= cycles * loopDuration;
+
+            // Landing exactly on the edge stops there, as it does without a
+            // wrap, rather than wrapping to the restart point.
+            if (remaining == 0 && cycles > 0)
             {
-                indexMin = size() - 1;
-                indexMax = indexHint;
+                cycles -= 1;
+                remaining = loopDuration;
             }
 
-            for (std::size_t i = indexMin; i != static_cast<std::size_t>(indexMax - 1); --i)
+            if (cycles > 0)
             {
-                if (timeForIndex(i) < time)
-                {
-                    break;
-                }
-                else
-                {
-                    index = i;
-                }
+                add(restart, edge, true, static_cast<std::size_t>(cycles));
             }
+
+            double next = increasing ? restart + remaining : restart - remaining;
+            add(restart, next, true, 1);
+            time = next;
         }
     }
+    else if (loopType == OF_LOOP_PALINDROME && loopDuration > 0)
+    {
+        if (time < loopStartTime || time > loopEndTime)
+        {
+            time = std::max(loopStartTime, std::min(time, loopEndTime));
+            includeStart = true;
+        }
 
-    return index;
+        double edge = increasing ? loopEndTime : loopStartTime;
+        double toEdge = std::abs(edge - time);
 
-//    std::function<std::size_t (std::size_t, std::size_t, double, bool)> search;
-//    search = [this, &search](std::size_t start,
-//                             std::size_t end,
-//                             double timestamp,
-//                             bool searchForward)->std::size_t
-//    {
-//        // Find the middle element of the vector and use that for splitting
-//        // the array into two pieces.
-//        const int middle = start + ((end - start) / 2);
-//
-//        if (timeAtIndex(middle) == timestamp)
-//        {
-//            return middle;
-//        }
-//        else if (timeAtIndex(middle) > timestamp)
-//        {
-//            return search(start, middle - 1, timestamp);
-//        }
-//
-//        return search(middle + 1, end, timestamp);
-//    };
+        if (distance <= toEdge)
+        {
+            add(time, time + elapsedTime, includeStart, 1);
+            time += elapsedTime;
+        }
+        else
+        {
+            add(time, edge, includeStart, 1);
 
-}
+            double remaining = distance - toEdge;
 
+            // Reflect off of the edge.
+            increasing = !increasing;
+            playingForward = !playingForward;
 
-double BaseTimeIndexed::positionForTime(double time, bool clamp) const
-{
-    if (clamp)
-    {
-        return std::max(0.0, std::min((time - startTime()) / duration(), 1.0));
+            double from = edge;
+            double to = increasing ? loopEndTime : loopStartTime;
+            double legs = std::floor(remaining / loopDuration);
+            remaining -= legs * loopDuration;
+
+            if (legs > 0)
+            {
+                add(from, to, false, static_cast<std::size_t>(legs));
+
+                // An odd number of legs ends on the opposite edge.
+                if (std::fmod(legs, 2.0) != 0)
+                {
+                    from = to;
+                    increasing = !increasing;
+                    playingForward = !playingForward;
+                }
+            }
+
+            double next = increasing ? from + remaining : from - remaining;
+            add(from, next, false, 1);
+            time = next;
+        }
     }
     else
     {
-        return (time - startTime()) / duration();
+        // Add the elapsed time and clamp it.
+        double next = std::max(loopStartTime, std::min(time + elapsedTime, loopEndTime));
+        add(time, next, includeStart, 1);
+        time = next;
     }
+
+    return increasing;
 }
 
 
-double DefaultBufferAdapter::timestamp(const AbstractTimestamped& input)
+void TimeSpans::add(double from,
+                    double to,
+                    bool includesFrom,
+                    std::size_t repeat)
 {
-    return input.timestamp();
+    if (_size < _spans.size())
+    {
+        TimeSpan& span = _spans[_size++];
+        span.from = from;
+        span.to = to;
+        span.includesFrom = includesFrom;
+        span.repeat = repeat;
+    }
 }
 
 
@@ -181,6 +463,28 @@ BasePlayer::~BasePlayer()
 
 void BasePlayer::update()
 {
+    auto now = std::chrono::high_resolution_clock::now();
+
+    double elapsedRealTime = 0;
+
+    if (!_isFirstUpdate)
+    {
+        elapsedRealTime = std::chrono::duration_cast<micros_duration>(now - _lastUpdateTime).count();
+    }
+
+    _lastUpdateTime = now;
+
+    update(elapsedRealTime);
+}
+
+
+void BasePlayer::update(double elapsedRealTime)
+{
+    OFX_PLAYER_TRACE_SCOPE_ID("BasePlayer::update", this);
+
+    _spans.clear();
+    _isCrossedIndexRangesValid = false;
+
     // If it's not loaded, no data, or not playing there is nothing to do.
     if (!isLoaded() || indexedData()->size() == 0 || !isPlaying())
     {
@@ -189,148 +493,376 @@ void BasePlayer::update()
 
     auto now = std::chrono::high_resolution_clock::now();
 
+    // The starting sample is only crossed on the first update.
+    bool isFirstUpdate = _isFirstUpdate;
+
     // Begin calculating frame updates.
     if (_isFirstUpdate)
     {
         _firstUpdateTime = now;
-        _lastUpdateTime = now;
 
-        if (_time < 0)
-        {
-            _time = startTime();
-        }
-
-        if (_lastTime < 0)
-        {
-            _lastTime = endTime();
-        }
-
-        _lastFrameIndex = std::numeric_limits<std::size_t>::max();
+        _playhead.start(*indexedData());
 
         _isFirstUpdate = false;
     }
 
-    // Calculate the elapsed real-time.
-    double elapsedRealTime = std::chrono::duration_cast<micros_duration>(now - _lastUpdateTime).count();
+    _lastUpdateInterval = elapsedRealTime;
 
-    _lastUpdateTime = now;
+    if (_paused)
+    {
+        elapsedRealTime = 0;
+    }
 
     // Calculate the elapsed time. Can be negative.
-    double elapsedTime = _speed * elapsedRealTime;
+    double elapsedTime = mediaTimeForRealTime(elapsedRealTime);
 
-    if (!_playingForward)
+    if (_timeRemap != nullptr)
     {
-        elapsedTime *= -1.0;
+        _timeRemapTime += elapsedRealTime;
     }
 
-    // Are we increasing?
-    bool increasing = (elapsedTime > 0);
+    const BaseTimeIndexed* data = indexedData();
+
+    constrainPlayhead(elapsedTime);
+
+    _lastTime = getTime();
 
-    // Set the uncorrected time.
-    _time += elapsedTime;
+    bool increasing = _playhead.advance(*data, _spans, elapsedTime, isFirstUpdate);
 
-    double loopStartTime = getLoopStartTime();
-    double loopEndTime = getLoopEndTime();
+    _playhead.updateFrameIndex(*data, increasing);
 
-    if (loopStartTime < 0)
+    if (_cues != nullptr)
     {
-        loopStartTime = startTime();
+        _cues->notify(*this);
     }
 
-    if (loopEndTime < 0)
+    if (_isStatsEnabled)
     {
-        loopEndTime = endTime();
+        recordStats(now);
     }
+}
 
-    double loopDuration = loopEndTime - loopStartTime;
 
-    // TODO: determine if there are any frames available during our loop points ...
+const IndexRanges& BasePlayer::getCrossedIndexRanges() const
+{
+    if (_isCrossedIndexRangesValid)
+    {
+        return _crossedIndexRanges;
+    }
+
+    _crossedIndexRanges.clear();
 
-    if (_loopType == OF_LOOP_NORMAL)
+    if (isLoaded())
     {
-        auto wrap = [](double time, double fromTime, double toTime)
-        {
-            if (fromTime > toTime)
-            {
-                std::swap(fromTime, toTime);
-            }
+        const BaseTimeIndexed* data = indexedData();
 
-            double cycle = toTime - fromTime;
+        std::size_t indexHint = _playhead.frameIndex < data->size() ? _playhead.frameIndex : 0;
 
-            if (ofxIsFloatEqual(cycle, 0.0))
-            {
-                return toTime;
-            }
+        getCrossedIndexRanges(*data, _crossedIndexRanges, indexHint);
+    }
 
-            return time - cycle * std::floor((time - fromTime) / cycle);
-        };
+    _isCrossedIndexRangesValid = true;
 
-        // Add the elapsed time and wrap it.
-        _time = wrap(_time + elapsedTime, loopStartTime, loopEndTime);
+    return _crossedIndexRanges;
+}
+
+
+std::size_t BasePlayer::getFramesIntended() const
+{
+    std::size_t frames = 0;
 
+    for (const IndexRange& range: getCrossedIndexRanges())
+    {
+        frames += range.size() * range.repeat();
     }
-    else if (_loopType == OF_LOOP_PALINDROME)
+
+    return frames;
+}
+
+
+std::size_t BasePlayer::getFramesShown() const
+{
+    return (isLoaded() && _playhead.isFrameIndexNew) ? 1 : 0;
+}
+
+
+std::size_t BasePlayer::getFramesDropped() const
+{
+    std::size_t intended = getFramesIntended();
+    std::size_t shown = getFramesShown();
+    return intended > shown ? intended - shown : 0;
+}
+
+
+double BasePlayer::getPresentationError() const
+{
+    if (!isLoaded() || _playhead.frameIndex >= indexedData()->size() || _playhead.timeMicros < 0)
     {
-        // Check if we are outside of the range and palindrome wrap if needed.
-        if (_time < loopStartTime || _time > loopEndTime)
-        {
-            double overshoot = 0;
+        return 0;
+    }
 
-            if (_time > loopEndTime)
-            {
-                overshoot = (_time - loopEndTime);
-            }
-            else
-            {
-                overshoot = (loopStartTime - _time);
-            }
+    return static_cast<double>(indexedData()->timeForIndexMicros(_playhead.frameIndex) - _playhead.timeMicros) - _playhead.timeFraction;
+}
 
-            // Reduce overshoot by folding.
-            while (overshoot > loopDuration)
-            {
-                overshoot -= loopDuration;
-                _playingForward = !_playingForward;
-            }
 
-            if (_playingForward)
-            {
-                _time = (loopEndTime - overshoot);
-            }
-            else
-            {
-                _time = (loopStartTime + overshoot);
-            }
+void BasePlayer::getCrossedIndexRanges(const BaseTimeIndexed& indexed,
+                                       IndexRanges& ranges,
+                                       std::size_t indexHint) const
+{
+    _spans.crossedIndexRanges(indexed, ranges, indexHint);
+}
 
-            _playingForward = !_playingForward;
-        }
+
+void BasePlayer::setTimeRemap(std::shared_ptr<const TimeRemapCurve> curve)
+{
+    _timeRemap = curve;
+    _timeRemapTime = 0;
+}
+
+
+std::shared_ptr<const TimeRemapCurve> BasePlayer::getTimeRemap() const
+{
+    return _timeRemap;
+}
+
+
+double BasePlayer::getTimeRemapTime() const
+{
+    return _timeRemapTime;
+}
+
+
+double BasePlayer::getLastUpdateInterval() const
+{
+    return _lastUpdateInterval;
+}
+
+
+double BasePlayer::getElapsedMediaTime(double elapsedRealTime) const
+{
+    if (!isPlaying() || _paused)
+    {
+        return 0;
     }
-    else
+
+    return mediaTimeForRealTime(elapsedRealTime);
+}
+
+
+double BasePlayer::predictTime(double elapsedRealTime) const
+{
+    TimeSpans spans;
+    Playhead<BaseTimeIndexed> playhead;
+    predict(elapsedRealTime, spans, playhead);
+    return playhead.time();
+}
+
+
+int64_t BasePlayer::predictTimeMicros(double elapsedRealTime) const
+{
+    TimeSpans spans;
+    Playhead<BaseTimeIndexed> playhead;
+    predict(elapsedRealTime, spans, playhead);
+    return playhead.timeMicros;
+}
+
+
+std::size_t BasePlayer::predictFrameIndex(double elapsedRealTime) const
+{
+    if (!isLoaded() || indexedData()->size() == 0)
     {
-        // Add the elapsed time and clamp it.
-        _time = std::max(loopStartTime, std::min(_time + elapsedTime, loopEndTime));
+        return _playhead.frameIndex;
+    }
+
+    TimeSpans spans;
+    Playhead<BaseTimeIndexed> playhead;
+    bool increasing = predict(elapsedRealTime, spans, playhead);
+
+    const BaseTimeIndexed* data = indexedData();
+
+    std::size_t indexHint = _playhead.frameIndex < data->size() ? _playhead.frameIndex : 0;
+
+    return playhead.search(*data, increasing, indexHint);
+}
+
+
+void BasePlayer::getPredictedIndexRanges(const BaseTimeIndexed& indexed,
+                                         double elapsedRealTime,
+                                         IndexRanges& ranges,
+                                         std::size_t indexHint) const
+{
+    TimeSpans spans;
+    Playhead<BaseTimeIndexed> playhead;
+    predict(elapsedRealTime, spans, playhead);
+    spans.crossedIndexRanges(indexed, ranges, indexHint);
+}
+
+
+void BasePlayer::setCueIndex(std::shared_ptr<CueIndex> cues)
+{
+    _cues = cues;
+}
+
+
+std::shared_ptr<CueIndex> BasePlayer::getCueIndex() const
+{
+    return _cues;
+}
+
+
+void BasePlayer::setStatsEnabled(bool enabled)
+{
+    _isStatsEnabled = enabled;
+    _lastStatsTime = std::chrono::high_resolution_clock::now();
+}
+
+
+bool BasePlayer::isStatsEnabled() const
+{
+    return _isStatsEnabled;
+}
+
+
+PlayerStats BasePlayer::getStats() const
+{
+    PlayerStats stats = _stats;
+    stats.updateDuration = _updateDuration.snapshot();
+    stats.presentationError = _presentationError.snapshot();
+    return stats;
+}
+
+
+void BasePlayer::resetStats()
+{
+    _stats = PlayerStats();
+    _updateDuration.reset();
+    _presentationError.reset();
+}
+
+
+void BasePlayer::setStatsInterval(double interval)
+{
+    _statsInterval = interval;
+}
+
+
+double BasePlayer::getStatsInterval() const
+{
+    return _statsInterval;
+}
+
+
+void BasePlayer::notifyStats()
+{
+    PlayerStats stats = getStats();
+    ofNotifyEvent(onStats, stats, this);
+}
+
+
+void BasePlayer::constrainPlayhead(double)
+{
+}
+
+
+std::size_t BasePlayer::readaheadIndex(bool increasing) const
+{
+    std::size_t index = predictFrameIndex(_lastUpdateInterval);
+
+    if (index == _playhead.frameIndex)
+    {
+        return index;
+    }
+
+    // Step back so the predicted frame itself is read ahead.
+    if (increasing)
+    {
+        return index > 0 ? index - 1 : index;
     }
 
-    _frameIndex = indexForTime(_time, increasing, _lastFrameIndex);
-    _isFrameIndexNew = (_lastFrameIndex != _frameIndex);
-    _lastFrameIndex = _frameIndex;
+    return index + 1 < size() ? index + 1 : index;
+}
+
+
+double BasePlayer::mediaTimeForRealTime(double elapsedRealTime) const
+{
+    double elapsedTime = _timeRemap != nullptr ? _timeRemap->mediaTimeBetween(_timeRemapTime, _timeRemapTime + elapsedRealTime)
+                                               : _speed * elapsedRealTime;
+
+    return _playhead.playingForward ? elapsedTime : -elapsedTime;
+}
+
+
+bool BasePlayer::predict(double elapsedRealTime,
+                         TimeSpans& spans,
+                         Playhead<BaseTimeIndexed>& playhead) const
+{
+    playhead = _playhead;
+
+    if (!isLoaded() || indexedData()->size() == 0)
+    {
+        return playhead.playingForward;
+    }
+
+    // The first update starts at the beginning and crosses it.
+    if (_isFirstUpdate)
+    {
+        playhead.start(*indexedData());
+    }
+
+    return playhead.advance(*indexedData(),
+                            spans,
+                            getElapsedMediaTime(elapsedRealTime),
+                            _isFirstUpdate);
+}
+
+
+void BasePlayer::recordStats(std::chrono::high_resolution_clock::time_point updateStartTime)
+{
+    uint64_t framesIntended = getFramesIntended();
+    uint64_t framesShown = getFramesShown();
+    uint64_t framesDropped = framesIntended > framesShown ? framesIntended - framesShown : 0;
+    double presentationError = getPresentationError();
+
+    ++_stats.updates;
+    _stats.framesIntended += framesIntended;
+    _stats.framesShown += framesShown;
+    _stats.framesDropped += framesDropped;
+    _stats.lastFramesIntended = framesIntended;
+    _stats.lastFramesShown = framesShown;
+    _stats.lastFramesDropped = framesDropped;
+    _stats.maxFramesDropped = std::max(_stats.maxFramesDropped, framesDropped);
+    _stats.lastPresentationError = presentationError;
+
+    _presentationError.add(std::abs(presentationError));
+
+    auto now = std::chrono::high_resolution_clock::now();
+
+    _updateDuration.add(std::chrono::duration_cast<micros_duration>(now - updateStartTime).count());
+
+    if (std::chrono::duration_cast<micros_duration>(now - _lastStatsTime).count() >= _statsInterval)
+    {
+        _lastStatsTime = now;
+        notifyStats();
+    }
 }
 
 
 bool BasePlayer::isFrameIndexNew() const
 {
-    return _isFrameIndexNew;
+    return _playhead.isFrameIndexNew;
 }
 
 
 double BasePlayer::getSpeed() const
 {
-    return _speed;
+    return _timeRemap != nullptr ? _timeRemap->speedAt(_timeRemapTime) : _speed;
 }
 
 
 void BasePlayer::setSpeed(double speed)
 {
     _speed = speed;
+    _timeRemap = nullptr;
 }
 
 
@@ -348,25 +880,58 @@ void BasePlayer::setPosition(double position)
 
 double BasePlayer::getTime() const
 {
-    return _time;
+    return _playhead.time();
 }
 
 
 void BasePlayer::setTime(double time)
 {
-    _time = std::max(startTime(), std::min(time, endTime()));
+    if (isLoaded())
+    {
+        _playhead.setTime(*indexedData(), time);
+    }
+    else
+    {
+        ofLogError("BasePlayer::setTime") << "The data is not loaded.";
+    }
+}
+
+
+int64_t BasePlayer::getTimeMicros() const
+{
+    return _playhead.timeMicros;
+}
+
+
+void BasePlayer::setTimeMicros(int64_t time)
+{
+    if (isLoaded())
+    {
+        _playhead.setTimeMicros(*indexedData(), time);
+    }
+    else
+    {
+        ofLogError("BasePlayer::setTimeMicros") << "The data is not loaded.";
+    }
 }
 
 
 std::size_t BasePlayer::getFrameIndex() const
 {
-    return _frameIndex;
+    return _playhead.frameIndex;
 }
 
 
 void BasePlayer::setFrameIndex(std::size_t index)
 {
-    setTime(timeForIndex(index));
+    if (isLoaded())
+    {
+        setTimeMicros(indexedData()->timeForIndexMicros(index));
+    }
+    else
+    {
+        ofLogError("BasePlayer::setFrameIndex") << "The data is not loaded.";
+    }
 }
 
 
@@ -378,7 +943,7 @@ void BasePlayer::setLoopStartPosition(double position)
 
 void BasePlayer::setLoopEndPosition(double position)
 {
-    setLoopStartTime(timeForPosition(position));
+    setLoopEndTime(timeForPosition(position));
 }
 
 
@@ -396,47 +961,87 @@ double BasePlayer::getLoopEndPosition() const
 
 void BasePlayer::setLoopStartTime(double time)
 {
-    _loopStartTime = std::max(startTime(), std::min(time, endTime()));
+    setLoopStartTimeMicros(TimeUtils::roundMicros(time));
+}
+
+
+void BasePlayer::setLoopEndTime(double time)
+{
+    setLoopEndTimeMicros(TimeUtils::roundMicros(time));
+}
+
 
-    if (_loopStartTime > _loopEndTime)
+double BasePlayer::getLoopStartTime() const
+{
+    return static_cast<double>(_playhead.loopStartTimeMicros);
+}
+
+
+double BasePlayer::getLoopEndTime() const
+{
+    return static_cast<double>(_playhead.loopEndTimeMicros);
+}
+
+
+void BasePlayer::setLoopStartTimeMicros(int64_t time)
+{
+    if (!isLoaded())
     {
-        std::swap(_loopStartTime, _loopEndTime);
+        ofLogError("BasePlayer::setLoopStartTimeMicros") << "The data is not loaded.";
+        return;
     }
+
+    _playhead.setLoopStartTimeMicros(*indexedData(), time);
 }
 
 
-void BasePlayer::setLoopEndTime(double time)
+void BasePlayer::setLoopEndTimeMicros(int64_t time)
 {
-    _loopEndTime = std::max(startTime(), std::min(time, endTime()));
-
-    if (_loopStartTime > _loopEndTime)
+    if (!isLoaded())
     {
-        std::swap(_loopStartTime, _loopEndTime);
+        ofLogError("BasePlayer::setLoopEndTimeMicros") << "The data is not loaded.";
+        return;
     }
+
+    _playhead.setLoopEndTimeMicros(*indexedData(), time);
 }
 
 
-double BasePlayer::getLoopStartTime() const
+int64_t BasePlayer::getLoopStartTimeMicros() const
 {
-    return _loopStartTime;
+    return _playhead.loopStartTimeMicros;
 }
 
 
-double BasePlayer::getLoopEndTime() const
+int64_t BasePlayer::getLoopEndTimeMicros() const
 {
-    return _loopEndTime;
+    return _playhead.loopEndTimeMicros;
 }
 
 
 void BasePlayer::setLoopStartFrameIndex(std::size_t index)
 {
-    setLoopStartTime(timeForIndex(index));
+    if (isLoaded())
+    {
+        setLoopStartTimeMicros(indexedData()->timeForIndexMicros(index));
+    }
+    else
+    {
+        ofLogError("BasePlayer::setLoopStartFrameIndex") << "The data is not loaded.";
+    }
 }
 
 
 void BasePlayer::setLoopEndFrameIndex(std::size_t index)
 {
-    setLoopEndTime(timeForIndex(index));
+    if (isLoaded())
+    {
+        setLoopEndTimeMicros(indexedData()->timeForIndexMicros(index));
+    }
+    else
+    {
+        ofLogError("BasePlayer::setLoopEndFrameIndex") << "The data is not loaded.";
+    }
 }
 
 
@@ -454,38 +1059,25 @@ std::size_t BasePlayer::getLoopEndFrameIndex() const
 
 void BasePlayer::clearLoopPoints()
 {
-    _loopStartTime = -1;
-    _loopEndTime = -1;
+    _playhead.clearLoopPoints();
 }
 
 
 ofLoopType BasePlayer::getLoopType() const
 {
-    return _loopType;
+    return _playhead.loopType;
 }
 
 
 void BasePlayer::setLoopType(ofLoopType loopType)
 {
-    switch (loopType)
-    {
-        case OF_LOOP_PALINDROME:
-            _playingForward = (getSpeed() > 0); // reset
-            break;
-        case OF_LOOP_NORMAL:
-        case OF_LOOP_NONE:
-        default:
-            break;
-    }
-
-    _loopType = loopType;
-
+    _playhead.setLoopType(loopType);
 }
 
 
 void BasePlayer::setPaused(bool paused)
 {
-    return _paused;
+    _paused = paused;
 }
 
 
@@ -618,6 +1210,24 @@ std::size_t BasePlayer::indexForTime(double time,
     }
 }
 
+
+void BasePlayer::indexesForTimes(const double* times,
+                                 std::size_t count,
+                                 bool increasing,
+                                 std::size_t* indexes) const
+{
+    if (isLoaded())
+    {
+        indexedData()->indexesForTimes(times, count, increasing, indexes);
+    }
+    else
+    {
+        ofLogError("BasePlayer::indexesForTimes") << "The data is not loaded.";
+        std::fill(indexes, indexes + count, 0);
+    }
+}
+
+
 double BasePlayer::timeForIndex(std::size_t index) const
 {
     if (isLoaded())
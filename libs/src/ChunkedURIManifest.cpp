@@ -0,0 +1,494 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/ChunkedURIManifest.h"
+#include "ofx/Player/PlayerUtils.h"
+#include <filesystem>
+#include <fstream>
+
+
+namespace ofx {
+namespace Player {
+
+
+namespace {
+
+
+const char MANIFEST_MAGIC[8] = { 'O', 'F', 'X', 'P', 'M', 'A', 'N', 'I' };
+
+
+} // namespace
+
+
+const uint32_t ChunkedURIManifest::VERSION = 1;
+
+
+ChunkedURIManifest::ChunkedURIManifest()
+{
+}
+
+
+ChunkedURIManifest::~ChunkedURIManifest()
+{
+}
+
+
+bool ChunkedURIManifest::open(const std::string& filename)
+{
+    close();
+
+    if (!_file.open(filename))
+    {
+        return false;
+    }
+
+    if (_file.size() < sizeof(Header))
+    {
+        ofLogError("ChunkedURIManifest::open") << "File is too small: " << filename;
+        close();
+        return false;
+    }
+
+    auto header = reinterpret_cast<const Header*>(_file.data());
+
+    if (std::memcmp(header->magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) != 0
+    ||  header->version != VERSION
+    ||  header->chunkSize == 0)
+    {
+        ofLogError("ChunkedURIManifest::open") << "Invalid manifest: " << filename;
+        close();
+        return false;
+    }
+
+    uint64_t fileSize = _file.size();
+
+    // The sizes are compared by subtraction so corrupt values can not overflow.
+    if (header->summaryOffset > fileSize
+    ||  header->chunkCount > (fileSize - header->summaryOffset) / sizeof(ChunkSummary)
+    ||  header->metadataOffset > fileSize
+    ||  header->metadataLength > fileSize - header->metadataOffset)
+    {
+        ofLogError("ChunkedURIManifest::open") << "Truncated manifest: " << filename;
+        close();
+        return false;
+    }
+
+    if (header->summaryOffset % alignof(ChunkSummary) != 0
+    ||  header->chunkCount != header->count / header->chunkSize + (header->count % header->chunkSize != 0 ? 1 : 0))
+    {
+        ofLogError("ChunkedURIManifest::open") << "Invalid manifest: " << filename;
+        close();
+        return false;
+    }
+
+    auto summaries = reinterpret_cast<const ChunkSummary*>(_file.data() + header->summaryOffset);
+
+    for (uint64_t i = 0; i < header->chunkCount; ++i)
+    {
+        const ChunkSummary& summary = summaries[i];
+
+        // Entries are located by index / chunkSize, so every chunk but the
+        // last must be full.
+        uint64_t count = (i + 1 < header->chunkCount) ? header->chunkSize
+                                                      : header->count - i * header->chunkSize;
+
+        // Each entry has a timestamp and a URI offset, followed by the end
+        // offset of the last URI.
+        const uint64_t recordSize = sizeof(int64_t) + sizeof(uint32_t);
+
+        // Only the summary is checked here, so opening never touches the
+        // chunk pages. The URI data is checked when the chunk is first read.
+        bool isValid = summary.count == count
+                    && summary.offset % alignof(int64_t) == 0
+                    && summary.offset <= fileSize
+                    && fileSize - summary.offset >= sizeof(uint32_t)
+                    && count <= (fileSize - summary.offset - sizeof(uint32_t)) / recordSize;
+
+        if (!isValid)
+        {
+            ofLogError("ChunkedURIManifest::open") << "Invalid or truncated chunk " << i << ": " << filename;
+            close();
+            return false;
+        }
+    }
+
+    _header = header;
+    _summaries = summaries;
+    _chunkStates.reset(new std::atomic<uint8_t>[header->chunkCount]());
+
+    if (header->metadataLength > 0)
+    {
+        try
+        {
+            auto begin = reinterpret_cast<const char*>(_file.data() + header->metadataOffset);
+            _metadata = ofJson::parse(begin, begin + header->metadataLength);
+        }
+        catch (const std::exception& exc)
+        {
+            ofLogWarning("ChunkedURIManifest::open") << "Unable to parse metadata: " << exc.what();
+        }
+    }
+
+    return true;
+}
+
+
+void ChunkedURIManifest::close()
+{
+    _header = nullptr;
+    _summaries = nullptr;
+    _chunkStates.reset();
+    _metadata = ofJson();
+    _file.close();
+}
+
+
+bool ChunkedURIManifest::isOpen() const
+{
+    return _header != nullptr;
+}
+
+
+double ChunkedURIManifest::timeForIndex(std::size_t index) const
+{
+    return static_cast<double>(timeForIndexMicros(index));
+}
+
+
+std::size_t ChunkedURIManifest::size() const
+{
+    return _header != nullptr ? static_cast<std::size_t>(_header->count) : 0;
+}
+
+
+std::size_t ChunkedURIManifest::indexForTime(double time,
+                                             bool increasing,
+                                             std::size_t indexHint) const
+{
+    // Integer timestamps <= time are <= floor(time) and integer timestamps
+    // >= time are >= ceil(time).
+    return indexForTimeMicros(increasing ? TimeUtils::floorMicros(time)
+                                         : TimeUtils::ceilMicros(time),
+                              increasing,
+                              indexHint);
+}
+
+
+int64_t ChunkedURIManifest::timeForIndexMicros(std::size_t index) const
+{
+    return timestamps(index / _header->chunkSize)[index % _header->chunkSize];
+}
+
+
+std::size_t ChunkedURIManifest::indexForTimeMicros(int64_t time,
+                                                   bool increasing,
+                                                   std::size_t) const
+{
+    std::size_t count = size();
+
+    if (count == 0 || time <= startTimeMicros())
+    {
+        return 0;
+    }
+    else if (time >= endTimeMicros())
+    {
+        return count - 1;
+    }
+
+    auto summariesEnd = _summaries + _header->chunkCount;
+
+    if (increasing)
+    {
+        // The last chunk starting at or before the time contains the last
+        // entry with a timestamp <= time.
+        auto summary = std::upper_bound(_summaries,
+                                        summariesEnd,
+                                        time,
+                                        [](int64_t value, const ChunkSummary& chunk)
+                                        {
+                                            return value < chunk.minTime;
+                                        }) - 1;
+
+        std::size_t chunk = summary - _summaries;
+        const int64_t* first = timestamps(chunk);
+        const int64_t* last = first + summary->count;
+
+        return chunk * _header->chunkSize + (std::upper_bound(first, last, time) - first) - 1;
+    }
+    else
+    {
+        // The first chunk ending at or after the time contains the first
+        // entry with a timestamp >= time.
+        auto summary = std::lower_bound(_summaries,
+                                        summariesEnd,
+                                        time,
+                                        [](const ChunkSummary& chunk, int64_t value)
+                                        {
+                                            return chunk.maxTime < value;
+                                        });
+
+        std::size_t chunk = summary - _summaries;
+        const int64_t* first = timestamps(chunk);
+        const int64_t* last = first + summary->count;
+
+        return chunk * _header->chunkSize + (std::lower_bound(first, last, time) - first);
+    }
+}
+
+
+std::string ChunkedURIManifest::uri(std::size_t index) const
+{
+    std::size_t chunk = index / _header->chunkSize;
+    std::size_t offset = index % _header->chunkSize;
+    const uint32_t* offsets = uriOffsets(chunk);
+
+    // The chunk's URI data is validated as a whole on first use, so corrupt
+    // offsets within the chunk are checked here.
+    if (!isValidChunk(chunk)
+    ||  offsets[offset + 1] < offsets[offset]
+    ||  offsets[offset + 1] > offsets[_summaries[chunk].count])
+    {
+        ofLogError("ChunkedURIManifest::uri") << "Invalid URI offset at index " << index << ".";
+        return std::string();
+    }
+
+    return std::string(uriData(chunk) + offsets[offset], offsets[offset + 1] - offsets[offset]);
+}
+
+
+TimestampedURI ChunkedURIManifest::operator [] (std::size_t index) const
+{
+    return TimestampedURI(uri(index), timeForIndexMicros(index));
+}
+
+
+void ChunkedURIManifest::forEach(const std::function<void(const std::string&, int64_t)>& visitor) const
+{
+    std::string uri;
+
+    for (std::size_t chunk = 0; chunk < chunkCount(); ++chunk)
+    {
+        const int64_t* times = timestamps(chunk);
+        const uint32_t* offsets = uriOffsets(chunk);
+        const char* data = uriData(chunk);
+
+        std::size_t count = _summaries[chunk].count;
+        bool isValid = isValidChunk(chunk);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!isValid || offsets[i + 1] < offsets[i] || offsets[i + 1] > offsets[count])
+            {
+                ofLogError("ChunkedURIManifest::forEach") << "Invalid URI offset in chunk " << chunk << ".";
+                uri.clear();
+            }
+            else
+            {
+                uri.assign(data + offsets[i], offsets[i + 1] - offsets[i]);
+            }
+
+            visitor(uri, times[i]);
+        }
+    }
+}
+
+
+std::size_t ChunkedURIManifest::chunkSize() const
+{
+    return _header != nullptr ? _header->chunkSize : 0;
+}
+
+
+std::size_t ChunkedURIManifest::chunkCount() const
+{
+    return _header != nullptr ? static_cast<std::size_t>(_header->chunkCount) : 0;
+}
+
+
+const ChunkedURIManifest::ChunkSummary& ChunkedURIManifest::chunk(std::size_t chunk) const
+{
+    return _summaries[chunk];
+}
+
+
+const ofJson& ChunkedURIManifest::metadata() const
+{
+    return _metadata;
+}
+
+
+bool ChunkedURIManifest::write(const std::string& filename,
+                               const TimestampedURIIndex& images,
+                               const ofJson& metadata,
+                               std::size_t chunkSize)
+{
+    // The manifest may be mapped by an open sequence, so it is replaced by
+    // renaming rather than truncated in place.
+    std::string temporaryPath = filename + ".tmp";
+
+    std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+    if (!stream)
+    {
+        ofLogError("ChunkedURIManifest::write") << "Unable to open file: " << temporaryPath;
+        return false;
+    }
+
+    chunkSize = std::max(chunkSize, std::size_t(1));
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+    header.version = VERSION;
+    header.chunkSize = static_cast<uint32_t>(chunkSize);
+    header.count = images.size();
+    header.chunkCount = (images.size() + chunkSize - 1) / chunkSize;
+
+    // Reserve space for the header, which is written last.
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    uint64_t position = sizeof(Header);
+
+    std::vector<ChunkSummary> summaries;
+    std::vector<int64_t> times;
+    std::vector<uint32_t> offsets;
+    std::string data;
+
+    auto writeChunk = [&]()
+    {
+        if (times.empty())
+        {
+            return;
+        }
+
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+
+        ChunkSummary summary;
+        summary.minTime = times.front();
+        summary.maxTime = times.back();
+        summary.offset = position;
+        summary.count = times.size();
+        summaries.push_back(summary);
+
+        stream.write(reinterpret_cast<const char*>(times.data()), times.size() * sizeof(int64_t));
+        stream.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        stream.write(data.data(), data.size());
+
+        position += times.size() * sizeof(int64_t)
+                  + offsets.size() * sizeof(uint32_t)
+                  + data.size();
+
+        // Keep every chunk 8 byte aligned so timestamps can be read in place.
+        static const char padding[8] = { 0 };
+        std::size_t remainder = position % 8;
+
+        if (remainder != 0)
+        {
+            stream.write(padding, 8 - remainder);
+            position += 8 - remainder;
+        }
+
+        times.clear();
+        offsets.clear();
+        data.clear();
+    };
+
+    images.forEach([&](const std::string& uri, int64_t timestamp)
+    {
+        times.push_back(timestamp);
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+        data += uri;
+
+        if (times.size() == chunkSize)
+        {
+            writeChunk();
+        }
+    });
+
+    writeChunk();
+
+    header.summaryOffset = position;
+    stream.write(reinterpret_cast<const char*>(summaries.data()), summaries.size() * sizeof(ChunkSummary));
+    position += summaries.size() * sizeof(ChunkSummary);
+
+    std::string json = metadata.is_null() ? "" : metadata.dump();
+    header.metadataOffset = position;
+    header.metadataLength = json.size();
+    stream.write(json.data(), json.size());
+
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    stream.close();
+
+    std::error_code error;
+
+    if (!stream.good())
+    {
+        ofLogError("ChunkedURIManifest::write") << "Unable to write file: " << temporaryPath;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporaryPath, filename, error);
+
+    if (error)
+    {
+        ofLogError("ChunkedURIManifest::write") << "Unable to replace manifest: " << filename << ": " << error.message();
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+
+bool ChunkedURIManifest::isValidChunk(std::size_t chunk) const
+{
+    uint8_t state = _chunkStates[chunk].load(std::memory_order_relaxed);
+
+    if (state == CHUNK_UNCHECKED)
+    {
+        // The summary was checked when opened, so the URI offsets are
+        // within the file.
+        const uint32_t* offsets = uriOffsets(chunk);
+        uint64_t count = _summaries[chunk].count;
+        uint64_t dataOffset = reinterpret_cast<const uint8_t*>(offsets + count + 1) - _file.data();
+
+        state = (offsets[0] == 0 && offsets[count] <= _file.size() - dataOffset) ? CHUNK_VALID
+                                                                                : CHUNK_INVALID;
+
+        if (state == CHUNK_INVALID)
+        {
+            ofLogError("ChunkedURIManifest::isValidChunk") << "Invalid or truncated chunk " << chunk << ".";
+        }
+
+        _chunkStates[chunk].store(state, std::memory_order_relaxed);
+    }
+
+    return state == CHUNK_VALID;
+}
+
+
+const int64_t* ChunkedURIManifest::timestamps(std::size_t chunk) const
+{
+    return reinterpret_cast<const int64_t*>(_file.data() + _summaries[chunk].offset);
+}
+
+
+const uint32_t* ChunkedURIManifest::uriOffsets(std::size_t chunk) const
+{
+    return reinterpret_cast<const uint32_t*>(timestamps(chunk) + _summaries[chunk].count);
+}
+
+
+const char* ChunkedURIManifest::uriData(std::size_t chunk) const
+{
+    return reinterpret_cast<const char*>(uriOffsets(chunk) + _summaries[chunk].count + 1);
+}
+
+
+} } // namespace ofx::Player
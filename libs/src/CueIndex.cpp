@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/CueIndex.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+Cue::Cue()
+{
+}
+
+
+Cue::Cue(double time, const std::string& name):
+    _time(time),
+    _name(name)
+{
+}
+
+
+double Cue::time() const
+{
+    return _time;
+}
+
+
+const std::string& Cue::name() const
+{
+    return _name;
+}
+
+
+CueEventArgs::CueEventArgs(const Cue& cue, std::size_t index, bool increasing):
+    _cue(cue),
+    _index(index),
+    _increasing(increasing)
+{
+}
+
+
+const Cue& CueEventArgs::cue() const
+{
+    return _cue;
+}
+
+
+std::size_t CueEventArgs::index() const
+{
+    return _index;
+}
+
+
+bool CueEventArgs::isIncreasing() const
+{
+    return _increasing;
+}
+
+
+CueIndex::CueIndex()
+{
+}
+
+
+CueIndex::~CueIndex()
+{
+}
+
+
+std::size_t CueIndex::add(double time, const std::string& name)
+{
+    auto iter = std::upper_bound(_times.begin(), _times.end(), time);
+    std::size_t index = iter - _times.begin();
+
+    _times.insert(iter, time);
+    _cues.insert(_cues.begin() + index, Cue(time, name));
+
+    return index;
+}
+
+
+void CueIndex::remove(std::size_t index)
+{
+    if (index < _cues.size())
+    {
+        _times.erase(_times.begin() + index);
+        _cues.erase(_cues.begin() + index);
+    }
+}
+
+
+void CueIndex::clear()
+{
+    _times.clear();
+    _cues.clear();
+    _lastIndex = 0;
+}
+
+
+const Cue& CueIndex::operator [] (std::size_t index) const
+{
+    return _cues[index];
+}
+
+
+double CueIndex::timeForIndex(std::size_t index) const
+{
+    return _times[index];
+}
+
+
+std::size_t CueIndex::size() const
+{
+    return _times.size();
+}
+
+
+const double* CueIndex::timestampData() const
+{
+    return _times.data();
+}
+
+
+void CueIndex::notify(const BasePlayer& player)
+{
+    if (_cues.empty())
+    {
+        return;
+    }
+
+    player.getCrossedIndexRanges(*this, _ranges, _lastIndex);
+
+    for (const IndexRange& range: _ranges)
+    {
+        IndexRange pass = range;
+
+        // Repeated palindrome passes alternate direction. Each pass excludes
+        // the edge it starts from, since that cue ended the previous pass.
+        IndexRange reflected;
+
+        if (player.getLoopType() == OF_LOOP_PALINDROME && range.repeat() > 1)
+        {
+            double loopStartTime = player.getLoopStartTime();
+            double loopEndTime = player.getLoopEndTime();
+
+            if (loopStartTime < 0)
+            {
+                loopStartTime = player.startTime();
+            }
+
+            if (loopEndTime < 0)
+            {
+                loopEndTime = player.endTime();
+            }
+
+            if (range.isIncreasing())
+            {
+                reflected = IndexRange(lowerBound(loopStartTime, range.begin()),
+                                       lowerBound(loopEndTime, range.end()),
+                                       false);
+            }
+            else
+            {
+                reflected = IndexRange(upperBound(loopStartTime, range.begin()),
+                                       upperBound(loopEndTime, range.end()),
+                                       true);
+            }
+        }
+
+        for (std::size_t i = 0; i < range.repeat(); ++i)
+        {
+            if (pass.isIncreasing())
+            {
+                for (std::size_t index = pass.begin(); index < pass.end(); ++index)
+                {
+                    CueEventArgs args(_cues[index], index, true);
+                    ofNotifyEvent(onCue, args, this);
+                }
+
+                _lastIndex = pass.end() > 0 ? pass.end() - 1 : 0;
+            }
+            else
+            {
+                for (std::size_t index = pass.end(); index-- > pass.begin();)
+                {
+                    CueEventArgs args(_cues[index], index, false);
+                    ofNotifyEvent(onCue, args, this);
+                }
+
+                _lastIndex = pass.begin();
+            }
+
+            if (range.repeat() > 1 && player.getLoopType() == OF_LOOP_PALINDROME)
+            {
+                std::swap(pass, reflected);
+            }
+        }
+    }
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/DirectoryWatcher.h"
+#include "ofLog.h"
+
+
+#if defined(TARGET_LINUX)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace Player {
+
+
+DirectoryWatcher::DirectoryWatcher(const std::string& directory,
+                                   const std::string& filePattern):
+    _directory(directory),
+    _filter(filePattern),
+    _running(false)
+{
+#if defined(TARGET_LINUX)
+    _fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (_fd < 0)
+    {
+        ofLogError("DirectoryWatcher::DirectoryWatcher") << "Unable to initialize inotify.";
+        return;
+    }
+
+    _wd = ::inotify_add_watch(_fd,
+                              _directory.c_str(),
+                              IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    if (_wd < 0)
+    {
+        ofLogError("DirectoryWatcher::DirectoryWatcher") << "Unable to watch directory: " << _directory;
+        ::close(_fd);
+        _fd = -1;
+        return;
+    }
+
+    _running = true;
+    _thread = std::thread(&DirectoryWatcher::run, this);
+#else
+    ofLogError("DirectoryWatcher::DirectoryWatcher") << "Directory watching is not supported on this platform.";
+#endif
+}
+
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    _running = false;
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+#if defined(TARGET_LINUX)
+    if (_fd >= 0)
+    {
+        ::close(_fd);
+    }
+#endif
+}
+
+
+bool DirectoryWatcher::isWatching() const
+{
+    return _running;
+}
+
+
+std::string DirectoryWatcher::directory() const
+{
+    return _directory;
+}
+
+
+std::size_t DirectoryWatcher::poll(std::vector<std::string>& filenames,
+                                   bool* isRescan)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    std::size_t count = _filenames.size();
+    filenames.insert(filenames.end(), _filenames.begin(), _filenames.end());
+    _filenames.clear();
+
+    if (isRescan != nullptr)
+    {
+        *isRescan = _isRescan;
+    }
+
+    _isRescan = false;
+    return count;
+}
+
+
+bool DirectoryWatcher::isSupported()
+{
+#if defined(TARGET_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void DirectoryWatcher::run()
+{
+#if defined(TARGET_LINUX)
+    alignas(struct inotify_event) char buffer[4096];
+
+    struct pollfd descriptor;
+    descriptor.fd = _fd;
+    descriptor.events = POLLIN;
+
+    // Files written before the watch was installed were never notified.
+    rescan();
+
+    while (_running)
+    {
+        // Wake up periodically to check if we should stop.
+        int result = ::poll(&descriptor, 1, 100);
+
+        if (result <= 0 || (descriptor.revents & POLLIN) == 0)
+        {
+            continue;
+        }
+
+        ssize_t length = ::read(_fd, buffer, sizeof(buffer));
+
+        if (length <= 0)
+        {
+            continue;
+        }
+
+        std::vector<std::string> filenames;
+
+        bool isOverflowed = false;
+
+        for (char* ptr = buffer; ptr < buffer + length;)
+        {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                isOverflowed = true;
+            }
+            else if (event->len > 0 && (event->mask & IN_ISDIR) == 0)
+            {
+                auto path = (std::filesystem::path(_directory) / event->name);
+
+                if (_filter.accept(path))
+                {
+                    filenames.push_back(path.string());
+                }
+            }
+
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+
+        if (!filenames.empty())
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _filenames.insert(_filenames.end(), filenames.begin(), filenames.end());
+        }
+
+        // Events were dropped, so the files written since are only found by
+        // listing the directory.
+        if (isOverflowed)
+        {
+            ofLogWarning("DirectoryWatcher::run") << "Notification queue overflowed, rescanning: " << _directory;
+            rescan();
+        }
+    }
+#endif
+}
+
+
+void DirectoryWatcher::rescan()
+{
+    std::vector<std::string> filenames;
+
+    std::error_code error;
+
+    for (std::filesystem::directory_iterator iter(_directory, error), end;
+         !error && iter != end;
+         iter.increment(error))
+    {
+        if (iter->is_regular_file(error) && _filter.accept(iter->path()))
+        {
+            filenames.push_back(iter->path().string());
+        }
+    }
+
+    if (error)
+    {
+        ofLogError("DirectoryWatcher::rescan") << "Unable to list directory: " << _directory << ": " << error.message();
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _filenames.insert(_filenames.end(), filenames.begin(), filenames.end());
+    _isRescan = true;
+}
+
+
+} } // namespace ofx::Player
@@ -6,6 +6,9 @@
 
 
 #include "ofx/Player/ImageSequence.h"
+#include "ofx/Player/Trace.h"
+#include <chrono>
+#include <unordered_set>
 #include "ofImage.h"
 
 
@@ -56,16 +59,75 @@ ImageSequence::~ImageSequence()
 
 double ImageSequence::timeForIndex(std::size_t index) const
 {
-    return _images[index].timestamp();
+    if (_manifest != nullptr)
+    {
+        return _manifest->timeForIndex(index);
+    }
+
+    return _images.timestamp(index);
+}
+
+
+int64_t ImageSequence::timeForIndexMicros(std::size_t index) const
+{
+    if (_manifest != nullptr)
+    {
+        return _manifest->timeForIndexMicros(index);
+    }
+
+    return _images.timestampMicros(index);
 }
 
 
 std::size_t ImageSequence::size() const
 {
+    if (_manifest != nullptr)
+    {
+        return _manifest->size();
+    }
+
     return _images.size();
 }
 
 
+std::size_t ImageSequence::indexForTime(double time,
+                                        bool increasing,
+                                        std::size_t indexHint) const
+{
+    if (_manifest != nullptr)
+    {
+        return _manifest->indexForTime(time, increasing, indexHint);
+    }
+
+    return BaseTimeIndexed::indexForTime(time, increasing, indexHint);
+}
+
+
+std::size_t ImageSequence::indexForTimeMicros(int64_t time,
+                                              bool increasing,
+                                              std::size_t indexHint) const
+{
+    if (_manifest != nullptr)
+    {
+        return _manifest->indexForTimeMicros(time, increasing, indexHint);
+    }
+
+    return BaseTimeIndexed::indexForTimeMicros(time, increasing, indexHint);
+}
+
+
+const int64_t* ImageSequence::timestampMicrosData() const
+{
+    // Manifest timestamps are only contiguous within each chunk.
+    if (_manifest != nullptr)
+    {
+        return nullptr;
+    }
+
+    return _images.timestamps().data();
+}
+
+
 float ImageSequence::getWidth() const
 {
     return _width;
@@ -96,23 +158,31 @@ const ofPixels& ImageSequence::getPixels(std::size_t index) const
     {
         try
         {
-            return *_pixelCache->get(index);
+            const ofPixels& pixels = *_pixelCache->get(index);
+
+            if (_isStatsEnabled)
+            {
+                _pixelCacheCounters.hit();
+            }
+
+            return pixels;
         }
         catch (const std::range_error&)
         {
-            auto path = resolve(_images[index]);
+            auto pixels = loadPixels(index);
 
-            auto pixels = std::make_shared<ofPixels>();
-
-            if (ofLoadImage(*pixels, path))
             {
+                OFX_PLAYER_TRACE_SCOPE_ID_INDEX("ImageSequence::cachePixels", this, index);
                 _pixelCache->add(index, pixels);
-                return *pixels;
             }
-            else
+
+            if (_isStatsEnabled)
             {
-                throw std::runtime_error("Unable to load image " + path);
+                _pixelCacheCounters.miss();
+                _pixelCacheCounters.insert();
             }
+
+            return *pixels;
         }
     }
     else
@@ -128,35 +198,52 @@ const ofTexture& ImageSequence::getTexture(std::size_t index) const
     {
         try
         {
-            return *_textureCache->get(index);
+            const ofTexture& texture = *_textureCache->get(index);
+
+            if (_isStatsEnabled)
+            {
+                _textureCacheCounters.hit();
+            }
+
+            return texture;
         }
         catch (const std::range_error&)
         {
-            auto path = resolve(_images[index]);
+            auto texture = std::make_shared<ofTexture>();
+
+            const ofPixels& pixels = getPixels(index);
 
-            auto pixels = std::make_shared<ofPixels>();
+            OFX_PLAYER_TRACE_SCOPE_ID_INDEX("ImageSequence::uploadTexture", this, index);
 
-            if (ofLoadImage(*pixels, path))
+            if (_isStatsEnabled)
             {
-                _pixelCache->add(index, pixels);
+                _textureCacheCounters.miss();
+
+                auto start = std::chrono::high_resolution_clock::now();
+                texture->loadData(pixels);
+                auto end = std::chrono::high_resolution_clock::now();
+
+                _uploadLatency.add(std::chrono::duration<double, std::micro>(end - start).count());
             }
             else
             {
-                throw std::runtime_error("Unable to load image " + path);
+                texture->loadData(pixels);
             }
 
-            auto texture = std::make_shared<ofTexture>();
-
-            texture->loadData(*pixels);
-
             if (texture->isAllocated())
             {
                 _textureCache->add(index, texture);
+
+                if (_isStatsEnabled)
+                {
+                    _textureCacheCounters.insert();
+                }
+
                 return *texture;
             }
             else
             {
-                throw std::runtime_error("Unable to load texture " + path);
+                throw std::runtime_error("Unable to load texture " + resolve(image(index)));
             }
         }
     }
@@ -185,6 +272,17 @@ std::string ImageSequence::baseDirectory() const
 }
 
 
+TimestampedURI ImageSequence::image(std::size_t index) const
+{
+    if (_manifest != nullptr)
+    {
+        return (*_manifest)[index];
+    }
+
+    return _images[index];
+}
+
+
 std::string ImageSequence::resolve(const TimestampedURI& uri) const
 {
     return (std::filesystem::path(_baseDirectory) / std::filesystem::path(uri.uri())).string();
@@ -211,12 +309,32 @@ bool ImageSequence::fromDirectory(const std::string& directory,
         sequence._name = ofFilePath::getBaseName(directory);
     }
 
+    sequence._fileRecords.clear();
+    sequence._directoryRecords.clear();
+    sequence._isRecorded = false;
+    sequence._manifest.reset();
+
+    // The directory time is taken before listing so that files written
+    // during the listing are picked up by the first refresh.
+    int64_t directoryTime = directoryModified(directory);
+
+    std::vector<TimestampedURI> images;
+
     if (TimestampedFilenameUtils::list(directory,
                                        filePattern,
                                        makeFilesRelativeToDirectory,
                                        stamper,
-                                       sequence._images) && sequence.size() > 0)
+                                       images) && !images.empty())
     {
+        sequence._images.assign(images);
+
+        // Files are recorded by the first refresh, but the directory time is
+        // kept so that files added after loading are found by that refresh.
+        if (!sequence._baseDirectory.empty())
+        {
+            sequence._directoryRecords[sequence._baseDirectory] = directoryTime;
+        }
+
         ofPixels pixels;
 
         // TODO: read from header?
@@ -267,14 +385,63 @@ bool ImageSequence::fromJson(const std::string& filename, ImageSequence& sequenc
             sequence._height = json["height"];
         }
 
+        sequence._fileRecords.clear();
+        sequence._directoryRecords.clear();
+        sequence._isRecorded = false;
+        sequence.materialize();
+
+        bool hasRecords = true;
+
         if (json["images"].is_array())
         {
             for (auto& image : json["images"])
             {
-                sequence._images.push_back(TimestampedURI(image["uri"], image["ts"]));
+                // Older sequences stored double timestamps.
+                const ofJson& ts = image["ts"];
+
+                sequence._images.push_back(image["uri"].get<std::string>(),
+                                           ts.is_number_integer() ? ts.get<int64_t>()
+                                                                  : TimeUtils::roundMicros(ts.get<double>()));
+
+                if (!image["size"].is_null() && !image["modified"].is_null())
+                {
+                    FileRecord record;
+                    record.size = image["size"];
+                    record.modified = image["modified"];
+                    sequence._fileRecords[image["uri"]] = record;
+                }
+                else
+                {
+                    hasRecords = false;
+                }
             }
         }
 
+        if (json["directories"].is_object())
+        {
+            for (auto iter = json["directories"].begin(); iter != json["directories"].end(); ++iter)
+            {
+                sequence._directoryRecords[iter.key()] = iter.value();
+            }
+        }
+        else
+        {
+            hasRecords = false;
+        }
+
+        // Files saved without their state are recorded by the first refresh,
+        // but the directory time is taken now so that files added after
+        // loading are found by that refresh.
+        if (hasRecords)
+        {
+            sequence._isRecorded = true;
+        }
+        else if (!sequence._baseDirectory.empty()
+             &&  sequence._directoryRecords.find(sequence._baseDirectory) == sequence._directoryRecords.end())
+        {
+            sequence._directoryRecords[sequence._baseDirectory] = directoryModified(sequence._baseDirectory);
+        }
+
         return true;
     }
     else
@@ -297,12 +464,27 @@ bool ImageSequence::toJson(const ImageSequence& sequence,
 
     ofJson images;
 
-    for (auto& image : sequence._images)
+    sequence.forEachImage([&](const std::string& uri, int64_t timestamp)
     {
-        json["images"].push_back({
-            { "uri", image.uri() },
-            { "ts", image.timestamp() }
-        });
+        ofJson entry = {
+            { "uri", uri },
+            { "ts", timestamp }
+        };
+
+        auto record = sequence._fileRecords.find(uri);
+
+        if (record != sequence._fileRecords.end())
+        {
+            entry["size"] = record->second.size;
+            entry["modified"] = record->second.modified;
+        }
+
+        json["images"].push_back(entry);
+    });
+
+    for (auto& record: sequence._directoryRecords)
+    {
+        json["directories"][record.first] = record.second;
     }
 
     std::string _filename = filename;
@@ -319,33 +501,893 @@ bool ImageSequence::toJson(const ImageSequence& sequence,
 }
 
 
-const std::vector<TimestampedURI>& ImageSequence::images() const
+bool ImageSequence::fromManifest(const std::string& filename,
+                                 ImageSequence& sequence)
+{
+    auto manifest = std::make_unique<ChunkedURIManifest>();
+
+    if (!manifest->open(filename))
+    {
+        ofLogError("ImageSequence::fromManifest") << "Unable to open manifest: " << filename;
+        return false;
+    }
+
+    const ofJson& metadata = manifest->metadata();
+
+    if (metadata.is_object())
+    {
+        sequence._baseDirectory = metadata.value("base_directory", sequence._baseDirectory);
+        sequence._name = metadata.value("name", sequence._name);
+        sequence._width = metadata.value("width", sequence._width);
+        sequence._height = metadata.value("height", sequence._height);
+    }
+
+    sequence._images.clear();
+    sequence._fileRecords.clear();
+    sequence._directoryRecords.clear();
+    sequence._isRecorded = false;
+    sequence._manifest = std::move(manifest);
+    sequence._isManifestCopied = false;
+    sequence.clearPixelCache();
+    sequence.clearTextureCache();
+    sequence._reader.reset();
+
+    return true;
+}
+
+
+bool ImageSequence::toManifest(const ImageSequence& sequence,
+                               const std::string& filename,
+                               std::size_t chunkSize)
+{
+    ofJson metadata;
+
+    metadata["name"] = sequence.getName();
+    metadata["base_directory"] = sequence._baseDirectory;
+    metadata["width"] = sequence.getWidth();
+    metadata["height"] = sequence.getHeight();
+
+    if (sequence._manifest != nullptr)
+    {
+        TimestampedURIIndex images;
+        images.reserve(sequence.size());
+
+        sequence.forEachImage([&images](const std::string& uri, int64_t timestamp)
+        {
+            images.push_back(uri, timestamp);
+        });
+
+        return ChunkedURIManifest::write(filename, images, metadata, chunkSize);
+    }
+
+    return ChunkedURIManifest::write(filename, sequence._images, metadata, chunkSize);
+}
+
+
+const TimestampedURIIndex& ImageSequence::images() const
 {
+    if (_manifest != nullptr)
+    {
+        // Copy the manifest once, but keep reading from the mapped manifest
+        // so that the other accessors are unaffected.
+        std::unique_lock<std::mutex> lock(_imagesMutex);
+
+        if (!_isManifestCopied)
+        {
+            copyManifest();
+        }
+    }
+
     return _images;
 }
 
 
 void ImageSequence::setTextureCacheSize(std::size_t size)
 {
+    _textureCacheCounters.emptied(_textureCacheSize);
+    _textureCacheSize = size;
     _textureCache = std::make_unique<TextureCache>(size);
 }
 
 
 void ImageSequence::clearTextureCache()
 {
-    //_textureCache->clear();
+    _textureCacheCounters.emptied(_textureCacheSize);
+    _textureCache = std::make_unique<TextureCache>(_textureCacheSize);
 }
 
 
 void ImageSequence::setPixelCacheSize(std::size_t size)
 {
+    _pixelCacheCounters.emptied(_pixelCacheSize);
+    _pixelCacheSize = size;
     _pixelCache = std::make_unique<PixelCache>(size);
 }
 
 
 void ImageSequence::clearPixelCache()
 {
-    //_pixelCache->clear();
+    _pixelCacheCounters.emptied(_pixelCacheSize);
+    _pixelCache = std::make_unique<PixelCache>(_pixelCacheSize);
+}
+
+
+void ImageSequence::setStatsEnabled(bool enabled)
+{
+    _isStatsEnabled = enabled;
+}
+
+
+bool ImageSequence::isStatsEnabled() const
+{
+    return _isStatsEnabled;
+}
+
+
+void ImageSequence::setDecodeTimingEnabled(bool enabled)
+{
+    _isDecodeTimingEnabled = enabled;
+}
+
+
+bool ImageSequence::isDecodeTimingEnabled() const
+{
+    return _isDecodeTimingEnabled;
+}
+
+
+ImageSequenceStats ImageSequence::getStats() const
+{
+    ImageSequenceStats stats;
+    stats.pixelCache = _pixelCacheCounters.stats(_pixelCacheSize);
+    stats.textureCache = _textureCacheCounters.stats(_textureCacheSize);
+    stats.readaheadHits = _readaheadHits.load(std::memory_order_relaxed);
+    stats.bytesRead = _bytesRead.load(std::memory_order_relaxed);
+    stats.readLatency = _readLatency.snapshot();
+    stats.decodeLatency = _decodeLatency.snapshot();
+    stats.uploadLatency = _uploadLatency.snapshot();
+    return stats;
+}
+
+
+void ImageSequence::resetStats()
+{
+    _pixelCacheCounters.reset();
+    _textureCacheCounters.reset();
+    _readaheadHits = 0;
+    _bytesRead = 0;
+    _readLatency.reset();
+    _decodeLatency.reset();
+    _uploadLatency.reset();
+}
+
+
+void ImageSequence::notifyStats()
+{
+    ImageSequenceStats stats = getStats();
+    ofNotifyEvent(onStats, stats, this);
+}
+
+
+double ImageSequence::getAverageDecodeDuration() const
+{
+    return _averageDecodeDuration.load(std::memory_order_relaxed);
+}
+
+
+uint64_t ImageSequence::getDecodeCount() const
+{
+    return _decodeCount.load(std::memory_order_relaxed);
+}
+
+
+void ImageSequence::setReadaheadSize(std::size_t size)
+{
+    _readaheadSize = size;
+
+    // The reader is recreated with a matching capacity on the next prefetch.
+    _reader.reset();
+}
+
+
+std::size_t ImageSequence::getReadaheadSize() const
+{
+    return _readaheadSize;
+}
+
+
+void ImageSequence::prefetch(std::size_t index, bool increasing)
+{
+    OFX_PLAYER_TRACE_SCOPE_ID_INDEX("ImageSequence::prefetch", this, index);
+
+    if (_readaheadSize == 0 || index >= size())
+    {
+        return;
+    }
+
+    if (_reader == nullptr)
+    {
+        _reader = std::make_unique<AsyncFileReader>(_readaheadSize * 2);
+    }
+
+    for (std::size_t i = 1; i <= _readaheadSize; ++i)
+    {
+        if (increasing ? (index + i >= size()) : (i > index))
+        {
+            break;
+        }
+
+        std::size_t next = increasing ? (index + i) : (index - i);
+
+        if (!isPixelsCached(next))
+        {
+            _reader->request(next, resolve(image(next)));
+        }
+    }
+}
+
+
+bool ImageSequence::refresh(const std::string& filePattern,
+                            const AbstractURITimestamper& stamper,
+                            bool checkModifiedFiles)
+{
+    if (_baseDirectory.empty())
+    {
+        ofLogError("ImageSequence::refresh") << "Refreshing requires a base directory.";
+        return false;
+    }
+
+    materialize();
+
+    if (!_isRecorded)
+    {
+        recordFiles();
+    }
+
+    // Directory times are taken before listing so that files written during
+    // the listing are picked up by the next refresh.
+    std::unordered_map<std::string, int64_t> directoryRecords;
+
+    bool isModified = checkModifiedFiles;
+
+    for (auto& record: _directoryRecords)
+    {
+        int64_t modified = directoryModified(record.first);
+        isModified = isModified || (modified != record.second);
+        directoryRecords[record.first] = modified;
+    }
+
+    if (!isModified)
+    {
+        return true;
+    }
+
+    std::vector<std::string> files;
+
+    IO::RegexPathFilter regexFilter(filePattern);
+
+    IO::DirectoryUtils::list(_baseDirectory,
+                             files,
+                             true,
+                             &regexFilter,
+                             true);
+
+    std::unordered_set<std::string> listed(files.begin(), files.end());
+    std::unordered_set<std::string> removed;
+    std::vector<TimestampedURI> added;
+
+    // False if any file was skipped.
+    bool isComplete = true;
+
+    for (auto& file: files)
+    {
+        auto iter = _fileRecords.find(file);
+
+        if (iter != _fileRecords.end())
+        {
+            if (!checkModifiedFiles)
+            {
+                continue;
+            }
+
+            FileRecord record;
+
+            if (statFile((std::filesystem::path(_baseDirectory) / file).string(), record)
+            &&  record.size == iter->second.size
+            &&  record.modified == iter->second.modified)
+            {
+                continue;
+            }
+
+            // The file was modified in place, so replace it.
+            removed.insert(file);
+        }
+        else
+        {
+            // Files that can not be recorded yet, e.g. because they are still
+            // being written, are skipped rather than added without a record
+            // and added again by every refresh.
+            FileRecord record;
+
+            if (!statFile((std::filesystem::path(_baseDirectory) / file).string(), record))
+            {
+                isComplete = false;
+                continue;
+            }
+        }
+
+        int64_t timestamp = 0;
+
+        if (stamper.createTimestampMicros(file, timestamp))
+        {
+            added.push_back(TimestampedURI(file, timestamp));
+        }
+    }
+
+    for (auto& record: _fileRecords)
+    {
+        if (listed.find(record.first) == listed.end())
+        {
+            removed.insert(record.first);
+        }
+    }
+
+    if (!removed.empty())
+    {
+        _images.removeIf([&removed](const std::string& uri, int64_t)
+                         {
+                             return removed.find(uri) != removed.end();
+                         });
+
+        for (auto& uri: removed)
+        {
+            _fileRecords.erase(uri);
+        }
+
+        // Removing images shifts indices.
+        clearPixelCache();
+        clearTextureCache();
+
+        if (_reader != nullptr)
+        {
+            _reader->clear();
+        }
+    }
+
+    // Skipped files are retried by the next refresh, since the directories
+    // still appear modified.
+    if (isComplete)
+    {
+        for (auto& record: directoryRecords)
+        {
+            _directoryRecords[record.first] = record.second;
+        }
+    }
+
+    for (auto& image: added)
+    {
+        recordFile(image.uri());
+    }
+
+    insertImages(added);
+
+    return true;
+}
+
+
+bool ImageSequence::follow(const std::string& filePattern,
+                           std::shared_ptr<const AbstractURITimestamper> stamper)
+{
+    if (_baseDirectory.empty())
+    {
+        ofLogError("ImageSequence::follow") << "Following requires a base directory.";
+        return false;
+    }
+
+    if (stamper == nullptr)
+    {
+        ofLogError("ImageSequence::follow") << "Following requires a timestamper.";
+        return false;
+    }
+
+    _followStamper = stamper;
+    _watcher = std::make_unique<DirectoryWatcher>(_baseDirectory, filePattern);
+
+    if (!_watcher->isWatching())
+    {
+        _watcher.reset();
+        return false;
+    }
+
+    return true;
+}
+
+
+void ImageSequence::unfollow()
+{
+    _watcher.reset();
+
+    std::vector<TimestampedURI> images;
+
+    for (auto& pending: _pendingImages)
+    {
+        images.push_back(pending.image);
+    }
+
+    _pendingImages.clear();
+
+    insertImages(images);
+}
+
+
+bool ImageSequence::isFollowing() const
+{
+    return _watcher != nullptr;
+}
+
+
+std::size_t ImageSequence::appendNewFiles()
+{
+    if (_watcher == nullptr)
+    {
+        return 0;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    std::vector<std::string> files;
+
+    bool isRescan = false;
+
+    _watcher->poll(files, &isRescan);
+
+    // A rescan lists every file, but only files after the end of the
+    // sequence can have been missed.
+    int64_t rescanFrom = std::numeric_limits<int64_t>::lowest();
+
+    if (isRescan && size() > 0)
+    {
+        rescanFrom = timeForIndexMicros(size() - 1);
+    }
+
+    for (auto& file: files)
+    {
+        int64_t timestamp = 0;
+
+        if (!_followStamper->createTimestampMicros(file, timestamp)
+        ||  timestamp < rescanFrom)
+        {
+            continue;
+        }
+
+        auto uri = std::filesystem::path(file).lexically_relative(_baseDirectory).string();
+
+        TimestampedURI image(uri, timestamp);
+
+        // A file can be reported more than once, e.g. if it is closed twice.
+        bool isHeld = std::any_of(_pendingImages.begin(),
+                                  _pendingImages.end(),
+                                  [&uri](const PendingImage& pending)
+                                  {
+                                      return pending.image.uri() == uri;
+                                  });
+
+        if (isHeld || isIndexed(image))
+        {
+            continue;
+        }
+
+        if (_isRecorded)
+        {
+            recordFile(uri);
+        }
+
+        auto position = std::upper_bound(_pendingImages.begin(),
+                                         _pendingImages.end(),
+                                         timestamp,
+                                         [](int64_t time, const PendingImage& pending)
+                                         {
+                                             return time < pending.image.timestampMicros();
+                                         });
+
+        _pendingImages.insert(position, { image, now });
+    }
+
+    // Release every held image up to the latest one that has waited for the
+    // reorder window. Earlier images are released with it to keep the order.
+    auto window = std::chrono::microseconds(_reorderWindowMicros);
+
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < _pendingImages.size(); ++i)
+    {
+        if (now - _pendingImages[i].arrival >= window)
+        {
+            count = i + 1;
+        }
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    std::vector<TimestampedURI> images;
+    images.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        images.push_back(_pendingImages[i].image);
+    }
+
+    _pendingImages.erase(_pendingImages.begin(), _pendingImages.begin() + count);
+
+    bool wasEmpty = (size() == 0);
+
+    insertImages(images);
+
+    if (wasEmpty && size() > 0)
+    {
+        ofPixels pixels;
+
+        if (ofLoadImage(pixels, resolve(image(0))))
+        {
+            _width = pixels.getWidth();
+            _height = pixels.getHeight();
+        }
+    }
+
+    return images.size();
+}
+
+
+void ImageSequence::setReorderWindowMicros(uint64_t window)
+{
+    _reorderWindowMicros = window;
+}
+
+
+uint64_t ImageSequence::getReorderWindowMicros() const
+{
+    return _reorderWindowMicros;
+}
+
+
+bool ImageSequence::isIndexed(const TimestampedURI& image) const
+{
+    std::size_t first = lowerBoundMicros(image.timestampMicros());
+    std::size_t last = upperBoundMicros(image.timestampMicros(), first);
+
+    for (std::size_t i = first; i < last; ++i)
+    {
+        if (this->image(i).uri() == image.uri())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool ImageSequence::statFile(const std::string& path, FileRecord& record)
+{
+    std::error_code error;
+
+    auto size = std::filesystem::file_size(path, error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    auto modified = std::filesystem::last_write_time(path, error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    record.size = size;
+    record.modified = modified.time_since_epoch().count();
+    return true;
+}
+
+
+int64_t ImageSequence::directoryModified(const std::string& path)
+{
+    std::error_code error;
+
+    auto modified = std::filesystem::last_write_time(path, error);
+
+    if (error)
+    {
+        return -1;
+    }
+
+    return modified.time_since_epoch().count();
+}
+
+
+void ImageSequence::recordFiles()
+{
+    // Directory times taken at load are kept, so that changes since then are
+    // still found.
+    if (_directoryRecords.find(_baseDirectory) == _directoryRecords.end())
+    {
+        _directoryRecords[_baseDirectory] = directoryModified(_baseDirectory);
+    }
+
+    forEachImage([this](const std::string& uri, int64_t)
+    {
+        if (_fileRecords.find(uri) == _fileRecords.end())
+        {
+            recordFile(uri);
+        }
+    });
+
+    _isRecorded = true;
+}
+
+
+void ImageSequence::recordFile(const std::string& uri)
+{
+    auto path = std::filesystem::path(_baseDirectory) / uri;
+
+    FileRecord record;
+
+    // A file that can not be stat'ed is still recorded, so that it is not
+    // added again by a refresh. Its record never matches, so it is replaced
+    // when modified files are checked.
+    if (!statFile(path.string(), record))
+    {
+        record.modified = -1;
+    }
+
+    _fileRecords[uri] = record;
+
+    auto directory = path.parent_path().string();
+
+    if (_directoryRecords.find(directory) == _directoryRecords.end())
+    {
+        _directoryRecords[directory] = directoryModified(directory);
+    }
+}
+
+
+void ImageSequence::materialize()
+{
+    if (_manifest == nullptr)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_imagesMutex);
+
+    if (!_isManifestCopied)
+    {
+        copyManifest();
+    }
+
+    _manifest.reset();
+    _isManifestCopied = false;
+}
+
+
+void ImageSequence::copyManifest() const
+{
+    _images.clear();
+    _images.reserve(_manifest->size());
+
+    _manifest->forEach([this](const std::string& uri, int64_t timestamp)
+    {
+        _images.push_back(uri, timestamp);
+    });
+
+    _isManifestCopied = true;
+}
+
+
+void ImageSequence::forEachImage(const std::function<void(const std::string&, int64_t)>& visitor) const
+{
+    if (_manifest != nullptr)
+    {
+        _manifest->forEach(visitor);
+    }
+    else
+    {
+        _images.forEach(visitor);
+    }
+}
+
+
+std::shared_ptr<ofPixels> ImageSequence::loadPixels(std::size_t index) const
+{
+    auto path = resolve(image(index));
+
+    auto pixels = std::make_shared<ofPixels>();
+
+    std::shared_ptr<ofBuffer> buffer = nullptr;
+
+    if (_reader != nullptr)
+    {
+        buffer = _reader->take(index);
+    }
+
+    if (_isStatsEnabled)
+    {
+        // Read the file separately so the read and decode are timed
+        // separately.
+        if (buffer != nullptr)
+        {
+            ++_readaheadHits;
+        }
+        else
+        {
+            OFX_PLAYER_TRACE_SCOPE_ID_INDEX("ImageSequence::read", this, index);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            buffer = std::make_shared<ofBuffer>(ofBufferFromFile(path, true));
+            auto end = std::chrono::high_resolution_clock::now();
+
+            _readLatency.add(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+
+        _bytesRead += buffer->size();
+    }
+
+    bool isLoaded = false;
+
+    {
+        // Without a buffer, this includes the blocking file read.
+        OFX_PLAYER_TRACE_SCOPE_ID_INDEX("ImageSequence::decode", this, index);
+
+        bool isTimed = _isStatsEnabled || _isDecodeTimingEnabled;
+
+        std::chrono::high_resolution_clock::time_point start;
+
+        if (isTimed)
+        {
+            start = std::chrono::high_resolution_clock::now();
+        }
+
+        isLoaded = (buffer != nullptr && ofLoadImage(*pixels, *buffer))
+                || ofLoadImage(*pixels, path);
+
+        if (isTimed)
+        {
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double duration = std::chrono::duration<double, std::micro>(end - start).count();
+
+            // An exponential moving average follows changes in image content
+            // and disk load within a few dozen frames.
+            double average = _averageDecodeDuration.load(std::memory_order_relaxed);
+            average = (_decodeCount++ == 0) ? duration : average + (duration - average) * 0.1;
+            _averageDecodeDuration.store(average, std::memory_order_relaxed);
+
+            if (_isStatsEnabled)
+            {
+                _decodeLatency.add(duration);
+            }
+        }
+    }
+
+    if (!isLoaded)
+    {
+        throw std::runtime_error("Unable to load image " + path);
+    }
+
+    return pixels;
+}
+
+
+bool ImageSequence::isPixelsCached(std::size_t index) const
+{
+    // has() does not throw for missing entries or refresh their recency.
+    return _pixelCache->has(index);
+}
+
+
+void ImageSequence::insertImages(std::vector<TimestampedURI>& images)
+{
+    if (images.empty())
+    {
+        return;
+    }
+
+    auto compare = [](const TimestampedURI& lhs, const TimestampedURI& rhs)
+    {
+        return lhs.timestampMicros() < rhs.timestampMicros();
+    };
+
+    std::sort(images.begin(), images.end(), compare);
+
+    materialize();
+
+    // Appending keeps all existing indices (and thus cache keys) valid.
+    if (_images.empty() || images.front().timestampMicros() >= _images.timestampMicros(_images.size() - 1))
+    {
+        for (auto& image: images)
+        {
+            _images.push_back(image);
+        }
+    }
+    else
+    {
+        // Each image is merged after any images with the same timestamp.
+        const auto& timestamps = _images.timestamps();
+
+        std::vector<std::size_t> positions;
+        positions.reserve(images.size());
+
+        for (auto& image: images)
+        {
+            auto position = std::upper_bound(timestamps.begin(),
+                                             timestamps.end(),
+                                             image.timestampMicros());
+            positions.push_back(static_cast<std::size_t>(position - timestamps.begin()));
+        }
+
+        _images.merge(images);
+
+        shiftCaches(positions);
+    }
+}
+
+
+void ImageSequence::shiftCaches(const std::vector<std::size_t>& positions)
+{
+    if (positions.empty())
+    {
+        return;
+    }
+
+    // The old size, since the images were already inserted.
+    std::size_t oldSize = _images.size() - positions.size();
+
+    // Walk backwards so that each frame moves to a key that was already moved.
+    std::size_t offset = positions.size();
+    auto position = positions.rbegin();
+
+    for (std::size_t i = oldSize; i-- > positions.front();)
+    {
+        while (position != positions.rend() && *position > i)
+        {
+            --offset;
+            ++position;
+        }
+
+        if (_pixelCache->has(i))
+        {
+            auto pixels = _pixelCache->get(i);
+            _pixelCache->remove(i);
+            _pixelCache->add(i + offset, pixels);
+        }
+
+        if (_textureCache->has(i))
+        {
+            auto texture = _textureCache->get(i);
+            _textureCache->remove(i);
+            _textureCache->add(i + offset, texture);
+        }
+    }
+
+    if (_reader != nullptr)
+    {
+        // Shift each group of images inserted at the same position, starting
+        // from the front, whose keys were already moved by earlier groups.
+        std::size_t moved = 0;
+
+        for (auto first = positions.begin(); first != positions.end();)
+        {
+            auto last = std::upper_bound(first, positions.end(), *first);
+            std::size_t count = static_cast<std::size_t>(last - first);
+            _reader->shift(*first + moved, count);
+            moved += count;
+            first = last;
+        }
+    }
 }
 
 
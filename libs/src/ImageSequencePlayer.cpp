@@ -6,6 +6,8 @@
 
 
 #include "ofx/Player/ImageSequencePlayer.h"
+#include "ofx/Player/Trace.h"
+#include "ofAppRunner.h"
 
 
 namespace ofx {
@@ -31,6 +33,157 @@ ImageSequencePlayer::~ImageSequencePlayer()
 }
 
 
+void ImageSequencePlayer::update(double elapsedRealTime)
+{
+    OFX_PLAYER_TRACE_SCOPE_ID("ImageSequencePlayer::update", this);
+
+    if (isLoaded() && _data->isFollowing())
+    {
+        _data->appendNewFiles();
+    }
+
+    BasePlayer::update(elapsedRealTime);
+
+    if (isLoaded() && isPlaying() && size() > 0)
+    {
+        bool increasing = (getSpeed() >= 0) == _playhead.playingForward;
+        _data->prefetch(readaheadIndex(increasing), increasing);
+
+        checkDecodeThroughput();
+    }
+}
+
+
+void ImageSequencePlayer::constrainPlayhead(double elapsedTime)
+{
+    if (_liveEdgeLatency < 0)
+    {
+        return;
+    }
+
+    // Trail the live edge once this update has advanced the playhead.
+    int64_t liveEdgeTime = _data->endTimeMicros()
+                         - TimeUtils::roundMicros(_liveEdgeLatency)
+                         - TimeUtils::roundMicros(std::max(elapsedTime, 0.0));
+
+    if (_playhead.timeMicros < liveEdgeTime)
+    {
+        _playhead.timeMicros = liveEdgeTime;
+        _playhead.timeFraction = 0;
+    }
+}
+
+
+void ImageSequencePlayer::setLiveEdgeLatency(double latency)
+{
+    _liveEdgeLatency = latency;
+}
+
+
+double ImageSequencePlayer::getLiveEdgeLatency() const
+{
+    return _liveEdgeLatency;
+}
+
+
+void ImageSequencePlayer::setDecodeThroughputWarningEnabled(bool enabled)
+{
+    _isDecodeThroughputWarningEnabled = enabled;
+}
+
+
+bool ImageSequencePlayer::isDecodeThroughputWarningEnabled() const
+{
+    return _isDecodeThroughputWarningEnabled;
+}
+
+
+double ImageSequencePlayer::getRequiredDecodeThroughput() const
+{
+    if (!isLoaded() || size() < 2 || duration() <= 0)
+    {
+        return 0;
+    }
+
+    double frameRate = (size() - 1) * 1000000.0 / duration();
+    double required = frameRate * std::abs(getSpeed());
+    double targetFrameRate = ofGetTargetFrameRate();
+
+    return targetFrameRate > 0 ? std::min(required, targetFrameRate) : required;
+}
+
+
+double ImageSequencePlayer::getDecodeThroughput() const
+{
+    double decodeDuration = isLoaded() ? _data->getAverageDecodeDuration() : 0;
+    return decodeDuration > 0 ? 1000000.0 / decodeDuration : 0;
+}
+
+
+bool ImageSequencePlayer::isDecodeThroughputSufficient() const
+{
+    return _isDecodeThroughputSufficient;
+}
+
+
+void ImageSequencePlayer::checkDecodeThroughput()
+{
+    uint64_t decodeCount = _data->getDecodeCount();
+
+    // Cached frames cost nothing to show, so only judge updates that decoded.
+    if (decodeCount == _lastDecodeCount)
+    {
+        return;
+    }
+
+    _lastDecodeCount = decodeCount;
+
+    auto now = std::chrono::steady_clock::now();
+
+    double required = getRequiredDecodeThroughput();
+    double throughput = getDecodeThroughput();
+
+    if (throughput <= 0 || required <= throughput)
+    {
+        if (!_isDecodeThroughputSufficient && _isDecodeThroughputWarningEnabled)
+        {
+            ofLogNotice("ImageSequencePlayer::update") << "Decode throughput recovered: " << throughput << " fps decoded, " << required << " fps required.";
+        }
+
+        _isDecodeThroughputSufficient = true;
+        _lastSufficientTime = now;
+        return;
+    }
+
+    // Short stalls, e.g. the first decodes after a seek, are not reported.
+    if (_lastSufficientTime == std::chrono::steady_clock::time_point())
+    {
+        _lastSufficientTime = now;
+    }
+
+    double behind = std::chrono::duration<double, std::micro>(now - _lastSufficientTime).count();
+
+    if (behind < DEFAULT_THROUGHPUT_WARNING_DELAY)
+    {
+        return;
+    }
+
+    double sinceWarning = std::chrono::duration<double, std::micro>(now - _lastThroughputWarningTime).count();
+
+    if (_isDecodeThroughputWarningEnabled
+    && (_isDecodeThroughputSufficient || sinceWarning >= DEFAULT_THROUGHPUT_WARNING_INTERVAL))
+    {
+        double frameRate = (size() - 1) * 1000000.0 / duration();
+
+        ofLogWarning("ImageSequencePlayer::update") << "Decode throughput can not sustain speed " << getSpeed() << ": " << throughput << " fps decoded, " << required << " fps required. The maximum sustainable speed is about " << (throughput / frameRate) << ".";
+
+        _lastThroughputWarningTime = now;
+    }
+
+    _isDecodeThroughputSufficient = false;
+}
+
+
 bool ImageSequencePlayer::load(std::shared_ptr<ImageSequence> data)
 {
     _data = data;
@@ -124,4 +277,15 @@ const BaseTimeIndexed* ImageSequencePlayer::indexedData() const
 }
 
 
+void ImageSequencePlayer::notifyStats()
+{
+    BasePlayer::notifyStats();
+
+    if (_data)
+    {
+        _data->notifyStats();
+    }
+}
+
+
 } } // namespace ofx::Player
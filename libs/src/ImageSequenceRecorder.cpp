@@ -0,0 +1,447 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/ImageSequenceRecorder.h"
+#include "ofLog.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Timestamp.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+const std::string ImageSequenceRecorder::DEFAULT_EXTENSION = "jpg";
+
+
+ImageSequenceRecorder::ImageSequenceRecorder()
+{
+}
+
+
+ImageSequenceRecorder::~ImageSequenceRecorder()
+{
+    stop();
+}
+
+
+bool ImageSequenceRecorder::start(const std::string& directory,
+                                  const std::string& extension,
+                                  std::size_t threadCount,
+                                  std::size_t queueSize,
+                                  OverflowPolicy policy)
+{
+    stop();
+
+    std::error_code error;
+
+    std::filesystem::create_directories(directory, error);
+
+    if (error || !std::filesystem::is_directory(directory))
+    {
+        ofLogError("ImageSequenceRecorder::start") << "Unable to create directory: " << directory;
+        return false;
+    }
+
+    _directory = std::filesystem::absolute(directory, error).string();
+    _extension = extension;
+    _queueSize = std::max(queueSize, std::size_t(1));
+    _policy = policy;
+    _lastMilliseconds = std::numeric_limits<int64_t>::min();
+    _nextQueuedSequence = 0;
+    _droppedCount = 0;
+    _failedCount = 0;
+
+    {
+        std::unique_lock<std::mutex> lock(_manifestMutex);
+        _images.clear();
+        _nextFinishedSequence = 0;
+        _finishedFrames.clear();
+        _width = 0;
+        _height = 0;
+
+        _journal.open(getJournalPath(), std::ios::out | std::ios::trunc);
+
+        if (!_journal.is_open())
+        {
+            ofLogError("ImageSequenceRecorder::start") << "Unable to open journal: " << getJournalPath();
+            return false;
+        }
+    }
+
+    _recording = true;
+
+    for (std::size_t i = 0; i < std::max(threadCount, std::size_t(1)); ++i)
+    {
+        _threads.push_back(std::thread(&ImageSequenceRecorder::run, this));
+    }
+
+    return true;
+}
+
+
+void ImageSequenceRecorder::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (!_recording)
+        {
+            return;
+        }
+
+        _recording = false;
+    }
+
+    _frameAvailable.notify_all();
+    _spaceAvailable.notify_all();
+
+    // The workers drain the queue before exiting.
+    for (auto& thread: _threads)
+    {
+        thread.join();
+    }
+
+    _threads.clear();
+
+    std::unique_lock<std::mutex> lock(_manifestMutex);
+
+    _journal.close();
+
+    // The journal is only needed until the manifest is saved.
+    if (saveManifest())
+    {
+        std::error_code error;
+        std::filesystem::remove(getJournalPath(), error);
+    }
+}
+
+
+bool ImageSequenceRecorder::isRecording() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _recording;
+}
+
+
+bool ImageSequenceRecorder::add(const ofPixels& pixels)
+{
+    return add(pixels, Poco::Timestamp().epochMicroseconds());
+}
+
+
+bool ImageSequenceRecorder::add(const ofPixels& pixels, int64_t timestamp)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (!_recording)
+    {
+        return false;
+    }
+
+    if (_queue.size() >= _queueSize)
+    {
+        if (_policy == OverflowPolicy::DROP)
+        {
+            ++_droppedCount;
+            return false;
+        }
+
+        _spaceAvailable.wait(lock, [this]() {
+            return _queue.size() < _queueSize || !_recording;
+        });
+
+        if (!_recording)
+        {
+            return false;
+        }
+    }
+
+    // Filenames have millisecond resolution, so keep them unique.
+    int64_t milliseconds = timestamp / 1000 - (timestamp % 1000 < 0 ? 1 : 0);
+
+    if (milliseconds <= _lastMilliseconds)
+    {
+        milliseconds = _lastMilliseconds + 1;
+    }
+
+    _lastMilliseconds = milliseconds;
+
+    Frame frame;
+
+    if (!_pool.empty())
+    {
+        frame = std::move(_pool.back());
+        _pool.pop_back();
+    }
+
+    // Copying into recycled pixels of the same size does not allocate.
+    frame.pixels = pixels;
+    frame.timestamp = milliseconds * 1000;
+    frame.uri = Poco::DateTimeFormatter::format(Poco::Timestamp(milliseconds * 1000),
+                                                FilenameTimestamper::DEFAULT_TIMESTAMP_FORMAT);
+    frame.uri += ".";
+    frame.uri += _extension;
+    frame.sequence = _nextQueuedSequence++;
+
+    _queue.push_back(std::move(frame));
+
+    lock.unlock();
+
+    _frameAvailable.notify_one();
+
+    return true;
+}
+
+
+std::size_t ImageSequenceRecorder::getWrittenCount() const
+{
+    std::unique_lock<std::mutex> lock(_manifestMutex);
+    return _images.size();
+}
+
+
+std::size_t ImageSequenceRecorder::getDroppedCount() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _droppedCount;
+}
+
+
+std::size_t ImageSequenceRecorder::getFailedCount() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _failedCount;
+}
+
+
+std::size_t ImageSequenceRecorder::getQueuedCount() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _queue.size() + _activeCount;
+}
+
+
+void ImageSequenceRecorder::setManifestInterval(std::size_t interval)
+{
+    std::unique_lock<std::mutex> lock(_manifestMutex);
+    _manifestInterval = interval;
+}
+
+
+std::size_t ImageSequenceRecorder::getManifestInterval() const
+{
+    std::unique_lock<std::mutex> lock(_manifestMutex);
+    return _manifestInterval;
+}
+
+
+std::string ImageSequenceRecorder::getManifestPath() const
+{
+    return getManifestPath(_directory);
+}
+
+
+std::string ImageSequenceRecorder::getManifestPath(const std::string& directory)
+{
+    std::filesystem::path path(directory);
+    return (path / (path.filename().string() + ".json")).string();
+}
+
+
+bool ImageSequenceRecorder::writeManifest(const std::string& directory,
+                                          float width,
+                                          float height,
+                                          const TimestampedURIIndex& images)
+{
+    ofJson json;
+    json["name"] = std::filesystem::path(directory).filename().string();
+    json["base_directory"] = directory;
+    json["width"] = width;
+    json["height"] = height;
+    json["images"] = ofJson::array();
+
+    images.forEach([&](const std::string& uri, int64_t timestamp)
+    {
+        json["images"].push_back({
+            { "uri", uri },
+            { "ts", timestamp }
+        });
+    });
+
+    std::string path = getManifestPath(directory);
+    std::string temporaryPath = path + ".tmp";
+
+    if (!ofSaveJson(temporaryPath, json))
+    {
+        ofLogError("ImageSequenceRecorder::writeManifest") << "Unable to write manifest: " << temporaryPath;
+        return false;
+    }
+
+    std::error_code error;
+
+    std::filesystem::rename(temporaryPath, path, error);
+
+    if (error)
+    {
+        ofLogError("ImageSequenceRecorder::writeManifest") << "Unable to replace manifest: " << path << ": " << error.message();
+        return false;
+    }
+
+    return true;
+}
+
+
+std::string ImageSequenceRecorder::getJournalPath() const
+{
+    return getManifestPath() + ".journal";
+}
+
+
+void ImageSequenceRecorder::run()
+{
+    while (true)
+    {
+        Frame frame;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _frameAvailable.wait(lock, [this]() {
+                return !_queue.empty() || !_recording;
+            });
+
+            if (_queue.empty())
+            {
+                // Only exit once the queue is drained.
+                return;
+            }
+
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+            ++_activeCount;
+        }
+
+        _spaceAvailable.notify_one();
+
+        std::string path = (std::filesystem::path(_directory) / frame.uri).string();
+
+        bool success = ofSaveImage(frame.pixels, path);
+
+        if (!success)
+        {
+            ofLogError("ImageSequenceRecorder::run") << "Unable to write image: " << path;
+        }
+
+        addToManifest(frame, success);
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            --_activeCount;
+
+            if (!success)
+            {
+                ++_failedCount;
+            }
+
+            if (_pool.size() < _queueSize)
+            {
+                _pool.push_back(std::move(frame));
+            }
+        }
+    }
+}
+
+
+void ImageSequenceRecorder::addToManifest(const Frame& frame, bool success)
+{
+    std::unique_lock<std::mutex> lock(_manifestMutex);
+
+    if (success && _width == 0 && _height == 0)
+    {
+        _width = frame.pixels.getWidth();
+        _height = frame.pixels.getHeight();
+    }
+
+    // Hold frames that finished before an earlier frame, so images are
+    // always appended in timestamp order.
+    if (frame.sequence != _nextFinishedSequence)
+    {
+        FinishedFrame finished;
+        finished.sequence = frame.sequence;
+        finished.success = success;
+        finished.uri = frame.uri;
+        finished.timestamp = frame.timestamp;
+        _finishedFrames.push_back(std::move(finished));
+        return;
+    }
+
+    if (success)
+    {
+        appendToManifest(frame.uri, frame.timestamp);
+    }
+
+    ++_nextFinishedSequence;
+
+    // Release the held frames that are now next in order.
+    while (!_finishedFrames.empty())
+    {
+        auto iter = std::find_if(_finishedFrames.begin(),
+                                 _finishedFrames.end(),
+                                 [this](const FinishedFrame& finished)
+                                 {
+                                     return finished.sequence == _nextFinishedSequence;
+                                 });
+
+        if (iter == _finishedFrames.end())
+        {
+            break;
+        }
+
+        if (iter->success)
+        {
+            appendToManifest(iter->uri, iter->timestamp);
+        }
+
+        _finishedFrames.erase(iter);
+
+        ++_nextFinishedSequence;
+    }
+}
+
+
+void ImageSequenceRecorder::appendToManifest(const std::string& uri, int64_t timestamp)
+{
+    _images.push_back(uri, timestamp);
+
+    ofJson line = {
+        { "uri", uri },
+        { "ts", timestamp }
+    };
+
+    _journal << line.dump() << "\n";
+
+    if (_manifestInterval > 0 && _images.size() % _manifestInterval == 0)
+    {
+        _journal.flush();
+    }
+}
+
+
+bool ImageSequenceRecorder::saveManifest()
+{
+    if (_directory.empty())
+    {
+        return false;
+    }
+
+    return writeManifest(_directory, _width, _height, _images);
+}
+
+
+} } // namespace ofx::Player
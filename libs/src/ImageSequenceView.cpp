@@ -0,0 +1,426 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/ImageSequenceView.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace ofx {
+namespace Player {
+
+
+ImageSequenceView::ImageSequenceView()
+{
+    rebuild();
+}
+
+
+ImageSequenceView::ImageSequenceView(std::shared_ptr<ImageSequence> sequence)
+{
+    append(sequence);
+}
+
+
+ImageSequenceView::ImageSequenceView(std::shared_ptr<ImageSequence> sequence,
+                                     std::size_t begin,
+                                     std::size_t end)
+{
+    append(sequence, begin, end);
+}
+
+
+ImageSequenceView::~ImageSequenceView()
+{
+}
+
+
+bool ImageSequenceView::append(std::shared_ptr<ImageSequence> sequence)
+{
+    if (sequence == nullptr)
+    {
+        ofLogError("ImageSequenceView::append") << "Sequence is nullptr.";
+        return false;
+    }
+
+    return append(sequence, 0, sequence->size());
+}
+
+
+bool ImageSequenceView::append(std::shared_ptr<ImageSequence> sequence,
+                               std::size_t begin,
+                               std::size_t end,
+                               bool reversed,
+                               double scale)
+{
+    Segment segment;
+    segment.sequence = sequence;
+    segment.begin = begin;
+    segment.end = end;
+    segment.reversed = reversed;
+    segment.scale = scale;
+
+    if (!isValidSegment(segment))
+    {
+        return false;
+    }
+
+    _segments.push_back(segment);
+    rebuild();
+    return true;
+}
+
+
+bool ImageSequenceView::append(const ImageSequenceView& view)
+{
+    if (view._segments.empty())
+    {
+        return false;
+    }
+
+    // Copy first, since the view may be this view.
+    std::vector<Segment> segments = view._segments;
+
+    for (Segment& segment: segments)
+    {
+        segment.scale *= view._timeScale;
+    }
+
+    _segments.insert(_segments.end(), segments.begin(), segments.end());
+    rebuild();
+    return true;
+}
+
+
+void ImageSequenceView::clear()
+{
+    _segments.clear();
+    rebuild();
+}
+
+
+void ImageSequenceView::reverse()
+{
+    std::reverse(_segments.begin(), _segments.end());
+
+    for (Segment& segment: _segments)
+    {
+        segment.reversed = !segment.reversed;
+    }
+
+    rebuild();
+}
+
+
+ImageSequenceView ImageSequenceView::slice(std::size_t begin, std::size_t end) const
+{
+    ImageSequenceView view;
+    view._timeOffset = _timeOffset;
+    view._timeScale = _timeScale;
+
+    end = std::min(end, size());
+
+    if (begin >= end)
+    {
+        return view;
+    }
+
+    for (std::size_t i = segmentForIndex(begin); i < _segments.size() && _segmentIndexes[i] < end; ++i)
+    {
+        Segment segment = _segments[i];
+
+        // The slice within the segment, relative to its first view index.
+        std::size_t first = std::max(begin, _segmentIndexes[i]) - _segmentIndexes[i];
+        std::size_t last = std::min(end, _segmentIndexes[i + 1]) - _segmentIndexes[i];
+
+        if (segment.reversed)
+        {
+            segment.begin = _segments[i].end - last;
+            segment.end = _segments[i].end - first;
+        }
+        else
+        {
+            segment.begin = _segments[i].begin + first;
+            segment.end = _segments[i].begin + last;
+        }
+
+        view._segments.push_back(segment);
+    }
+
+    view.rebuild();
+    return view;
+}
+
+
+void ImageSequenceView::setTimeOffset(int64_t offset)
+{
+    // The first frame has the earliest time, so it must not be negative.
+    if (offset < 0)
+    {
+        ofLogError("ImageSequenceView::setTimeOffset") << "The time offset must not be negative.";
+        return;
+    }
+
+    _timeOffset = offset;
+}
+
+
+int64_t ImageSequenceView::getTimeOffset() const
+{
+    return _timeOffset;
+}
+
+
+void ImageSequenceView::setTimeScale(double scale)
+{
+    if (scale <= 0)
+    {
+        ofLogError("ImageSequenceView::setTimeScale") << "The time scale must be positive.";
+        return;
+    }
+
+    _timeScale = scale;
+}
+
+
+double ImageSequenceView::getTimeScale() const
+{
+    return _timeScale;
+}
+
+
+std::size_t ImageSequenceView::segmentCount() const
+{
+    return _segments.size();
+}
+
+
+const ImageSequenceView::Segment& ImageSequenceView::segment(std::size_t segment) const
+{
+    return _segments[segment];
+}
+
+
+std::size_t ImageSequenceView::segmentForIndex(std::size_t index) const
+{
+    // Segments are never empty, so the last segment starting at or before the
+    // index contains it.
+    auto iter = std::upper_bound(_segmentIndexes.begin(), _segmentIndexes.end() - 1, index);
+    return static_cast<std::size_t>(iter - _segmentIndexes.begin()) - 1;
+}
+
+
+const std::shared_ptr<ImageSequence>& ImageSequenceView::sequence(std::size_t index) const
+{
+    return _segments[segmentForIndex(index)].sequence;
+}
+
+
+std::size_t ImageSequenceView::sourceIndex(std::size_t index) const
+{
+    std::size_t i = segmentForIndex(index);
+    const Segment& segment = _segments[i];
+    std::size_t offset = index - _segmentIndexes[i];
+    return segment.reversed ? segment.end - 1 - offset : segment.begin + offset;
+}
+
+
+double ImageSequenceView::timeForIndex(std::size_t index) const
+{
+    return static_cast<double>(timeForIndexMicros(index));
+}
+
+
+int64_t ImageSequenceView::timeForIndexMicros(std::size_t index) const
+{
+    if (index >= size())
+    {
+        ofLogError("ImageSequenceView::timeForIndexMicros") << "Index " << index << " is out of range for a view of " << size() << " frames.";
+        return _timeOffset;
+    }
+
+    std::size_t i = segmentForIndex(index);
+    const Segment& segment = _segments[i];
+    std::size_t offset = index - _segmentIndexes[i];
+
+    int64_t elapsed = 0;
+
+    // The sequence may have lost frames since the view was last changed. The
+    // frames of such a segment are reported at the start of the segment.
+    if (!isSegmentInRange(segment))
+    {
+        ofLogError("ImageSequenceView::timeForIndexMicros") << "Segment " << i << " frames [" << segment.begin << ", " << segment.end << ") are out of range for a sequence of " << segment.sequence->size() << " frames.";
+    }
+    else
+    {
+        // Reversed segments measure time back from their last frame.
+        elapsed = segment.reversed
+                ? segment.sequence->timeForIndexMicros(segment.end - 1) - segment.sequence->timeForIndexMicros(segment.end - 1 - offset)
+                : segment.sequence->timeForIndexMicros(segment.begin + offset) - segment.sequence->timeForIndexMicros(segment.begin);
+
+        if (segment.scale != 1)
+        {
+            elapsed = TimeUtils::roundMicros(segment.scale * elapsed);
+        }
+    }
+
+    int64_t time = _segmentTimes[i] + elapsed;
+
+    if (_timeScale != 1)
+    {
+        time = TimeUtils::roundMicros(_timeScale * time);
+    }
+
+    return _timeOffset + time;
+}
+
+
+std::size_t ImageSequenceView::size() const
+{
+    return _segmentIndexes.empty() ? 0 : _segmentIndexes.back();
+}
+
+
+float ImageSequenceView::getWidth() const
+{
+    return _segments.empty() ? 0 : _segments.front().sequence->getWidth();
+}
+
+
+float ImageSequenceView::getHeight() const
+{
+    return _segments.empty() ? 0 : _segments.front().sequence->getHeight();
+}
+
+
+const ofPixels& ImageSequenceView::getPixels(std::size_t index) const
+{
+    if (index >= size())
+    {
+        throw std::out_of_range("Index out of range: " + std::to_string(index));
+    }
+
+    // The sequence checks the source index against its current size.
+    return sequence(index)->getPixels(sourceIndex(index));
+}
+
+
+const ofTexture& ImageSequenceView::getTexture(std::size_t index) const
+{
+    if (index >= size())
+    {
+        throw std::out_of_range("Index out of range: " + std::to_string(index));
+    }
+
+    return sequence(index)->getTexture(sourceIndex(index));
+}
+
+
+void ImageSequenceView::prefetch(std::size_t index, bool increasing)
+{
+    if (index >= size())
+    {
+        return;
+    }
+
+    const Segment& segment = _segments[segmentForIndex(index)];
+
+    if (!isSegmentInRange(segment))
+    {
+        return;
+    }
+
+    segment.sequence->prefetch(sourceIndex(index), increasing != segment.reversed);
+}
+
+
+void ImageSequenceView::rebuild()
+{
+    // A sequence may have lost frames since a segment was added, e.g. by a
+    // refresh, so clamp each segment to its sequence and drop empty ones.
+    std::size_t segmentCount = _segments.size();
+    bool isClamped = false;
+
+    for (Segment& segment: _segments)
+    {
+        if (segment.end > segment.sequence->size())
+        {
+            segment.end = segment.sequence->size();
+            isClamped = true;
+        }
+    }
+
+    _segments.erase(std::remove_if(_segments.begin(),
+                                   _segments.end(),
+                                   [](const Segment& segment)
+                                   {
+                                       return segment.begin >= segment.end;
+                                   }),
+                    _segments.end());
+
+    if (isClamped)
+    {
+        ofLogWarning("ImageSequenceView::rebuild") << "Clamped segments to their sequences, removing " << (segmentCount - _segments.size()) << " empty segments.";
+    }
+
+    _segmentIndexes.assign(1, 0);
+    _segmentTimes.clear();
+
+    int64_t time = 0;
+
+    for (const Segment& segment: _segments)
+    {
+        const ImageSequence& sequence = *segment.sequence;
+
+        int64_t frameDuration = DEFAULT_FRAME_DURATION;
+
+        if (sequence.size() > 1 && sequence.endTimeMicros() > sequence.startTimeMicros())
+        {
+            frameDuration = (sequence.endTimeMicros() - sequence.startTimeMicros()) / static_cast<int64_t>(sequence.size() - 1);
+        }
+
+        int64_t span = sequence.timeForIndexMicros(segment.end - 1) - sequence.timeForIndexMicros(segment.begin);
+
+        _segmentIndexes.push_back(_segmentIndexes.back() + (segment.end - segment.begin));
+        _segmentTimes.push_back(time);
+
+        time += TimeUtils::roundMicros(segment.scale * (span + frameDuration));
+    }
+}
+
+
+bool ImageSequenceView::isSegmentInRange(const Segment& segment)
+{
+    return segment.begin < segment.end && segment.end <= segment.sequence->size();
+}
+
+
+bool ImageSequenceView::isValidSegment(const Segment& segment)
+{
+    if (segment.sequence == nullptr)
+    {
+        ofLogError("ImageSequenceView::append") << "Sequence is nullptr.";
+        return false;
+    }
+
+    if (!isSegmentInRange(segment))
+    {
+        ofLogError("ImageSequenceView::append") << "Invalid frame range [" << segment.begin << ", " << segment.end << ") for a sequence of " << segment.sequence->size() << " frames.";
+        return false;
+    }
+
+    if (segment.scale <= 0)
+    {
+        ofLogError("ImageSequenceView::append") << "The time scale must be positive.";
+        return false;
+    }
+
+    return true;
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/ImageSequenceViewPlayer.h"
+#include "ofx/Player/ImageSequencePlayer.h"
+#include "ofx/Player/Trace.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+ImageSequenceViewPlayer::ImageSequenceViewPlayer(): ImageSequenceViewPlayer(nullptr)
+{
+}
+
+
+ImageSequenceViewPlayer::ImageSequenceViewPlayer(std::shared_ptr<ImageSequenceView> data): _data(data)
+{
+}
+
+
+ImageSequenceViewPlayer::~ImageSequenceViewPlayer()
+{
+}
+
+
+void ImageSequenceViewPlayer::update(double elapsedRealTime)
+{
+    OFX_PLAYER_TRACE_SCOPE_ID("ImageSequenceViewPlayer::update", this);
+
+    BasePlayer::update(elapsedRealTime);
+
+    if (isLoaded() && isPlaying() && size() > 0)
+    {
+        bool increasing = (getSpeed() >= 0) == _playhead.playingForward;
+        _data->prefetch(readaheadIndex(increasing), increasing);
+    }
+}
+
+
+bool ImageSequenceViewPlayer::load(std::shared_ptr<ImageSequenceView> data)
+{
+    _data = data;
+    return true;
+}
+
+
+void ImageSequenceViewPlayer::close()
+{
+    _data.reset();
+}
+
+
+bool ImageSequenceViewPlayer::isFrameNew() const
+{
+    return isFrameIndexNew();
+}
+
+
+float ImageSequenceViewPlayer::getWidth() const
+{
+    return isLoaded() ? _data->getWidth() : 0;
+}
+
+
+float ImageSequenceViewPlayer::getHeight() const
+{
+    return isLoaded() ? _data->getHeight() : 0;
+}
+
+
+const ofPixels& ImageSequenceViewPlayer::getPixels() const
+{
+    if (isLoaded() && size() > 0)
+    {
+        try
+        {
+            return _data->getPixels(getFrameIndex());
+        }
+        catch (const std::exception& exc)
+        {
+            ofLogError("ImageSequenceViewPlayer::getPixels") << exc.what();
+        }
+    }
+
+    return ImageSequencePlayer::EMPTY_PIXELS;
+}
+
+
+const ofTexture& ImageSequenceViewPlayer::getTexture() const
+{
+    if (isLoaded() && size() > 0)
+    {
+        try
+        {
+            return _data->getTexture(getFrameIndex());
+        }
+        catch (const std::exception& exc)
+        {
+            ofLogError("ImageSequenceViewPlayer::getTexture") << exc.what();
+        }
+    }
+
+    return ImageSequencePlayer::EMPTY_TEXTURE;
+}
+
+
+const BaseTimeIndexed* ImageSequenceViewPlayer::indexedData() const
+{
+    return _data.get();
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/MappedFile.h"
+#include "ofLog.h"
+
+
+#if defined(TARGET_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace Player {
+
+
+MappedFile::MappedFile()
+{
+}
+
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    open(filename);
+}
+
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+
+bool MappedFile::open(const std::string& filename)
+{
+    close();
+
+#if defined(TARGET_WIN32)
+    HANDLE file = ::CreateFileA(filename.c_str(),
+                                GENERIC_READ,
+                                FILE_SHARE_READ,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        ofLogError("MappedFile::open") << "Unable to open file: " << filename;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        ofLogError("MappedFile::open") << "Unable to map empty file: " << filename;
+        ::CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping == nullptr)
+    {
+        ofLogError("MappedFile::open") << "Unable to map file: " << filename;
+        ::CloseHandle(file);
+        return false;
+    }
+
+    void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (data == nullptr)
+    {
+        ofLogError("MappedFile::open") << "Unable to map file: " << filename;
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    _file = file;
+    _mapping = mapping;
+    _data = static_cast<const uint8_t*>(data);
+    _size = static_cast<std::size_t>(size.QuadPart);
+    return true;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        ofLogError("MappedFile::open") << "Unable to open file: " << filename;
+        return false;
+    }
+
+    struct stat info;
+
+    if (::fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ofLogError("MappedFile::open") << "Unable to map empty file: " << filename;
+        ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping remains valid after the descriptor is closed.
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        ofLogError("MappedFile::open") << "Unable to map file: " << filename;
+        return false;
+    }
+
+    _data = static_cast<const uint8_t*>(data);
+    _size = static_cast<std::size_t>(info.st_size);
+    return true;
+#endif
+}
+
+
+void MappedFile::close()
+{
+    if (_data == nullptr)
+    {
+        return;
+    }
+
+#if defined(TARGET_WIN32)
+    ::UnmapViewOfFile(_data);
+    ::CloseHandle(_mapping);
+    ::CloseHandle(_file);
+    _mapping = nullptr;
+    _file = nullptr;
+#else
+    ::munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
+
+
+bool MappedFile::isOpen() const
+{
+    return _data != nullptr;
+}
+
+
+const uint8_t* MappedFile::data() const
+{
+    return _data;
+}
+
+
+std::size_t MappedFile::size() const
+{
+    return _size;
+}
+
+
+} } // namespace ofx::Player
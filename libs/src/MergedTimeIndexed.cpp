@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/MergedTimeIndexed.h"
+#include <algorithm>
+#include <queue>
+
+
+namespace ofx {
+namespace Player {
+
+
+MergedTimeIndexed::MergedTimeIndexed()
+{
+}
+
+
+MergedTimeIndexed::MergedTimeIndexed(const std::vector<std::shared_ptr<const AbstractTimeIndexed>>& sources)
+{
+    for (auto& source: sources)
+    {
+        if (source == nullptr)
+        {
+            ofLogError("MergedTimeIndexed::MergedTimeIndexed") << "Source is nullptr.";
+        }
+        else
+        {
+            _sources.push_back(source);
+        }
+    }
+
+    rebuild();
+}
+
+
+MergedTimeIndexed::~MergedTimeIndexed()
+{
+}
+
+
+std::size_t MergedTimeIndexed::addSource(std::shared_ptr<const AbstractTimeIndexed> source)
+{
+    if (source == nullptr)
+    {
+        ofLogError("MergedTimeIndexed::addSource") << "Source is nullptr.";
+        return _sources.size();
+    }
+
+    _sources.push_back(source);
+    rebuild();
+    return _sources.size() - 1;
+}
+
+
+void MergedTimeIndexed::clear()
+{
+    _sources.clear();
+    _mergedCounts.clear();
+    _entries.clear();
+    _timestamps.clear();
+}
+
+
+std::size_t MergedTimeIndexed::sourceCount() const
+{
+    return _sources.size();
+}
+
+
+std::shared_ptr<const AbstractTimeIndexed> MergedTimeIndexed::getSource(std::size_t source) const
+{
+    return _sources[source];
+}
+
+
+bool MergedTimeIndexed::update()
+{
+    bool hasNewEntries = false;
+
+    // The first merged entry that belongs after a new entry.
+    std::size_t cut = _entries.size();
+
+    for (std::size_t i = 0; i < _sources.size(); ++i)
+    {
+        std::size_t size = _sources[i]->size();
+
+        if (size < _mergedCounts[i])
+        {
+            // The source shrank, so the merged entries are stale.
+            rebuild();
+            return true;
+        }
+        else if (size > _mergedCounts[i])
+        {
+            hasNewEntries = true;
+
+            double timestamp = _sources[i]->timeForIndex(_mergedCounts[i]);
+
+            // Entries with equal timestamps are ordered by source.
+            std::size_t position = std::upper_bound(_timestamps.begin(),
+                                                    _timestamps.begin() + cut,
+                                                    timestamp) - _timestamps.begin();
+
+            while (position > 0
+               &&  _timestamps[position - 1] == timestamp
+               &&  _entries[position - 1].source > i)
+            {
+                --position;
+            }
+
+            cut = std::min(cut, position);
+        }
+    }
+
+    if (!hasNewEntries)
+    {
+        return false;
+    }
+
+    // Only the entries after the earliest new entry are merged again. Each
+    // source's entries are in index order, so its merged count rewinds to its
+    // first removed entry.
+    for (std::size_t i = cut; i < _entries.size(); ++i)
+    {
+        std::size_t& count = _mergedCounts[_entries[i].source];
+        count = std::min(count, _entries[i].index);
+    }
+
+    _entries.resize(cut);
+    _timestamps.resize(cut);
+
+    merge();
+
+    return true;
+}
+
+
+void MergedTimeIndexed::rebuild()
+{
+    _mergedCounts.assign(_sources.size(), 0);
+    _entries.clear();
+    _timestamps.clear();
+    merge();
+}
+
+
+double MergedTimeIndexed::timeForIndex(std::size_t index) const
+{
+    return _timestamps[index];
+}
+
+
+std::size_t MergedTimeIndexed::size() const
+{
+    return _timestamps.size();
+}
+
+
+const double* MergedTimeIndexed::timestampData() const
+{
+    return _timestamps.data();
+}
+
+
+const MergedTimeIndexed::Entry& MergedTimeIndexed::operator [] (std::size_t index) const
+{
+    return _entries[index];
+}
+
+
+std::size_t MergedTimeIndexed::source(std::size_t index) const
+{
+    return _entries[index].source;
+}
+
+
+std::size_t MergedTimeIndexed::sourceIndex(std::size_t index) const
+{
+    return _entries[index].index;
+}
+
+
+void MergedTimeIndexed::merge()
+{
+    // The heap holds the next unmerged entry of each source.
+    struct Head
+    {
+        double timestamp;
+        std::size_t source;
+    };
+
+    auto isAfter = [](const Head& a, const Head& b)
+    {
+        return a.timestamp > b.timestamp
+           || (a.timestamp == b.timestamp && a.source > b.source);
+    };
+
+    std::priority_queue<Head, std::vector<Head>, decltype(isAfter)> heads(isAfter);
+
+    std::size_t total = _entries.size();
+
+    for (std::size_t i = 0; i < _sources.size(); ++i)
+    {
+        std::size_t size = _sources[i]->size();
+
+        total += size - _mergedCounts[i];
+
+        if (_mergedCounts[i] < size)
+        {
+            heads.push({ _sources[i]->timeForIndex(_mergedCounts[i]), i });
+        }
+    }
+
+    _entries.reserve(total);
+    _timestamps.reserve(total);
+
+    while (!heads.empty())
+    {
+        Head head = heads.top();
+        heads.pop();
+
+        std::size_t& index = _mergedCounts[head.source];
+
+        _entries.push_back({ head.source, index });
+        _timestamps.push_back(head.timestamp);
+
+        ++index;
+
+        const AbstractTimeIndexed& source = *_sources[head.source];
+
+        if (index < source.size())
+        {
+            heads.push({ source.timeForIndex(index), head.source });
+        }
+    }
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/OverviewPyramid.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+OverviewPyramid::OverviewPyramid(const BaseTimeIndexed& indexed,
+                                 ValueAccessor value,
+                                 std::size_t blockSize):
+    _indexed(indexed),
+    _value(value),
+    _blockSize(std::max(blockSize, std::size_t(1)))
+{
+    rebuild();
+}
+
+
+OverviewPyramid::~OverviewPyramid()
+{
+}
+
+
+bool OverviewPyramid::update()
+{
+    std::size_t newSize = _indexed.size();
+
+    if (newSize < _size)
+    {
+        rebuild();
+        return true;
+    }
+
+    if (newSize == _size)
+    {
+        return false;
+    }
+
+    // The last block may have been partial, so it is summarized again.
+    std::size_t firstDirty = _size / _blockSize;
+    std::size_t blockCount = (newSize + _blockSize - 1) / _blockSize;
+
+    if (_levels.empty())
+    {
+        _levels.resize(1);
+    }
+
+    _levels[0].resize(blockCount);
+
+    for (std::size_t i = firstDirty; i < blockCount; ++i)
+    {
+        Summary summary;
+        addSamples(summary, i * _blockSize, std::min((i + 1) * _blockSize, newSize));
+        _levels[0][i] = summary;
+    }
+
+    // Each parent summarizes a pair of children.
+    std::size_t level = 0;
+
+    while (_levels[level].size() > 1)
+    {
+        std::size_t childCount = _levels[level].size();
+        std::size_t parentCount = (childCount + 1) / 2;
+
+        if (_levels.size() == level + 1)
+        {
+            _levels.resize(level + 2);
+        }
+
+        firstDirty /= 2;
+
+        std::vector<Summary>& children = _levels[level];
+        std::vector<Summary>& parents = _levels[level + 1];
+
+        parents.resize(parentCount);
+
+        for (std::size_t i = firstDirty; i < parentCount; ++i)
+        {
+            Summary summary = children[2 * i];
+
+            if (2 * i + 1 < childCount)
+            {
+                summary.add(children[2 * i + 1]);
+            }
+
+            parents[i] = summary;
+        }
+
+        ++level;
+    }
+
+    _size = newSize;
+
+    return true;
+}
+
+
+void OverviewPyramid::rebuild()
+{
+    _levels.clear();
+    _size = 0;
+    update();
+}
+
+
+OverviewPyramid::Summary OverviewPyramid::summary(std::size_t firstIndex,
+                                                  std::size_t lastIndex) const
+{
+    Summary result;
+
+    lastIndex = std::min(lastIndex, _size);
+
+    if (firstIndex >= lastIndex)
+    {
+        return result;
+    }
+
+    // Only complete blocks are read from the pyramid.
+    std::size_t firstBlock = (firstIndex + _blockSize - 1) / _blockSize;
+    std::size_t lastBlock = lastIndex / _blockSize;
+
+    if (firstBlock >= lastBlock)
+    {
+        addSamples(result, firstIndex, lastIndex);
+        return result;
+    }
+
+    addSamples(result, firstIndex, firstBlock * _blockSize);
+    addSamples(result, lastBlock * _blockSize, lastIndex);
+
+    // Walk up the levels, adding the nodes at the edges of the range.
+    std::size_t level = 0;
+
+    while (firstBlock < lastBlock)
+    {
+        if (firstBlock & 1)
+        {
+            result.add(_levels[level][firstBlock++]);
+        }
+
+        if (lastBlock & 1)
+        {
+            result.add(_levels[level][--lastBlock]);
+        }
+
+        firstBlock /= 2;
+        lastBlock /= 2;
+        ++level;
+    }
+
+    return result;
+}
+
+
+void OverviewPyramid::summaries(double startTime,
+                                double endTime,
+                                std::size_t bucketCount,
+                                Summary* summaries) const
+{
+    if (bucketCount == 0)
+    {
+        return;
+    }
+
+    double step = (endTime - startTime) / bucketCount;
+
+    std::size_t firstIndex = std::min(_indexed.lowerBound(startTime), _size);
+
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        std::size_t lastIndex = 0;
+
+        if (i + 1 == bucketCount)
+        {
+            lastIndex = _indexed.upperBound(endTime, firstIndex);
+        }
+        else
+        {
+            lastIndex = _indexed.lowerBound(startTime + step * (i + 1), firstIndex);
+        }
+
+        lastIndex = std::max(std::min(lastIndex, _size), firstIndex);
+
+        summaries[i] = summary(firstIndex, lastIndex);
+
+        firstIndex = lastIndex;
+    }
+}
+
+
+std::vector<OverviewPyramid::Summary> OverviewPyramid::summaries(double startTime,
+                                                                 double endTime,
+                                                                 std::size_t bucketCount) const
+{
+    std::vector<Summary> results(bucketCount);
+    summaries(startTime, endTime, bucketCount, results.data());
+    return results;
+}
+
+
+OverviewPyramid::Summary OverviewPyramid::summary() const
+{
+    if (_levels.empty())
+    {
+        return Summary();
+    }
+
+    return _levels.back().front();
+}
+
+
+std::size_t OverviewPyramid::size() const
+{
+    return _size;
+}
+
+
+std::size_t OverviewPyramid::blockSize() const
+{
+    return _blockSize;
+}
+
+
+std::size_t OverviewPyramid::levelCount() const
+{
+    return _levels.size();
+}
+
+
+void OverviewPyramid::addSamples(Summary& summary,
+                                 std::size_t firstIndex,
+                                 std::size_t lastIndex) const
+{
+    for (std::size_t i = firstIndex; i < lastIndex; ++i)
+    {
+        summary.add(_value(i));
+    }
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/PlayerStats.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace ofx {
+namespace Player {
+
+
+double LatencyHistogram::Snapshot::mean() const
+{
+    return count > 0 ? double(sum) / count : 0;
+}
+
+
+double LatencyHistogram::Snapshot::percentile(double percentile) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::max(0.0, std::min(percentile, 1.0)) * count));
+    rank = std::max(rank, uint64_t(1));
+
+    uint64_t total = 0;
+
+    for (std::size_t i = 0; i < buckets.size(); ++i)
+    {
+        total += buckets[i];
+
+        if (total >= rank)
+        {
+            double upperBound = std::ldexp(1.0, static_cast<int>(i));
+            return std::min(upperBound, double(max));
+        }
+    }
+
+    return double(max);
+}
+
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+
+void LatencyHistogram::add(double micros)
+{
+    uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+
+    _buckets[bucketForLatency(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = _max.load(std::memory_order_relaxed);
+
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snapshot;
+
+    for (std::size_t i = 0; i < _buckets.size(); ++i)
+    {
+        snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+
+    snapshot.count = _count.load(std::memory_order_relaxed);
+    snapshot.sum = _sum.load(std::memory_order_relaxed);
+    snapshot.max = _max.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket: _buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+
+std::size_t LatencyHistogram::bucketForLatency(uint64_t micros)
+{
+    std::size_t bucket = 0;
+
+    while (micros > 0 && bucket + 1 < BUCKET_COUNT)
+    {
+        micros >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+
+CacheCounters::CacheCounters()
+{
+    reset();
+}
+
+
+void CacheCounters::emptied(std::size_t capacity)
+{
+    _evictionsWhenEmptied.fetch_add(currentEvictions(capacity), std::memory_order_relaxed);
+    _insertsWhenEmptied.store(_inserts.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+
+CacheStats CacheCounters::stats(std::size_t capacity) const
+{
+    CacheStats stats;
+    stats.hits = _hits.load(std::memory_order_relaxed);
+    stats.misses = _misses.load(std::memory_order_relaxed);
+    stats.inserts = _inserts.load(std::memory_order_relaxed);
+    stats.evictions = _evictionsWhenEmptied.load(std::memory_order_relaxed) + currentEvictions(capacity);
+    return stats;
+}
+
+
+void CacheCounters::reset()
+{
+    _hits.store(0, std::memory_order_relaxed);
+    _misses.store(0, std::memory_order_relaxed);
+    _inserts.store(0, std::memory_order_relaxed);
+    _insertsWhenEmptied.store(0, std::memory_order_relaxed);
+    _evictionsWhenEmptied.store(0, std::memory_order_relaxed);
+}
+
+
+uint64_t CacheCounters::currentEvictions(std::size_t capacity) const
+{
+    uint64_t inserts = _inserts.load(std::memory_order_relaxed) - _insertsWhenEmptied.load(std::memory_order_relaxed);
+    return inserts > capacity ? inserts - capacity : 0;
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,1039 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/SampleLog.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+namespace {
+
+
+uint64_t zigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+
+int64_t unzigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+
+void writeVarint(std::vector<uint8_t>& data, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+
+uint64_t readVarint(const uint8_t*& ptr, const uint8_t* end)
+{
+    uint64_t value = 0;
+    int shift = 0;
+
+    while (ptr < end && shift < 64)
+    {
+        uint8_t byte = *ptr++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+
+        shift += 7;
+    }
+
+    return value;
+}
+
+
+uint64_t bitsForDouble(double value)
+{
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+
+double doubleForBits(uint64_t bits)
+{
+    double value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+int leadingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return value == 0 ? 64 : __builtin_clzll(value);
+#else
+    int count = 0;
+
+    for (uint64_t mask = uint64_t(1) << 63; mask != 0 && (value & mask) == 0; mask >>= 1)
+    {
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+
+int trailingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return value == 0 ? 64 : __builtin_ctzll(value);
+#else
+    int count = 0;
+
+    for (uint64_t mask = 1; mask != 0 && (value & mask) == 0; mask <<= 1)
+    {
+        ++count;
+    }
+
+    return count;
+#endif
+}
+
+
+/// \brief Write bits, most significant bit first.
+class BitWriter
+{
+public:
+    BitWriter(std::vector<uint8_t>& data): _data(data)
+    {
+    }
+
+    /// \brief Write the low bits of a value.
+    /// \param value The value to write.
+    /// \param bits The number of bits to write, up to 64.
+    void write(uint64_t value, int bits)
+    {
+        while (bits > 0)
+        {
+            if (_used == 0)
+            {
+                _data.push_back(0);
+            }
+
+            int count = std::min(bits, 8 - _used);
+            uint64_t chunk = (value >> (bits - count)) & ((uint64_t(1) << count) - 1);
+            _data.back() |= static_cast<uint8_t>(chunk << (8 - _used - count));
+            _used = (_used + count) % 8;
+            bits -= count;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& _data;
+
+    /// \brief The number of bits used in the last byte.
+    int _used = 0;
+
+};
+
+
+/// \brief Read bits, most significant bit first.
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, const uint8_t* end): _data(data), _end(end)
+    {
+    }
+
+    /// \brief Read bits into the low bits of a value.
+    ///
+    /// Reading past the end returns zero bits.
+    ///
+    /// \param bits The number of bits to read, up to 64.
+    /// \returns the value.
+    uint64_t read(int bits)
+    {
+        uint64_t value = 0;
+
+        while (bits > 0)
+        {
+            int count = std::min(bits, 8 - _used);
+            uint64_t byte = _data < _end ? *_data : 0;
+            uint64_t chunk = (byte >> (8 - _used - count)) & ((uint64_t(1) << count) - 1);
+            value = (value << count) | chunk;
+            _used += count;
+            bits -= count;
+
+            if (_used == 8)
+            {
+                _used = 0;
+                ++_data;
+            }
+        }
+
+        return value;
+    }
+
+private:
+    const uint8_t* _data;
+    const uint8_t* _end;
+
+    /// \brief The number of bits used in the current byte.
+    int _used = 0;
+
+};
+
+
+void encodeTimestamps(const std::vector<int64_t>& timestamps, std::vector<uint8_t>& data)
+{
+    int64_t previous = 0;
+    int64_t previousDelta = 0;
+
+    for (std::size_t i = 0; i < timestamps.size(); ++i)
+    {
+        if (i == 0)
+        {
+            writeVarint(data, zigzag(timestamps[i]));
+        }
+        else
+        {
+            int64_t delta = timestamps[i] - previous;
+            writeVarint(data, zigzag(delta - previousDelta));
+            previousDelta = delta;
+        }
+
+        previous = timestamps[i];
+    }
+}
+
+
+void decodeTimestamps(const uint8_t* data,
+                      const uint8_t* end,
+                      std::size_t count,
+                      std::vector<int64_t>& timestamps)
+{
+    timestamps.resize(count);
+
+    int64_t previous = 0;
+    int64_t previousDelta = 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (i == 0)
+        {
+            previous = unzigzag(readVarint(data, end));
+        }
+        else
+        {
+            previousDelta += unzigzag(readVarint(data, end));
+            previous += previousDelta;
+        }
+
+        timestamps[i] = previous;
+    }
+}
+
+
+void encodeValues(const std::vector<double>& values, std::vector<uint8_t>& data)
+{
+    BitWriter writer(data);
+
+    uint64_t previous = 0;
+    int previousLeading = -1;
+    int previousTrailing = 0;
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        uint64_t bits = bitsForDouble(values[i]);
+
+        if (i == 0)
+        {
+            writer.write(bits, 64);
+        }
+        else
+        {
+            uint64_t xored = bits ^ previous;
+
+            if (xored == 0)
+            {
+                // Repeated value.
+                writer.write(0, 1);
+            }
+            else
+            {
+                writer.write(1, 1);
+
+                int leading = std::min(leadingZeros(xored), 31);
+                int trailing = trailingZeros(xored);
+
+                if (previousLeading >= 0
+                &&  leading >= previousLeading
+                &&  trailing >= previousTrailing)
+                {
+                    // The meaningful bits fit in the previous window.
+                    int meaningful = 64 - previousLeading - previousTrailing;
+                    writer.write(0, 1);
+                    writer.write(xored >> previousTrailing, meaningful);
+                }
+                else
+                {
+                    int meaningful = 64 - leading - trailing;
+                    writer.write(1, 1);
+                    writer.write(leading, 5);
+                    // A length of 64 does not fit in 6 bits and is stored as 0.
+                    writer.write(meaningful & 0x3F, 6);
+                    writer.write(xored >> trailing, meaningful);
+                    previousLeading = leading;
+                    previousTrailing = trailing;
+                }
+            }
+        }
+
+        previous = bits;
+    }
+}
+
+
+void decodeValues(const uint8_t* data,
+                  const uint8_t* end,
+                  std::size_t count,
+                  std::vector<double>& values)
+{
+    values.resize(count);
+
+    BitReader reader(data, end);
+
+    uint64_t previous = 0;
+    int previousLeading = 0;
+    int previousTrailing = 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (i == 0)
+        {
+            previous = reader.read(64);
+        }
+        else if (reader.read(1) != 0)
+        {
+            if (reader.read(1) != 0)
+            {
+                previousLeading = static_cast<int>(reader.read(5));
+                int meaningful = static_cast<int>(reader.read(6));
+
+                if (meaningful == 0)
+                {
+                    meaningful = 64;
+                }
+
+                previousTrailing = 64 - previousLeading - meaningful;
+            }
+
+            int meaningful = 64 - previousLeading - previousTrailing;
+            previous ^= reader.read(meaningful) << previousTrailing;
+        }
+
+        values[i] = doubleForBits(previous);
+    }
+}
+
+
+} // namespace
+
+
+const uint32_t SampleLog::VERSION = 1;
+
+
+const char SampleLog::MAGIC[8] = { 'O', 'F', 'X', 'P', 'S', 'L', 'O', 'G' };
+
+
+SampleLogWriter::SampleLogWriter()
+{
+    std::memset(&_header, 0, sizeof(SampleLog::Header));
+}
+
+
+SampleLogWriter::~SampleLogWriter()
+{
+    close();
+}
+
+
+bool SampleLogWriter::open(const std::string& filename,
+                           std::size_t channelCount,
+                           std::size_t blockSize)
+{
+    close();
+
+    _stream.open(filename, std::ios::binary | std::ios::trunc);
+
+    if (!_stream)
+    {
+        ofLogError("SampleLogWriter::open") << "Unable to open file: " << filename;
+        return false;
+    }
+
+    std::memset(&_header, 0, sizeof(SampleLog::Header));
+    std::memcpy(_header.magic, SampleLog::MAGIC, sizeof(SampleLog::MAGIC));
+    _header.version = SampleLog::VERSION;
+    _header.channelCount = static_cast<uint32_t>(channelCount);
+    _header.blockSize = std::max(blockSize, std::size_t(1));
+
+    // Write an empty header and index, so the log opens as empty until its
+    // index is written by flush() or close().
+    _stream.write(reinterpret_cast<const char*>(&_header), sizeof(SampleLog::Header));
+    _position = sizeof(SampleLog::Header);
+    _summaries.clear();
+
+    writeIndex();
+    _stream.flush();
+
+    _timestamps.clear();
+    _timestamps.reserve(_header.blockSize);
+    _columns.assign(channelCount, std::vector<double>());
+
+    for (auto& column: _columns)
+    {
+        column.reserve(_header.blockSize);
+    }
+
+    return true;
+}
+
+
+bool SampleLogWriter::close()
+{
+    if (!_stream.is_open())
+    {
+        return false;
+    }
+
+    writeBlock();
+    writeIndex();
+
+    bool success = _stream.good();
+
+    if (!success)
+    {
+        ofLogError("SampleLogWriter::close") << "Unable to write log.";
+    }
+
+    _stream.close();
+    _summaries.clear();
+    return success;
+}
+
+
+bool SampleLogWriter::flush()
+{
+    if (!_stream.is_open())
+    {
+        return false;
+    }
+
+    writeIndex();
+    _stream.flush();
+
+    if (!_stream.good())
+    {
+        ofLogError("SampleLogWriter::flush") << "Unable to write log.";
+        return false;
+    }
+
+    return true;
+}
+
+
+bool SampleLogWriter::isOpen() const
+{
+    return _stream.is_open();
+}
+
+
+bool SampleLogWriter::add(double timestamp, const double* values)
+{
+    if (!_stream.is_open())
+    {
+        ofLogError("SampleLogWriter::add") << "The log is not open.";
+        return false;
+    }
+
+    int64_t micros = std::llround(timestamp);
+
+    if (!_timestamps.empty() && micros < _timestamps.back())
+    {
+        ofLogError("SampleLogWriter::add") << "Timestamps must not decrease: " << timestamp;
+        return false;
+    }
+    else if (_timestamps.empty() && !_summaries.empty() && micros < _summaries.back().maxTime)
+    {
+        ofLogError("SampleLogWriter::add") << "Timestamps must not decrease: " << timestamp;
+        return false;
+    }
+
+    _timestamps.push_back(micros);
+
+    for (std::size_t i = 0; i < _columns.size(); ++i)
+    {
+        _columns[i].push_back(values[i]);
+    }
+
+    ++_header.count;
+
+    if (_timestamps.size() == _header.blockSize)
+    {
+        writeBlock();
+    }
+
+    return true;
+}
+
+
+bool SampleLogWriter::add(double timestamp, const std::vector<double>& values)
+{
+    if (values.size() != _columns.size())
+    {
+        ofLogError("SampleLogWriter::add") << "Expected " << _columns.size() << " values, got " << values.size();
+        return false;
+    }
+
+    return add(timestamp, values.data());
+}
+
+
+std::size_t SampleLogWriter::channelCount() const
+{
+    return _header.channelCount;
+}
+
+
+std::size_t SampleLogWriter::size() const
+{
+    return static_cast<std::size_t>(_header.count);
+}
+
+
+void SampleLogWriter::writeIndex()
+{
+    // Only written blocks are indexed, so the count excludes pending samples.
+    SampleLog::Header header = _header;
+    header.count = 0;
+
+    for (auto& summary: _summaries)
+    {
+        header.count += summary.count;
+    }
+
+    header.blockCount = _summaries.size();
+    header.indexOffset = _position;
+
+    SampleLog::Trailer trailer;
+    std::memcpy(trailer.magic, SampleLog::MAGIC, sizeof(SampleLog::MAGIC));
+    trailer.indexOffset = header.indexOffset;
+    trailer.blockCount = header.blockCount;
+    trailer.count = header.count;
+
+    _stream.seekp(static_cast<std::streamoff>(_position));
+    _stream.write(reinterpret_cast<const char*>(_summaries.data()),
+                  _summaries.size() * sizeof(SampleLog::BlockSummary));
+    _stream.write(reinterpret_cast<const char*>(&trailer), sizeof(SampleLog::Trailer));
+
+    _stream.seekp(0);
+    _stream.write(reinterpret_cast<const char*>(&header), sizeof(SampleLog::Header));
+
+    // The next block overwrites the index and trailer.
+    _stream.seekp(static_cast<std::streamoff>(_position));
+}
+
+
+void SampleLogWriter::writeBlock()
+{
+    if (_timestamps.empty())
+    {
+        return;
+    }
+
+    std::size_t tableSize = (_columns.size() + 1) * sizeof(uint32_t);
+
+    // Reserve the column offset table, then append each column.
+    _block.assign(tableSize, 0);
+
+    std::vector<uint32_t> offsets;
+
+    encodeTimestamps(_timestamps, _block);
+
+    for (auto& column: _columns)
+    {
+        offsets.push_back(static_cast<uint32_t>(_block.size()));
+        encodeValues(column, _block);
+    }
+
+    offsets.push_back(static_cast<uint32_t>(_block.size()));
+    std::memcpy(_block.data(), offsets.data(), tableSize);
+
+    SampleLog::BlockSummary summary;
+    summary.minTime = _timestamps.front();
+    summary.maxTime = _timestamps.back();
+    summary.offset = _position;
+    summary.length = _block.size();
+    summary.count = _timestamps.size();
+    _summaries.push_back(summary);
+
+    // Keep every block 8 byte aligned so the offset table can be read in place.
+    std::size_t remainder = _block.size() % 8;
+
+    if (remainder != 0)
+    {
+        _block.resize(_block.size() + 8 - remainder, 0);
+    }
+
+    _stream.write(reinterpret_cast<const char*>(_block.data()), _block.size());
+    _position += _block.size();
+
+    _timestamps.clear();
+
+    for (auto& column: _columns)
+    {
+        column.clear();
+    }
+}
+
+
+SampleLogReader::SampleLogReader():
+    _blockCache(std::make_unique<BlockCache>(SampleLog::DEFAULT_BLOCK_CACHE_SIZE))
+{
+}
+
+
+SampleLogReader::~SampleLogReader()
+{
+}
+
+
+bool SampleLogReader::open(const std::string& filename)
+{
+    close();
+
+    if (!_file.open(filename))
+    {
+        return false;
+    }
+
+    if (_file.size() < sizeof(SampleLog::Header))
+    {
+        ofLogError("SampleLogReader::open") << "File is too small: " << filename;
+        close();
+        return false;
+    }
+
+    auto header = reinterpret_cast<const SampleLog::Header*>(_file.data());
+
+    if (std::memcmp(header->magic, SampleLog::MAGIC, sizeof(SampleLog::MAGIC)) != 0
+    ||  header->version != SampleLog::VERSION
+    ||  header->blockSize == 0)
+    {
+        ofLogError("SampleLogReader::open") << "Invalid log: " << filename;
+        close();
+        return false;
+    }
+
+    if (header->indexOffset % alignof(SampleLog::BlockSummary) != 0
+    ||  header->blockCount != header->count / header->blockSize + (header->count % header->blockSize != 0 ? 1 : 0))
+    {
+        ofLogError("SampleLogReader::open") << "Invalid log: " << filename;
+        close();
+        return false;
+    }
+
+    const SampleLog::BlockSummary* summaries = nullptr;
+
+    if (isIndexIntact(*header))
+    {
+        summaries = reinterpret_cast<const SampleLog::BlockSummary*>(_file.data() + header->indexOffset);
+    }
+    else if (recoverIndex(*header))
+    {
+        // Blocks written after the last flush overwrote its index.
+        ofLogWarning("SampleLogReader::open") << "Recovered the index of an unclosed log: " << filename;
+        summaries = _recoveredSummaries.data();
+    }
+    else
+    {
+        ofLogError("SampleLogReader::open") << "Truncated log: " << filename;
+        close();
+        return false;
+    }
+
+    for (uint64_t i = 0; i < header->blockCount; ++i)
+    {
+        if (!isValidBlock(*header, summaries[i], i))
+        {
+            ofLogError("SampleLogReader::open") << "Invalid or truncated block " << i << ": " << filename;
+            close();
+            return false;
+        }
+    }
+
+    _header = header;
+    _summaries = summaries;
+
+    return true;
+}
+
+
+void SampleLogReader::close()
+{
+    _header = nullptr;
+    _summaries = nullptr;
+    _recoveredSummaries.clear();
+    _lastBlockIndex = std::numeric_limits<std::size_t>::max();
+    _lastBlock.reset();
+    _blockCache = std::make_unique<BlockCache>(_blockCacheSize);
+    _file.close();
+}
+
+
+bool SampleLogReader::isOpen() const
+{
+    return _header != nullptr;
+}
+
+
+double SampleLogReader::timeForIndex(std::size_t index) const
+{
+    return static_cast<double>(timeForIndexMicros(index));
+}
+
+
+std::size_t SampleLogReader::size() const
+{
+    return _header != nullptr ? static_cast<std::size_t>(_header->count) : 0;
+}
+
+
+std::size_t SampleLogReader::indexForTime(double time,
+                                          bool increasing,
+                                          std::size_t indexHint) const
+{
+    // Integer timestamps <= time are <= floor(time) and integer timestamps
+    // >= time are >= ceil(time).
+    return indexForTimeMicros(increasing ? TimeUtils::floorMicros(time)
+                                         : TimeUtils::ceilMicros(time),
+                              increasing,
+                              indexHint);
+}
+
+
+int64_t SampleLogReader::timeForIndexMicros(std::size_t index) const
+{
+    return decodedBlock(index / _header->blockSize).timestamps[index % _header->blockSize];
+}
+
+
+std::size_t SampleLogReader::indexForTimeMicros(int64_t time,
+                                                bool increasing,
+                                                std::size_t) const
+{
+    std::size_t count = size();
+
+    if (count == 0 || time <= startTimeMicros())
+    {
+        return 0;
+    }
+    else if (time >= endTimeMicros())
+    {
+        return count - 1;
+    }
+
+    auto summariesEnd = _summaries + _header->blockCount;
+
+    const SampleLog::BlockSummary* summary = nullptr;
+
+    if (increasing)
+    {
+        // The last block starting at or before the time contains the last
+        // sample with a timestamp <= time.
+        summary = std::upper_bound(_summaries,
+                                   summariesEnd,
+                                   time,
+                                   [](int64_t value, const SampleLog::BlockSummary& block)
+                                   {
+                                       return value < block.minTime;
+                                   }) - 1;
+    }
+    else
+    {
+        // The first block ending at or after the time contains the first
+        // sample with a timestamp >= time.
+        summary = std::lower_bound(_summaries,
+                                   summariesEnd,
+                                   time,
+                                   [](const SampleLog::BlockSummary& block, int64_t value)
+                                   {
+                                       return block.maxTime < value;
+                                   });
+    }
+
+    std::size_t block = summary - _summaries;
+    const std::vector<int64_t>& timestamps = decodedBlock(block).timestamps;
+
+    std::size_t offset = increasing
+                       ? (std::upper_bound(timestamps.begin(), timestamps.end(), time) - timestamps.begin()) - 1
+                       : (std::lower_bound(timestamps.begin(), timestamps.end(), time) - timestamps.begin());
+
+    return block * _header->blockSize + offset;
+}
+
+
+double SampleLogReader::value(std::size_t index, std::size_t channel) const
+{
+    return decodedColumn(index / _header->blockSize, channel)[index % _header->blockSize];
+}
+
+
+void SampleLogReader::values(std::size_t index, double* values) const
+{
+    for (std::size_t channel = 0; channel < channelCount(); ++channel)
+    {
+        values[channel] = value(index, channel);
+    }
+}
+
+
+std::size_t SampleLogReader::channelCount() const
+{
+    return _header != nullptr ? _header->channelCount : 0;
+}
+
+
+std::size_t SampleLogReader::blockSize() const
+{
+    return _header != nullptr ? static_cast<std::size_t>(_header->blockSize) : 0;
+}
+
+
+std::size_t SampleLogReader::blockCount() const
+{
+    return _header != nullptr ? static_cast<std::size_t>(_header->blockCount) : 0;
+}
+
+
+const SampleLog::BlockSummary& SampleLogReader::block(std::size_t block) const
+{
+    return _summaries[block];
+}
+
+
+void SampleLogReader::setBlockCacheSize(std::size_t size)
+{
+    _blockCacheSize = std::max(size, std::size_t(1));
+    _blockCache = std::make_unique<BlockCache>(_blockCacheSize);
+}
+
+
+std::size_t SampleLogReader::getBlockCacheSize() const
+{
+    return _blockCacheSize;
+}
+
+
+SampleLogReader::DecodedBlock& SampleLogReader::decodedBlock(std::size_t block) const
+{
+    if (block == _lastBlockIndex)
+    {
+        return *_lastBlock;
+    }
+
+    std::shared_ptr<DecodedBlock> decoded;
+
+    try
+    {
+        decoded = _blockCache->get(block);
+    }
+    catch (const std::range_error&)
+    {
+        const SampleLog::BlockSummary& summary = _summaries[block];
+        const uint8_t* data = _file.data() + summary.offset;
+        const uint32_t* offsets = columnOffsets(block);
+
+        std::size_t tableSize = (_header->channelCount + 1) * sizeof(uint32_t);
+
+        decoded = std::make_shared<DecodedBlock>();
+        decoded->columns.resize(_header->channelCount);
+        decodeTimestamps(data + tableSize,
+                         data + offsets[0],
+                         static_cast<std::size_t>(summary.count),
+                         decoded->timestamps);
+
+        _blockCache->add(block, decoded);
+    }
+
+    _lastBlockIndex = block;
+    _lastBlock = decoded;
+
+    return *decoded;
+}
+
+
+const std::vector<double>& SampleLogReader::decodedColumn(std::size_t block,
+                                                          std::size_t channel) const
+{
+    DecodedBlock& decoded = decodedBlock(block);
+
+    std::vector<double>& column = decoded.columns[channel];
+
+    if (column.empty())
+    {
+        const SampleLog::BlockSummary& summary = _summaries[block];
+        const uint8_t* data = _file.data() + summary.offset;
+        const uint32_t* offsets = columnOffsets(block);
+
+        decodeValues(data + offsets[channel],
+                     data + offsets[channel + 1],
+                     static_cast<std::size_t>(summary.count),
+                     column);
+    }
+
+    return column;
+}
+
+
+bool SampleLogReader::isValidBlock(const SampleLog::Header& header,
+                                   const SampleLog::BlockSummary& summary,
+                                   uint64_t block) const
+{
+    uint64_t fileSize = _file.size();
+
+    // Samples are located by index / blockSize, so every block but the last
+    // must be full.
+    uint64_t count = (block + 1 < header.blockCount) ? header.blockSize
+                                                     : header.count - block * header.blockSize;
+
+    // Each block begins with the end offsets of the timestamp and channel
+    // columns, relative to the block.
+    uint64_t tableSize = (uint64_t(header.channelCount) + 1) * sizeof(uint32_t);
+
+    if (summary.count != count
+    ||  summary.minTime > summary.maxTime
+    ||  summary.offset % alignof(uint32_t) != 0
+    ||  summary.offset < sizeof(SampleLog::Header)
+    ||  summary.offset > fileSize
+    ||  summary.length > fileSize - summary.offset
+    ||  summary.length < tableSize)
+    {
+        return false;
+    }
+
+    auto offsets = reinterpret_cast<const uint32_t*>(_file.data() + summary.offset);
+
+    if (offsets[0] < tableSize)
+    {
+        return false;
+    }
+
+    for (uint32_t channel = 0; channel < header.channelCount; ++channel)
+    {
+        if (offsets[channel + 1] < offsets[channel])
+        {
+            return false;
+        }
+    }
+
+    return offsets[header.channelCount] <= summary.length;
+}
+
+
+bool SampleLogReader::isIndexIntact(const SampleLog::Header& header) const
+{
+    uint64_t fileSize = _file.size();
+
+    // The sizes are compared by subtraction so corrupt values can not overflow.
+    if (header.indexOffset > fileSize
+    ||  header.blockCount > (fileSize - header.indexOffset) / sizeof(SampleLog::BlockSummary))
+    {
+        return false;
+    }
+
+    uint64_t trailerOffset = header.indexOffset + header.blockCount * sizeof(SampleLog::BlockSummary);
+
+    if (sizeof(SampleLog::Trailer) > fileSize - trailerOffset)
+    {
+        return false;
+    }
+
+    auto trailer = reinterpret_cast<const SampleLog::Trailer*>(_file.data() + trailerOffset);
+
+    return std::memcmp(trailer->magic, SampleLog::MAGIC, sizeof(SampleLog::MAGIC)) == 0
+        && trailer->indexOffset == header.indexOffset
+        && trailer->blockCount == header.blockCount
+        && trailer->count == header.count;
+}
+
+
+bool SampleLogReader::recoverIndex(const SampleLog::Header& header)
+{
+    uint64_t fileSize = _file.size();
+    uint64_t tableSize = (uint64_t(header.channelCount) + 1) * sizeof(uint32_t);
+    uint64_t offset = sizeof(SampleLog::Header);
+
+    _recoveredSummaries.clear();
+
+    for (uint64_t i = 0; i < header.blockCount; ++i)
+    {
+        if (offset > fileSize || tableSize > fileSize - offset)
+        {
+            return false;
+        }
+
+        auto offsets = reinterpret_cast<const uint32_t*>(_file.data() + offset);
+
+        SampleLog::BlockSummary summary;
+        summary.minTime = 0;
+        summary.maxTime = 0;
+        summary.offset = offset;
+        summary.length = offsets[header.channelCount];
+        summary.count = (i + 1 < header.blockCount) ? header.blockSize
+                                                    : header.count - i * header.blockSize;
+
+        if (!isValidBlock(header, summary, i))
+        {
+            return false;
+        }
+
+        std::vector<int64_t> timestamps;
+
+        decodeTimestamps(_file.data() + offset + tableSize,
+                         _file.data() + offset + offsets[0],
+                         static_cast<std::size_t>(summary.count),
+                         timestamps);
+
+        summary.minTime = timestamps.front();
+        summary.maxTime = timestamps.back();
+        _recoveredSummaries.push_back(summary);
+
+        // Blocks are padded to keep them 8 byte aligned.
+        offset += (summary.length + 7) / 8 * 8;
+    }
+
+    return true;
+}
+
+
+const uint32_t* SampleLogReader::columnOffsets(std::size_t block) const
+{
+    return reinterpret_cast<const uint32_t*>(_file.data() + _summaries[block].offset);
+}
+
+
+} } // namespace ofx::Player
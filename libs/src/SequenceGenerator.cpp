@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/SequenceGenerator.h"
+#include "ofx/Player/ImageSequenceRecorder.h"
+#include <atomic>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include "Poco/DateTimeFormatter.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+bool SequenceGenerator::generate(const std::string& directory,
+                                 const Settings& settings)
+{
+    std::error_code error;
+
+    std::filesystem::create_directories(directory, error);
+
+    if (error || !std::filesystem::is_directory(directory))
+    {
+        ofLogError("SequenceGenerator::generate") << "Unable to create directory: " << directory;
+        return false;
+    }
+
+    std::string absoluteDirectory = std::filesystem::absolute(directory, error).string();
+
+    std::vector<double> timestamps = makeTimestamps(settings);
+
+    std::vector<std::string> filenames(timestamps.size());
+
+    for (std::size_t i = 0; i < timestamps.size(); ++i)
+    {
+        filenames[i] = makeFilename(settings, i, timestamps[i]);
+    }
+
+    std::atomic<std::size_t> failedCount(0);
+
+    if (settings.writeImages)
+    {
+        std::size_t threadCount = settings.threadCount;
+
+        if (threadCount == 0)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        std::atomic<std::size_t> next(0);
+
+        auto encode = [&]()
+        {
+            ofPixels pixels;
+
+            std::size_t i = 0;
+
+            while ((i = next++) < timestamps.size())
+            {
+                makePixels(settings, i, pixels);
+
+                std::string path = (std::filesystem::path(absoluteDirectory) / filenames[i]).string();
+
+                if (!ofSaveImage(pixels, path))
+                {
+                    ++failedCount;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 1; i < threadCount; ++i)
+        {
+            threads.push_back(std::thread(encode));
+        }
+
+        encode();
+
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+
+        if (failedCount > 0)
+        {
+            ofLogError("SequenceGenerator::generate") << "Unable to write " << failedCount << " images.";
+        }
+    }
+
+    if (settings.writeManifest)
+    {
+        TimestampedURIIndex images;
+        images.reserve(timestamps.size());
+
+        for (std::size_t i = 0; i < timestamps.size(); ++i)
+        {
+            images.push_back(filenames[i], static_cast<int64_t>(timestamps[i]));
+        }
+
+        if (!ImageSequenceRecorder::writeManifest(absoluteDirectory,
+                                                  settings.width,
+                                                  settings.height,
+                                                  images))
+        {
+            return false;
+        }
+    }
+
+    return failedCount == 0;
+}
+
+
+std::vector<double> SequenceGenerator::makeTimestamps(const Settings& settings)
+{
+    std::mt19937 generator(settings.seed);
+
+    double jitter = std::max(0.0, std::min(settings.jitter, 0.49));
+
+    std::uniform_real_distribution<double> jitterDistribution(-jitter, jitter);
+    std::uniform_real_distribution<double> gapDistribution(0, 1);
+    std::uniform_int_distribution<std::size_t> gapFramesDistribution(1, std::max(settings.maxGapFrames, std::size_t(1)));
+
+    std::vector<double> timestamps;
+    timestamps.reserve(settings.count);
+
+    int64_t lastMilliseconds = std::numeric_limits<int64_t>::min();
+
+    // The frame position, including any gaps.
+    std::size_t frame = 0;
+
+    for (std::size_t i = 0; i < settings.count; ++i)
+    {
+        double offset = frame;
+
+        if (settings.spacing == Spacing::JITTERED)
+        {
+            offset += jitterDistribution(generator);
+        }
+        else if (settings.spacing == Spacing::GAPPY
+             &&  gapDistribution(generator) < settings.gapProbability)
+        {
+            frame += gapFramesDistribution(generator);
+            offset = frame;
+        }
+
+        double timestamp = settings.startTime + offset * settings.frameDuration;
+
+        // Filenames have millisecond resolution, so keep them unique.
+        int64_t milliseconds = static_cast<int64_t>(std::llround(timestamp / 1000.0));
+
+        if (milliseconds <= lastMilliseconds)
+        {
+            milliseconds = lastMilliseconds + 1;
+        }
+
+        lastMilliseconds = milliseconds;
+
+        timestamps.push_back(milliseconds * 1000.0);
+
+        ++frame;
+    }
+
+    return timestamps;
+}
+
+
+std::string SequenceGenerator::makeFilename(const Settings& settings,
+                                            std::size_t index,
+                                            double timestamp)
+{
+    std::string filename;
+
+    if (settings.timestampFormat.empty())
+    {
+        std::stringstream ss;
+        ss << std::setw(8) << std::setfill('0') << index;
+        filename = ss.str();
+    }
+    else
+    {
+        filename = Poco::DateTimeFormatter::format(Poco::Timestamp(static_cast<Poco::Timestamp::TimeVal>(timestamp)),
+                                                   settings.timestampFormat);
+    }
+
+    filename += ".";
+    filename += settings.extension;
+
+    return filename;
+}
+
+
+void SequenceGenerator::makePixels(const Settings& settings,
+                                   std::size_t index,
+                                   ofPixels& pixels)
+{
+    if (pixels.getWidth() != settings.width
+    ||  pixels.getHeight() != settings.height
+    ||  !pixels.isAllocated())
+    {
+        pixels.allocate(settings.width, settings.height, settings.imageType);
+    }
+
+    std::size_t channels = pixels.getNumChannels();
+    std::size_t width = settings.width;
+    std::size_t height = settings.height;
+    unsigned char* data = pixels.getData();
+
+    // A diagonal gradient that scrolls with the frame index, with a bar
+    // marking the frame position.
+    std::size_t bar = width > 0 ? (index * 4) % width : 0;
+
+    for (std::size_t y = 0; y < height; ++y)
+    {
+        for (std::size_t x = 0; x < width; ++x)
+        {
+            unsigned char* pixel = data + (y * width + x) * channels;
+
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                pixel[c] = static_cast<unsigned char>(x + y + index * 3 + c * 85);
+            }
+
+            if (x >= bar && x < bar + 4)
+            {
+                for (std::size_t c = 0; c < channels; ++c)
+                {
+                    pixel[c] = 255;
+                }
+            }
+        }
+    }
+}
+
+
+} } // namespace ofx::Player
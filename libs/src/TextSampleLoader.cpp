@@ -0,0 +1,522 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/TextSampleLoader.h"
+#include "ofx/Player/MappedFile.h"
+#include "ofLog.h"
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+
+namespace ofx {
+namespace Player {
+
+
+namespace {
+
+
+/// \brief The exactly representable powers of ten.
+const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+enum
+{
+    /// \brief The maximum length of a number parsed by the fallback.
+    MAX_NUMBER_LENGTH = 128
+};
+
+
+/// \brief Parse a number that can not be parsed exactly, independent of the
+/// locale.
+/// \param first The first character of the number.
+/// \param last One past the last character of the number.
+/// \param magnitude The decimal exponent of the leading digit plus one.
+/// \param negative True if the number is negative.
+/// \param value The parsed value.
+/// \returns true if the number was parsed.
+bool parseDoubleFallback(const char* first,
+                         const char* last,
+                         int magnitude,
+                         bool negative,
+                         double& value)
+{
+    if (last - first > MAX_NUMBER_LENGTH)
+    {
+        return false;
+    }
+
+    bool isParsed = false;
+
+#if defined(__cpp_lib_to_chars)
+    // from_chars does not accept a leading plus sign.
+    if (*first == '+')
+    {
+        ++first;
+    }
+
+    auto result = std::from_chars(first, last, value);
+    isParsed = (result.ec == std::errc() && result.ptr == last);
+#else
+    std::istringstream stream(std::string(first, last));
+    stream.imbue(std::locale::classic());
+    stream >> value;
+    isParsed = !stream.fail() && stream.peek() == std::char_traits<char>::eof();
+#endif
+
+    if (!isParsed)
+    {
+        // The syntax was already checked, so the value is out of range.
+        double result = magnitude > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        value = negative ? -result : result;
+    }
+
+    return true;
+}
+
+
+/// \brief A lookup table of delimiter characters.
+class Delimiters
+{
+public:
+    Delimiters(const std::string& delimiters)
+    {
+        _table.fill(false);
+
+        for (char c: delimiters)
+        {
+            _table[static_cast<uint8_t>(c)] = true;
+        }
+    }
+
+    bool operator () (char c) const
+    {
+        return _table[static_cast<uint8_t>(c)];
+    }
+
+private:
+    std::array<bool, 256> _table;
+
+};
+
+
+/// \brief Parse the fields of a single line.
+/// \param first The first character of the line.
+/// \param last One past the last character of the line.
+/// \param delimiters The field delimiters.
+/// \param fields The parsed fields.
+/// \param maximum The maximum number of fields to parse.
+/// \returns the number of fields, or -1 if a field is not numeric.
+int parseLine(const char* first,
+              const char* last,
+              const Delimiters& delimiters,
+              double* fields,
+              std::size_t maximum)
+{
+    std::size_t count = 0;
+
+    while (true)
+    {
+        while (first < last && (delimiters(*first) || *first == '\r'))
+        {
+            ++first;
+        }
+
+        if (first == last)
+        {
+            return static_cast<int>(count);
+        }
+
+        if (count == maximum || !TextSampleLoader::parseDouble(first, last, fields[count]))
+        {
+            return -1;
+        }
+
+        if (first < last && !delimiters(*first) && *first != '\r')
+        {
+            return -1;
+        }
+
+        ++count;
+    }
+}
+
+
+/// \brief The parsed results of a single chunk.
+struct Chunk
+{
+    const char* first = nullptr;
+    const char* last = nullptr;
+    TimestampedSamples samples;
+    std::size_t lines = 0;
+    std::size_t skippedLines = 0;
+};
+
+
+enum
+{
+    /// \brief The maximum number of fields per line.
+    MAX_FIELDS = 64
+};
+
+
+void parseChunk(Chunk& chunk,
+                std::size_t fieldCount,
+                const TextSampleLoader::Settings& settings,
+                const Delimiters& delimiters)
+{
+    double fields[MAX_FIELDS];
+    double values[MAX_FIELDS];
+
+    // Guess the number of lines from the average length of a short line.
+    chunk.samples.reserve((chunk.last - chunk.first) / (fieldCount * 8) + 1);
+
+    const char* line = chunk.first;
+
+    while (line < chunk.last)
+    {
+        const char* end = static_cast<const char*>(std::memchr(line, '\n', chunk.last - line));
+
+        if (end == nullptr)
+        {
+            end = chunk.last;
+        }
+
+        int count = parseLine(line, end, delimiters, fields, MAX_FIELDS);
+
+        if (count > 0)
+        {
+            ++chunk.lines;
+
+            if (static_cast<std::size_t>(count) == fieldCount)
+            {
+                std::size_t channel = 0;
+
+                for (std::size_t i = 0; i < fieldCount; ++i)
+                {
+                    if (i != settings.timestampColumn)
+                    {
+                        values[channel++] = fields[i];
+                    }
+                }
+
+                chunk.samples.push_back(fields[settings.timestampColumn] * settings.timestampScale, values);
+            }
+            else
+            {
+                ++chunk.skippedLines;
+            }
+        }
+        else if (count < 0)
+        {
+            ++chunk.lines;
+            ++chunk.skippedLines;
+        }
+
+        line = end + 1;
+    }
+}
+
+
+} // namespace
+
+
+bool TextSampleLoader::load(const std::string& filename,
+                            TimestampedSamples& samples,
+                            const Settings& settings,
+                            LoadStats* stats)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file;
+
+    if (!file.open(filename))
+    {
+        ofLogError("TextSampleLoader::load") << "Unable to open file: " << filename;
+        return false;
+    }
+
+    bool success = load(reinterpret_cast<const char*>(file.data()),
+                        file.size(),
+                        samples,
+                        settings,
+                        stats);
+
+    if (stats != nullptr)
+    {
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return success;
+}
+
+
+bool TextSampleLoader::load(const char* data,
+                            std::size_t size,
+                            TimestampedSamples& samples,
+                            const Settings& settings,
+                            LoadStats* stats)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    Delimiters delimiters(settings.delimiters);
+
+    const char* last = data + size;
+
+    // The first valid line determines the number of fields.
+    std::size_t fieldCount = 0;
+
+    {
+        double fields[MAX_FIELDS];
+        const char* line = data;
+
+        while (line < last && fieldCount == 0)
+        {
+            const char* end = static_cast<const char*>(std::memchr(line, '\n', last - line));
+
+            if (end == nullptr)
+            {
+                end = last;
+            }
+
+            int count = parseLine(line, end, delimiters, fields, MAX_FIELDS);
+
+            if (count > 1 && static_cast<std::size_t>(count) > settings.timestampColumn)
+            {
+                fieldCount = count;
+            }
+
+            line = end + 1;
+        }
+    }
+
+    samples.setChannelCount(fieldCount > 0 ? fieldCount - 1 : 0);
+
+    if (fieldCount == 0)
+    {
+        ofLogError("TextSampleLoader::load") << "No valid lines found.";
+        return false;
+    }
+
+    std::size_t threadCount = settings.threadCount;
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Avoid splitting small inputs into tiny chunks.
+    threadCount = std::max(std::min(threadCount, size / (64 * 1024)), std::size_t(1));
+
+    // Split the data at line boundaries.
+    std::vector<Chunk> chunks(threadCount);
+
+    const char* chunkStart = data;
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        const char* chunkEnd = (i + 1 == threadCount) ? last : data + size * (i + 1) / threadCount;
+
+        if (chunkEnd < chunkStart)
+        {
+            chunkEnd = chunkStart;
+        }
+
+        if (chunkEnd < last)
+        {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', last - chunkEnd));
+            chunkEnd = newline != nullptr ? newline + 1 : last;
+        }
+
+        chunks[i].first = chunkStart;
+        chunks[i].last = chunkEnd;
+        chunks[i].samples.setChannelCount(fieldCount - 1);
+        chunkStart = chunkEnd;
+    }
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < chunks.size(); ++i)
+    {
+        threads.push_back(std::thread([&, i]() {
+            parseChunk(chunks[i], fieldCount, settings, delimiters);
+        }));
+    }
+
+    parseChunk(chunks[0], fieldCount, settings, delimiters);
+
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+
+    // Stitch the chunks together in file order.
+    std::size_t total = 0;
+
+    for (auto& chunk: chunks)
+    {
+        total += chunk.samples.size();
+    }
+
+    samples.reserve(total);
+
+    LoadStats result;
+
+    for (auto& chunk: chunks)
+    {
+        samples.append(chunk.samples);
+        result.lines += chunk.lines;
+        result.skippedLines += chunk.skippedLines;
+    }
+
+    result.sorted = !samples.isSorted();
+
+    if (result.sorted)
+    {
+        samples.sort();
+    }
+
+    if (stats != nullptr)
+    {
+        result.bytes = size;
+        result.samples = samples.size();
+        result.threads = threadCount;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        *stats = result;
+    }
+
+    return !samples.empty();
+}
+
+
+bool TextSampleLoader::parseDouble(const char*& first, const char* last, double& value)
+{
+    const char* p = first;
+
+    bool negative = false;
+
+    if (p < last && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    while (p < last && *p >= '0' && *p <= '9')
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+
+            if (mantissa != 0)
+            {
+                ++digits;
+            }
+        }
+        else
+        {
+            ++exponent;
+        }
+
+        hasDigits = true;
+        ++p;
+    }
+
+    if (p < last && *p == '.')
+    {
+        ++p;
+
+        while (p < last && *p >= '0' && *p <= '9')
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                --exponent;
+
+                if (mantissa != 0)
+                {
+                    ++digits;
+                }
+            }
+
+            hasDigits = true;
+            ++p;
+        }
+    }
+
+    if (!hasDigits)
+    {
+        return false;
+    }
+
+    bool isExact = (digits < 19);
+
+    if (p < last && (*p == 'e' || *p == 'E'))
+    {
+        const char* e = p + 1;
+        bool negativeExponent = false;
+
+        if (e < last && (*e == '-' || *e == '+'))
+        {
+            negativeExponent = (*e == '-');
+            ++e;
+        }
+
+        if (e < last && *e >= '0' && *e <= '9')
+        {
+            int explicitExponent = 0;
+
+            while (e < last && *e >= '0' && *e <= '9')
+            {
+                if (explicitExponent < 10000)
+                {
+                    explicitExponent = explicitExponent * 10 + (*e - '0');
+                }
+
+                ++e;
+            }
+
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            p = e;
+        }
+    }
+
+    if (isExact
+    &&  mantissa <= (uint64_t(1) << 53)
+    &&  exponent >= -22
+    &&  exponent <= 22)
+    {
+        // Both the mantissa and the power of ten are exact, so a single
+        // multiplication or division is correctly rounded.
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / POWERS_OF_TEN[-exponent] : result * POWERS_OF_TEN[exponent];
+        value = negative ? -result : result;
+    }
+    else if (!parseDoubleFallback(first, p, exponent + digits, negative, value))
+    {
+        return false;
+    }
+
+    first = p;
+    return true;
+}
+
+
+} } // namespace ofx::Player
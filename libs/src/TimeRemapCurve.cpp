@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/TimeRemapCurve.h"
+#include <algorithm>
+
+
+namespace ofx {
+namespace Player {
+
+
+TimeRemapCurve::TimeRemapCurve()
+{
+}
+
+
+TimeRemapCurve::~TimeRemapCurve()
+{
+}
+
+
+std::size_t TimeRemapCurve::addKey(double time, double speed)
+{
+    auto iter = std::upper_bound(_times.begin(), _times.end(), time);
+    std::size_t index = static_cast<std::size_t>(iter - _times.begin());
+
+    _times.insert(iter, time);
+    _speeds.insert(_speeds.begin() + index, speed);
+    _integrals.insert(_integrals.begin() + index, 0);
+
+    integrate(index);
+
+    return index;
+}
+
+
+void TimeRemapCurve::clear()
+{
+    _times.clear();
+    _speeds.clear();
+    _integrals.clear();
+}
+
+
+std::size_t TimeRemapCurve::size() const
+{
+    return _times.size();
+}
+
+
+double TimeRemapCurve::keyTime(std::size_t index) const
+{
+    return _times[index];
+}
+
+
+double TimeRemapCurve::keySpeed(std::size_t index) const
+{
+    return _speeds[index];
+}
+
+
+double TimeRemapCurve::speedAt(double time) const
+{
+    if (_times.empty())
+    {
+        return 1;
+    }
+
+    std::size_t i = keyForTime(time);
+
+    if (time <= _times[i] || i + 1 == _times.size())
+    {
+        return _speeds[i];
+    }
+
+    double t = (time - _times[i]) / (_times[i + 1] - _times[i]);
+    return _speeds[i] + (_speeds[i + 1] - _speeds[i]) * t;
+}
+
+
+double TimeRemapCurve::mediaTimeAt(double time) const
+{
+    if (_times.empty())
+    {
+        return time;
+    }
+
+    std::size_t i = keyForTime(time);
+
+    // The speed is linear within a segment, so its integral is the
+    // trapezoid under the speed at both ends.
+    return _integrals[i] + (time - _times[i]) * (_speeds[i] + speedAt(time)) / 2;
+}
+
+
+double TimeRemapCurve::mediaTimeBetween(double from, double to) const
+{
+    return mediaTimeAt(to) - mediaTimeAt(from);
+}
+
+
+std::size_t TimeRemapCurve::keyForTime(double time) const
+{
+    auto iter = std::upper_bound(_times.begin(), _times.end(), time);
+    return iter == _times.begin() ? 0 : static_cast<std::size_t>(iter - _times.begin()) - 1;
+}
+
+
+void TimeRemapCurve::integrate(std::size_t index)
+{
+    if (_times.empty())
+    {
+        return;
+    }
+
+    // The speed before the first key is constant, so a new first key
+    // changes the media time at every key.
+    _integrals[0] = _times[0] * _speeds[0];
+
+    for (std::size_t i = std::max(index, std::size_t(1)); i < _times.size(); ++i)
+    {
+        double duration = _times[i] - _times[i - 1];
+        _integrals[i] = _integrals[i - 1] + duration * (_speeds[i - 1] + _speeds[i]) / 2;
+    }
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/TimestampedSamples.h"
+#include <numeric>
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+TimestampedSamples::TimestampedSamples(std::size_t channelCount):
+    _channelCount(channelCount)
+{
+}
+
+
+TimestampedSamples::~TimestampedSamples()
+{
+}
+
+
+std::size_t TimestampedSamples::size() const
+{
+    return _timestamps.size();
+}
+
+
+bool TimestampedSamples::empty() const
+{
+    return _timestamps.empty();
+}
+
+
+TimestampedSamples::Sample TimestampedSamples::operator [] (std::size_t index) const
+{
+    return Sample(_timestamps[index], _values.data() + index * _channelCount, _channelCount);
+}
+
+
+std::size_t TimestampedSamples::channelCount() const
+{
+    return _channelCount;
+}
+
+
+void TimestampedSamples::setChannelCount(std::size_t channelCount)
+{
+    clear();
+    _channelCount = channelCount;
+}
+
+
+const std::vector<double>& TimestampedSamples::timestamps() const
+{
+    return _timestamps;
+}
+
+
+const std::vector<double>& TimestampedSamples::values() const
+{
+    return _values;
+}
+
+
+void TimestampedSamples::push_back(double timestamp, const double* values)
+{
+    _timestamps.push_back(timestamp);
+    _values.insert(_values.end(), values, values + _channelCount);
+}
+
+
+void TimestampedSamples::append(const TimestampedSamples& samples)
+{
+    if (samples._channelCount != _channelCount)
+    {
+        ofLogError("TimestampedSamples::append") << "Channel count mismatch: " << samples._channelCount << " != " << _channelCount;
+        return;
+    }
+
+    _timestamps.insert(_timestamps.end(), samples._timestamps.begin(), samples._timestamps.end());
+    _values.insert(_values.end(), samples._values.begin(), samples._values.end());
+}
+
+
+bool TimestampedSamples::isSorted() const
+{
+    return std::is_sorted(_timestamps.begin(), _timestamps.end());
+}
+
+
+void TimestampedSamples::sort()
+{
+    if (isSorted())
+    {
+        return;
+    }
+
+    std::vector<std::size_t> order(_timestamps.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        return _timestamps[a] < _timestamps[b];
+    });
+
+    std::vector<double> timestamps(_timestamps.size());
+    std::vector<double> values(_values.size());
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        timestamps[i] = _timestamps[order[i]];
+
+        std::copy(_values.begin() + order[i] * _channelCount,
+                  _values.begin() + (order[i] + 1) * _channelCount,
+                  values.begin() + i * _channelCount);
+    }
+
+    _timestamps.swap(timestamps);
+    _values.swap(values);
+}
+
+
+void TimestampedSamples::reserve(std::size_t size)
+{
+    _timestamps.reserve(size);
+    _values.reserve(size * _channelCount);
+}
+
+
+void TimestampedSamples::clear()
+{
+    _timestamps.clear();
+    _values.clear();
+}
+
+
+} } // namespace ofx::Player
@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/TimestampedURIIndex.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+namespace {
+
+
+void writeVarint(std::vector<char>& data, std::size_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    data.push_back(static_cast<char>(value));
+}
+
+
+std::size_t readVarint(const char*& ptr)
+{
+    std::size_t value = 0;
+    int shift = 0;
+
+    while (true)
+    {
+        uint8_t byte = static_cast<uint8_t>(*ptr++);
+        value |= static_cast<std::size_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+
+        shift += 7;
+    }
+}
+
+
+} // namespace
+
+
+TimestampedURIIndex::TimestampedURIIndex()
+{
+}
+
+
+TimestampedURIIndex::TimestampedURIIndex(const std::vector<TimestampedURI>& images)
+{
+    assign(images);
+}
+
+
+TimestampedURIIndex::~TimestampedURIIndex()
+{
+}
+
+
+std::size_t TimestampedURIIndex::size() const
+{
+    return _timestamps.size();
+}
+
+
+bool TimestampedURIIndex::empty() const
+{
+    return _timestamps.empty();
+}
+
+
+TimestampedURI TimestampedURIIndex::operator [] (std::size_t index) const
+{
+    return TimestampedURI(uri(index), _timestamps[index]);
+}
+
+
+std::string TimestampedURIIndex::uri(std::size_t index) const
+{
+    std::size_t block = index / BLOCK_SIZE;
+
+    const char* ptr = _data.data() + _blockOffsets[block];
+
+    std::size_t length = readVarint(ptr);
+
+    std::string result(ptr, length);
+
+    ptr += length;
+
+    for (std::size_t i = block * BLOCK_SIZE; i < index; ++i)
+    {
+        std::size_t shared = readVarint(ptr);
+        std::size_t suffix = readVarint(ptr);
+        result.resize(shared);
+        result.append(ptr, suffix);
+        ptr += suffix;
+    }
+
+    return result;
+}
+
+
+const std::vector<int64_t>& TimestampedURIIndex::timestamps() const
+{
+    return _timestamps;
+}
+
+
+TimestampedURIIndex::const_iterator TimestampedURIIndex::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+
+TimestampedURIIndex::const_iterator TimestampedURIIndex::end() const
+{
+    return const_iterator(this, size());
+}
+
+
+void TimestampedURIIndex::push_back(const TimestampedURI& image)
+{
+    push_back(image.uri(), image.timestampMicros());
+}
+
+
+void TimestampedURIIndex::push_back(const std::string& uri, int64_t timestamp)
+{
+    if (_timestamps.size() % BLOCK_SIZE == 0)
+    {
+        _blockOffsets.push_back(_data.size());
+        writeVarint(_data, uri.size());
+        _data.insert(_data.end(), uri.begin(), uri.end());
+    }
+    else
+    {
+        std::size_t shared = 0;
+        std::size_t maximum = std::min(uri.size(), _last.size());
+
+        while (shared < maximum && uri[shared] == _last[shared])
+        {
+            ++shared;
+        }
+
+        writeVarint(_data, shared);
+        writeVarint(_data, uri.size() - shared);
+        _data.insert(_data.end(), uri.begin() + shared, uri.end());
+    }
+
+    _last = uri;
+    _timestamps.push_back(timestamp);
+}
+
+
+void TimestampedURIIndex::assign(const std::vector<TimestampedURI>& images)
+{
+    clear();
+    reserve(images.size());
+
+    for (auto& image: images)
+    {
+        push_back(image);
+    }
+}
+
+
+void TimestampedURIIndex::merge(const std::vector<TimestampedURI>& images)
+{
+    TimestampedURIIndex merged;
+    merged.reserve(size() + images.size());
+
+    auto next = images.begin();
+
+    forEach([&](const std::string& uri, int64_t timestamp)
+    {
+        while (next != images.end() && next->timestampMicros() < timestamp)
+        {
+            merged.push_back(*next++);
+        }
+
+        merged.push_back(uri, timestamp);
+    });
+
+    while (next != images.end())
+    {
+        merged.push_back(*next++);
+    }
+
+    *this = std::move(merged);
+}
+
+
+void TimestampedURIIndex::removeIf(const std::function<bool(const std::string&, int64_t)>& predicate)
+{
+    TimestampedURIIndex filtered;
+    filtered.reserve(size());
+
+    forEach([&](const std::string& uri, int64_t timestamp)
+    {
+        if (!predicate(uri, timestamp))
+        {
+            filtered.push_back(uri, timestamp);
+        }
+    });
+
+    filtered.shrink_to_fit();
+
+    *this = std::move(filtered);
+}
+
+
+void TimestampedURIIndex::forEach(const std::function<void(const std::string&, int64_t)>& visitor) const
+{
+    const char* ptr = _data.data();
+
+    std::string uri;
+
+    for (std::size_t i = 0; i < _timestamps.size(); ++i)
+    {
+        if (i % BLOCK_SIZE == 0)
+        {
+            std::size_t length = readVarint(ptr);
+            uri.assign(ptr, length);
+            ptr += length;
+        }
+        else
+        {
+            std::size_t shared = readVarint(ptr);
+            std::size_t suffix = readVarint(ptr);
+            uri.resize(shared);
+            uri.append(ptr, suffix);
+            ptr += suffix;
+        }
+
+        visitor(uri, _timestamps[i]);
+    }
+}
+
+
+void TimestampedURIIndex::reserve(std::size_t size)
+{
+    _timestamps.reserve(size);
+    _blockOffsets.reserve(size / BLOCK_SIZE + 1);
+}
+
+
+void TimestampedURIIndex::shrink_to_fit()
+{
+    _timestamps.shrink_to_fit();
+    _data.shrink_to_fit();
+    _blockOffsets.shrink_to_fit();
+}
+
+
+void TimestampedURIIndex::clear()
+{
+    _timestamps.clear();
+    _data.clear();
+    _blockOffsets.clear();
+    _last.clear();
+}
+
+
+std::size_t TimestampedURIIndex::memoryUsage() const
+{
+    return _timestamps.capacity() * sizeof(int64_t)
+         + _data.capacity()
+         + _blockOffsets.capacity() * sizeof(uint64_t)
+         + _last.capacity();
+}
+
+
+} } // namespace ofx::Player
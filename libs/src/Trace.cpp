@@ -0,0 +1,377 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Player/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ofFileUtils.h"
+#include "ofJson.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Player {
+
+
+namespace {
+
+
+/// \brief A recorded complete event.
+struct TraceEvent
+{
+    /// \brief The event name.
+    const char* name;
+
+    /// \brief The start time in nanoseconds.
+    int64_t start;
+
+    /// \brief The duration in nanoseconds.
+    int64_t duration;
+
+    /// \brief The attached index, or -1 for none.
+    int64_t index;
+
+    /// \brief The object the event belongs to, or nullptr for none.
+    const void* id;
+};
+
+
+/// \brief The events recorded by a single thread.
+struct TraceBuffer
+{
+    TraceBuffer(std::size_t capacity, uint64_t threadId):
+        events(capacity),
+        threadId(threadId)
+    {
+    }
+
+    /// \brief The event storage, written only by the owning thread.
+    std::vector<TraceEvent> events;
+
+    /// \brief The number of complete events, published with release order.
+    std::atomic<std::size_t> size { 0 };
+
+    /// \brief The clear generation the events belong to.
+    std::atomic<uint64_t> generation { 0 };
+
+    /// \brief The number of events dropped because the buffer was full.
+    std::atomic<uint64_t> dropped { 0 };
+
+    /// \brief False once the owning thread has exited.
+    std::atomic<bool> isAlive { true };
+
+    /// \brief The trace thread id.
+    uint64_t threadId = 0;
+
+    /// \brief The thread name, protected by the registry mutex.
+    std::string threadName;
+};
+
+
+/// \brief All thread buffers.
+///
+/// Buffers are shared so events from exited threads can still be saved.
+/// Buffers of exited threads are removed once their events are cleared.
+struct TraceRegistry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    std::atomic<std::size_t> bufferSize { Trace::DEFAULT_BUFFER_SIZE };
+    std::atomic<uint64_t> generation { 0 };
+    uint64_t nextThreadId = 1;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+
+/// \brief The trace state of a single thread.
+struct ThreadTrace
+{
+    /// \brief Mark the buffer as orphaned when the thread exits.
+    ~ThreadTrace()
+    {
+        if (buffer != nullptr)
+        {
+            buffer->isAlive.store(false, std::memory_order_release);
+        }
+    }
+
+    /// \brief The thread name, applied when the buffer is created.
+    std::string name;
+
+    /// \brief The buffer, or nullptr until the thread records an event.
+    std::shared_ptr<TraceBuffer> buffer;
+};
+
+
+TraceRegistry& registry()
+{
+    static TraceRegistry instance;
+    return instance;
+}
+
+
+ThreadTrace& threadTrace()
+{
+    thread_local ThreadTrace trace;
+    return trace;
+}
+
+
+/// \returns the calling thread's buffer, or nullptr if it has none and
+///     tracing is disabled. The buffer is registered on first use.
+TraceBuffer* threadBuffer()
+{
+    ThreadTrace& trace = threadTrace();
+
+    if (trace.buffer == nullptr && Trace::isEnabled())
+    {
+        TraceRegistry& traces = registry();
+        std::unique_lock<std::mutex> lock(traces.mutex);
+        trace.buffer = std::make_shared<TraceBuffer>(traces.bufferSize.load(),
+                                                     traces.nextThreadId++);
+        trace.buffer->generation = traces.generation.load();
+        trace.buffer->threadName = trace.name;
+        traces.buffers.push_back(trace.buffer);
+    }
+
+    return trace.buffer.get();
+}
+
+
+/// \brief Remove the buffers of exited threads.
+/// \param traces The locked registry.
+/// \param keepCurrent True if buffers with events from the current
+///     generation should be kept so they can still be saved.
+void pruneBuffers(TraceRegistry& traces, bool keepCurrent)
+{
+    uint64_t generation = traces.generation.load();
+
+    traces.buffers.erase(std::remove_if(traces.buffers.begin(),
+                                        traces.buffers.end(),
+                                        [&](const std::shared_ptr<TraceBuffer>& buffer)
+                                        {
+                                            return !buffer->isAlive.load(std::memory_order_acquire)
+                                                && !(keepCurrent && buffer->generation.load(std::memory_order_acquire) == generation);
+                                        }),
+                         traces.buffers.end());
+}
+
+
+} // namespace
+
+
+void Trace::setEnabled(bool enabled)
+{
+    Trace::enabled().store(enabled, std::memory_order_relaxed);
+}
+
+
+void Trace::setBufferSize(std::size_t size)
+{
+    registry().bufferSize = std::max(size, std::size_t(1));
+}
+
+
+std::size_t Trace::getBufferSize()
+{
+    return registry().bufferSize;
+}
+
+
+void Trace::setThreadName(const std::string& name)
+{
+    ThreadTrace& trace = threadTrace();
+    trace.name = name;
+
+    // Naming a thread does not create its buffer, so threads that never
+    // record an event cost no event storage.
+    if (trace.buffer != nullptr)
+    {
+        std::unique_lock<std::mutex> lock(registry().mutex);
+        trace.buffer->threadName = name;
+    }
+}
+
+
+void Trace::record(const char* name,
+                   int64_t start,
+                   int64_t duration,
+                   int64_t index,
+                   const void* id)
+{
+    TraceBuffer* buffer = threadBuffer();
+
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    std::size_t size = buffer->size.load(std::memory_order_relaxed);
+
+    // Discard events from before the last clear. Only this thread writes to
+    // the buffer, so the reset can not race with another writer.
+    uint64_t generation = registry().generation.load(std::memory_order_relaxed);
+
+    if (buffer->generation.load(std::memory_order_relaxed) != generation)
+    {
+        size = 0;
+        buffer->size.store(0, std::memory_order_release);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation.store(generation, std::memory_order_release);
+    }
+
+    if (size >= buffer->events.size())
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[size] = { name, start, duration, index, id };
+    buffer->size.store(size + 1, std::memory_order_release);
+}
+
+
+int64_t Trace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+
+void Trace::clear()
+{
+    TraceRegistry& traces = registry();
+    std::unique_lock<std::mutex> lock(traces.mutex);
+    ++traces.generation;
+    pruneBuffers(traces, false);
+}
+
+
+uint64_t Trace::droppedCount()
+{
+    TraceRegistry& traces = registry();
+    std::unique_lock<std::mutex> lock(traces.mutex);
+
+    uint64_t generation = traces.generation.load();
+    uint64_t dropped = 0;
+
+    for (auto& buffer: traces.buffers)
+    {
+        if (buffer->generation.load(std::memory_order_acquire) == generation)
+        {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+
+    return dropped;
+}
+
+
+bool Trace::save(const std::string& filename)
+{
+    std::ofstream stream(ofToDataPath(filename, true), std::ios::out | std::ios::trunc);
+
+    if (!stream)
+    {
+        ofLogError("Trace::save") << "Unable to open " << filename;
+        return false;
+    }
+
+    TraceRegistry& traces = registry();
+    std::unique_lock<std::mutex> lock(traces.mutex);
+
+    pruneBuffers(traces, true);
+
+    uint64_t generation = traces.generation.load();
+
+    // Events are written directly rather than building a json document, since
+    // a capture may contain millions of events.
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool isFirst = true;
+
+    auto separate = [&]()
+    {
+        if (!isFirst)
+        {
+            stream << ",\n";
+        }
+
+        isFirst = false;
+    };
+
+    for (auto& buffer: traces.buffers)
+    {
+        std::string threadName = buffer->threadName;
+
+        if (threadName.empty())
+        {
+            threadName = "Thread " + std::to_string(buffer->threadId);
+        }
+
+        separate();
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId;
+        stream << ",\"args\":{\"name\":" << ofJson(threadName).dump() << "}}";
+
+        if (buffer->generation.load(std::memory_order_acquire) != generation)
+        {
+            continue;
+        }
+
+        std::size_t size = buffer->size.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const TraceEvent& event = buffer->events[i];
+
+            separate();
+            stream << "{\"name\":\"" << event.name << "\",\"cat\":\"ofxPlayer\",\"ph\":\"X\"";
+            stream << ",\"ts\":" << event.start / 1000.0;
+            stream << ",\"dur\":" << event.duration / 1000.0;
+            stream << ",\"pid\":1,\"tid\":" << buffer->threadId;
+
+            if (event.index >= 0 || event.id != nullptr)
+            {
+                stream << ",\"args\":{";
+
+                if (event.id != nullptr)
+                {
+                    // Chrome trace ids are conventionally hex strings.
+                    stream << "\"id\":\"0x" << std::hex << reinterpret_cast<uintptr_t>(event.id) << std::dec << "\"";
+                }
+
+                if (event.index >= 0)
+                {
+                    stream << (event.id != nullptr ? "," : "") << "\"index\":" << event.index;
+                }
+
+                stream << "}";
+            }
+
+            stream << "}";
+        }
+    }
+
+    stream << "]}\n";
+
+    return static_cast<bool>(stream);
+}
+
+
+std::atomic<bool>& Trace::enabled()
+{
+    static std::atomic<bool> instance { false };
+    return instance;
+}
+
+
+} } // namespace ofx::Player
@@ -11,11 +11,33 @@
 #include "ofxIO.h"
 #include "ofxCache.h"
 #include "ofx/Player/AbstractPlayerTypes.h"
+#include "ofx/Player/AsyncFileReader.h"
 #include "ofx/Player/BasePlayerTypes.h"
+#include "ofx/Player/ChunkedURIManifest.h"
+#include "ofx/Player/CueIndex.h"
+#include "ofx/Player/DirectoryWatcher.h"
 #include "ofx/Player/IndexedFile.h"
 #include "ofx/Player/ImageSequence.h"
 #include "ofx/Player/ImageSequencePlayer.h"
+#include "ofx/Player/ImageSequenceRecorder.h"
+#include "ofx/Player/ImageSequenceView.h"
+#include "ofx/Player/ImageSequenceViewPlayer.h"
+#include "ofx/Player/Interpolation.h"
+#include "ofx/Player/MappedFile.h"
+#include "ofx/Player/MergedTimeIndexed.h"
+#include "ofx/Player/OverviewPyramid.h"
 #include "ofx/Player/PlayerUtils.h"
+#include "ofx/Player/PlayerStats.h"
+#include "ofx/Player/RingBuffer.h"
+#include "ofx/Player/SampleLog.h"
+#include "ofx/Player/SequenceGenerator.h"
+#include "ofx/Player/StaticPlayerTypes.h"
+#include "ofx/Player/StridedRecords.h"
+#include "ofx/Player/TextSampleLoader.h"
+#include "ofx/Player/TimeRemapCurve.h"
+#include "ofx/Player/TimestampedSamples.h"
+#include "ofx/Player/TimestampedURIIndex.h"
+#include "ofx/Player/Trace.h"
 
 
 namespace ofxPlayer = ofx::Player;